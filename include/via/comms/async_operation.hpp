@@ -0,0 +1,89 @@
+#ifndef ASYNC_OPERATION_HPP_VIA_HTTPLIB_
+#define ASYNC_OPERATION_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file async_operation.hpp
+/// @brief A class to hold the completion handler of an asio style
+/// asynchronous operation until it completes.
+//////////////////////////////////////////////////////////////////////////////
+#include "socket_adaptor.hpp"
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace via
+{
+  namespace comms
+  {
+    /// @class async_operation
+    /// A pending asynchronous operation: the completion handler from an
+    /// ASIO::async_initiate call, held until the operation completes.
+    /// So the operation may be used with any asio completion token, e.g. a
+    /// callback, ASIO::use_future or ASIO::use_awaitable in a C++20 coroutine.
+    ///
+    /// The handler is called with the arguments by posting it to its
+    /// associated executor, or the executor given when it was started.
+    /// Note: it's not thread safe, it must be started and completed on the
+    /// thread(s) of the connection.
+    /// @tparam Args the arguments of the completion handler, the first one
+    /// should be an ASIO_ERROR_CODE.
+    template <typename... Args>
+    class async_operation
+    {
+      /// Posts the completion handler with the arguments.
+      std::function<void (Args...)> complete_{};
+
+    public:
+
+      /// Whether the operation has been started and not completed.
+      bool is_pending() const noexcept
+      { return static_cast<bool>(complete_); }
+
+      /// Start the operation.
+      /// @pre the operation is not pending.
+      /// @param handler the completion handler from ASIO::async_initiate.
+      /// @param executor the executor to call the handler on, if the
+      /// handler doesn't have an associated executor.
+      template <typename Handler, typename Executor>
+      void start(Handler&& handler, Executor const& executor)
+      {
+        // The handler may be move only, e.g. for ASIO::use_awaitable.
+        auto pointer(std::make_shared<std::decay_t<Handler>>
+                                     (std::forward<Handler>(handler)));
+        auto handler_executor(ASIO::get_associated_executor(*pointer, executor));
+        complete_ = [pointer, handler_executor](Args... args)
+        {
+          ASIO::post(handler_executor,
+                     [pointer, values(std::make_tuple(std::move(args)...))]()
+                       mutable { std::apply(*pointer, std::move(values)); });
+        };
+      }
+
+      /// Complete the operation, if it's pending.
+      /// @param args the arguments for the completion handler.
+      /// @return true if the operation was pending, false otherwise.
+      bool complete(Args... args)
+      {
+        if (!complete_)
+          return false;
+
+        auto complete(std::move(complete_));
+        complete_ = nullptr;
+        complete(std::move(args)...);
+        return true;
+      }
+    };
+  }
+}
+
+#endif
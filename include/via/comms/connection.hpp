@@ -72,6 +72,8 @@ namespace via
     private:
 
       std::shared_ptr<std::vector<char>> rx_buffer_; ///< The receive buffer.
+      ASIO::mutable_buffer read_buffer_{};           ///< A buffer for the next read.
+      std::shared_ptr<void> read_buffer_owner_{};    ///< The owner of read_buffer_.
       ConstBuffers tx_buffers_{};                    ///< The transmit buffers.
       receive_callback_type receive_callback_{ nullptr }; ///< The receive callback function.
       event_callback_type event_callback_{ nullptr }; ///< The event callback function.
@@ -81,6 +83,8 @@ namespace via
       int receive_buffer_size_{ 0 };     ///< The socket receive buffer size.
       int send_buffer_size_{ 0 };        ///< The socket send buffer size.
       bool transmitting_{ false };       ///< Whether a write's in progress
+      bool receiving_{ false };          ///< Whether a read's in progress
+      bool reception_paused_{ false };   ///< Whether reception is paused
       bool no_delay_{ false };           ///< The tcp no delay status.
       bool keep_alive_{ false };         ///< The tcp keep alive status.
       bool connected_{ false };          ///< If the socket is connected.
@@ -96,8 +100,10 @@ namespace via
       /// @fn write_data
       /// Write data via the socket adaptor.
       /// @param buffers the buffer(s) containing the message.
+      /// @param owner the owner of the memory of the buffers, if any. It is
+      /// held until the write has completed.
       /// @return true if connected, false otherwise.
-      bool write_data(ConstBuffers&& buffers)
+      bool write_data(ConstBuffers&& buffers, std::shared_ptr<const void> owner)
       {
         tx_buffers_ = std::move(buffers);
 
@@ -107,8 +113,8 @@ namespace via
           weak_pointer weak_ptr(weak_from_this());
           std::shared_ptr<std::vector<char>> rx_buffer(rx_buffer_);
           SocketAdaptor::write(tx_buffers_,
-            [weak_ptr, rx_buffer](ASIO_ERROR_CODE const& error,
-                                  size_t bytes_transferred)
+            [weak_ptr, rx_buffer, owner](ASIO_ERROR_CODE const& error,
+                                         size_t bytes_transferred)
           { write_callback(weak_ptr, error, bytes_transferred, rx_buffer); });
         }
 
@@ -121,11 +127,29 @@ namespace via
       {
         // local copies for lambdas
         weak_pointer weak_ptr(weak_from_this());
-        std::shared_ptr<std::vector<char>> rx_buffer(rx_buffer_);
-        SocketAdaptor::read(ASIO::mutable_buffer(rx_buffer_->data(), rx_buffer_->size()),
-          [weak_ptr, rx_buffer](ASIO_ERROR_CODE const& error,
-                                size_t bytes_transferred)
-         { read_callback(weak_ptr, error, bytes_transferred, rx_buffer); });
+        receiving_ = true;
+
+        // read directly into the buffer set by read_into, once
+        if (read_buffer_.size() > 0u)
+        {
+          ASIO::mutable_buffer buffer(read_buffer_);
+          std::shared_ptr<void> owner(std::move(read_buffer_owner_));
+          read_buffer_ = ASIO::mutable_buffer();
+          const char* data(static_cast<const char*>(buffer.data()));
+          SocketAdaptor::read(buffer,
+            [weak_ptr, data, owner](ASIO_ERROR_CODE const& error,
+                                    size_t bytes_transferred)
+           { read_callback(weak_ptr, error, bytes_transferred, data, owner); });
+        }
+        else
+        {
+          std::shared_ptr<std::vector<char>> rx_buffer(rx_buffer_);
+          const char* data(rx_buffer_->data());
+          SocketAdaptor::read(ASIO::mutable_buffer(rx_buffer_->data(), rx_buffer_->size()),
+            [weak_ptr, data, rx_buffer](ASIO_ERROR_CODE const& error,
+                                        size_t bytes_transferred)
+           { read_callback(weak_ptr, error, bytes_transferred, data, rx_buffer); });
+        }
       }
 
       /// This function determines whether the error is a socket disconnect.
@@ -179,25 +203,30 @@ namespace via
       /// It ensures that the connection still exists and the event is valid.
       /// If there was an error it calls the connection's signal_error_or_disconnect
       /// function, otherwise it calls the connection's read_handler.
+      /// Note: a cancelled read leaves receiving_ to close, which has reset
+      /// it, so that it can't clear the flag of a read on a new connection.
       /// @param ptr a weak pointer to the connection
       /// @param error the boost asio error (if any).
       /// @param bytes_transferred the size of the received data packet.
-      /// @param rx_buffer a shared pointer to the receive buffer to control
+      /// @param data a pointer to the buffer that the data was read into.
+      /// @param buffer a shared pointer to the owner of the buffer to control
       /// object lifetime.
       static void read_callback(weak_pointer ptr,
                                 ASIO_ERROR_CODE const& error,
                                 size_t bytes_transferred,
-                                std::shared_ptr<std::vector<char>> rx_buffer)
+                                const char* data,
+                                std::shared_ptr<void>) // buffer)
       {
         shared_pointer pointer(ptr.lock());
         if (pointer && (ASIO::error::operation_aborted != error))
         {
+          pointer->receiving_ = false;
           if (error)
             pointer->signal_error_or_disconnect(error);
           else
           {
-            pointer->receive_callback_(rx_buffer->data(), bytes_transferred, ptr);
-            if (!pointer->shutdown_sent_)
+            pointer->receive_callback_(data, bytes_transferred, ptr);
+            if (!pointer->shutdown_sent_ && !pointer->reception_paused_)
               pointer->enable_reception();
           }
         }
@@ -514,17 +543,72 @@ namespace via
       /// @fn close
       /// Close the underlying socket adaptor.
       /// Cancels all of the socket's callback functions.
+      /// Note: it resets the connection state, since the callbacks of
+      /// cancelled operations are ignored, so that the connection can read
+      /// and write again if it's reconnected.
       void close()
-      { SocketAdaptor::close(); }
+      {
+        SocketAdaptor::close();
+
+        connected_ = false;
+        receiving_ = false;
+        reception_paused_ = false;
+        read_buffer_ = ASIO::mutable_buffer();
+        read_buffer_owner_.reset();
+        transmitting_ = false;
+        disconnect_pending_ = false;
+        shutdown_sent_ = false;
+      }
 
       /// @fn enable_reception
       /// This function prepares the receive buffer and calls the
       /// socket adaptor read function to listen for the next data packet.
+      /// Note: it does nothing if a read is already in progress.
       void enable_reception()
       {
-        read_data();
+        if (!receiving_)
+          read_data();
+      }
+
+      /// @fn read_into
+      /// Read the next data packet directly into the given buffer instead of
+      /// the receive buffer, e.g. the rest of a large message body.
+      /// Note: if a read is already in progress, it applies to the following
+      /// read.
+      /// @param buffer the buffer to read the next data packet into.
+      /// @param owner a shared pointer to the owner of the buffer, to keep
+      /// the buffer alive until the read has completed.
+      void read_into(ASIO::mutable_buffer buffer, std::shared_ptr<void> owner)
+      {
+        read_buffer_ = buffer;
+        read_buffer_owner_ = std::move(owner);
       }
 
+      /// @fn pause_reception
+      /// Stop reading data packets after the current data packet.
+      /// Note: the data in the current receive buffer is still processed.
+      void pause_reception() noexcept
+      { reception_paused_ = true; }
+
+      /// @fn resume_reception
+      /// Resume reading data packets after pause_reception.
+      void resume_reception()
+      {
+        reception_paused_ = false;
+        if (connected_ && !shutdown_sent_)
+          enable_reception();
+      }
+
+      /// @fn reception_paused
+      /// Accessor for the reception_paused_ flag.
+      bool reception_paused() const noexcept
+      { return reception_paused_; }
+
+      /// @fn transmitting
+      /// Accessor for the transmitting_ flag.
+      bool transmitting() const noexcept
+      { return transmitting_; }
+
       /// @fn connected
       /// Accessor for the connected_ flag.
       bool connected() const noexcept
@@ -536,12 +620,16 @@ namespace via
 
       /// Send the data in the buffers.
       /// @param buffers the data to write.
+      /// @param owner the owner of the memory of the buffers, default none.
+      /// If given, it is held until the write has completed, so the memory
+      /// may be shared between connections without copying it.
       /// @return true if the buffers are being sent, false otherwise.
-      bool send_data(ConstBuffers&& buffers)
+      bool send_data(ConstBuffers&& buffers,
+                     std::shared_ptr<const void> owner = nullptr)
       {
         if (!transmitting_)
         {
-          transmitting_ = write_data(std::move(buffers));
+          transmitting_ = write_data(std::move(buffers), std::move(owner));
           return transmitting_;
         }
         else
@@ -38,10 +38,24 @@ namespace via
 
       protected:
 
-        /// Pure virtual function to authenticate a request
-        /// @param header_fields the request message header fields.
+        /// Virtual function to authenticate a request.
+        /// By default it calls the StringMap overload with a copy of the
+        /// fields, so that derived classes written for it still work.
+        /// @param fields the request message header fields.
         /// @return true if valid, false otherwise.
-        virtual bool is_valid(StringMap const& header_fields) const = 0;
+        virtual bool is_valid(header_fields const& fields) const
+        { return is_valid(fields.to_map()); }
+
+        /// Virtual function to authenticate a request from a StringMap of the
+        /// header fields. Deprecated: override the header_fields overload
+        /// instead, it doesn't copy the fields.
+        /// @param header_fields the request message header fields.
+        /// @return false, derived classes must override one of the overloads.
+        virtual bool is_valid(StringMap const& header_fields) const
+        {
+          (void)header_fields;
+          return false;
+        }
 
         /// The value to be sent in the authenticate response header.
         /// @return the authenticate string.
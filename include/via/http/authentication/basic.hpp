@@ -39,17 +39,19 @@ namespace via
 
       protected:
 
+        using authentication::is_valid;
+
         /// Function to authenticate a request.
-        /// @param header_fields the request message header fields.
+        /// @param fields the request message header fields.
         /// @return true if valid, false otherwise.
-        virtual bool is_valid(StringMap const& header_fields) const override
+        virtual bool is_valid(header_fields const& fields) const override
         {
           // Does the request contain an AUTHORIZATION header?
-          const auto h_iter(header_fields.find(header_field::LC_AUTHORIZATION));
-          if (h_iter == header_fields.end())
+          const auto value(fields.find(header_field::id::AUTHORIZATION));
+          if (value.empty())
             return false;
 
-          std::string authorization(h_iter->second);
+          std::string authorization(value);
 
           // Is it Basic?
           auto basic_pos(authorization.find(BASIC));
@@ -0,0 +1,229 @@
+#ifndef BODY_FILE_HPP_VIA_HTTPLIB_
+#define BODY_FILE_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file body_file.hpp
+/// @brief Contains the body_file class: an anonymous temporary file to hold
+/// a large message body.
+//////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <cerrno>
+#include <cstdio>
+
+#if defined _WIN32 || defined WIN32 || defined _WIN64 || defined WIN64 \
+  || defined  WINNT || defined OS_WIN64
+#define VIA_BODY_FILE_WINDOWS
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace via
+{
+  namespace http
+  {
+    //////////////////////////////////////////////////////////////////////////
+    /// @class body_file
+    /// An anonymous temporary file to hold a message body that is too large
+    /// to hold in memory.
+    /// On Linux the file is created with O_TMPFILE, otherwise it is unlinked
+    /// as soon as it has been created, so it never appears in the directory
+    /// and it is deleted when it is closed.
+    /// The body can be read from the file descriptor or mapped into memory.
+    /// Note: on Windows the file is created by std::tmpfile and it cannot be
+    /// mapped into memory.
+    //////////////////////////////////////////////////////////////////////////
+    class body_file
+    {
+      int    fd_ { -1 };             ///< the file descriptor
+      size_t size_ { 0u };           ///< the size of the body in the file
+      mutable void*  map_ { nullptr }; ///< the memory map of the file
+      mutable size_t map_size_ { 0u }; ///< the size of the memory map
+#ifdef VIA_BODY_FILE_WINDOWS
+      FILE*  file_ { nullptr };      ///< the temporary file
+#endif
+
+      /// Unmap the file from memory.
+      void unmap() const noexcept
+      {
+#ifndef VIA_BODY_FILE_WINDOWS
+        if (map_)
+          ::munmap(map_, map_size_);
+#endif
+        map_ = nullptr;
+        map_size_ = 0u;
+      }
+
+    public:
+
+      /// Default constructor, the file is not open.
+      body_file() = default;
+
+      /// The destructor closes the file, which deletes it.
+      ~body_file()
+      { close(); }
+
+      body_file(body_file const&) = delete;
+      body_file& operator=(body_file const&) = delete;
+
+      /// Move constructor.
+      body_file(body_file&& other) noexcept
+      { swap(other); }
+
+      /// Move assignment operator.
+      body_file& operator=(body_file&& other) noexcept
+      {
+        body_file tmp(std::move(other));
+        swap(tmp);
+        return *this;
+      }
+
+      /// Swap member variables with another body_file.
+      /// @param other the other body_file
+      void swap(body_file& other) noexcept
+      {
+        std::swap(fd_, other.fd_);
+        std::swap(size_, other.size_);
+        std::swap(map_, other.map_);
+        std::swap(map_size_, other.map_size_);
+#ifdef VIA_BODY_FILE_WINDOWS
+        std::swap(file_, other.file_);
+#endif
+      }
+
+      /// Create an anonymous temporary file.
+      /// @pre the file is not open.
+      /// @param directory the directory in which to create the file,
+      /// default (empty) the system's temporary directory.
+      /// @return true if the file was created, false otherwise.
+      bool open(std::string const& directory = std::string())
+      {
+#ifdef VIA_BODY_FILE_WINDOWS
+        (void)directory;
+        file_ = std::tmpfile();
+        if (file_)
+          fd_ = ::_fileno(file_);
+#else
+        std::error_code error;
+        std::string path(directory.empty() ?
+            std::filesystem::temp_directory_path(error).string() : directory);
+        if (path.empty())
+          path = "/tmp";
+
+#ifdef O_TMPFILE
+        fd_ = ::open(path.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC,
+                     S_IRUSR | S_IWUSR);
+#endif
+        // not supported by the OS or the file system
+        if (fd_ < 0)
+        {
+          path += "/via-httplib-XXXXXX";
+          fd_ = ::mkstemp(path.data());
+          if (fd_ >= 0)
+            ::unlink(path.c_str());
+        }
+#endif
+        size_ = 0u;
+        return fd_ >= 0;
+      }
+
+      /// Close the file, which deletes it.
+      void close() noexcept
+      {
+        unmap();
+#ifdef VIA_BODY_FILE_WINDOWS
+        if (file_)
+          std::fclose(file_);
+        file_ = nullptr;
+#else
+        if (fd_ >= 0)
+          ::close(fd_);
+#endif
+        fd_ = -1;
+        size_ = 0u;
+      }
+
+      /// Append data to the end of the file.
+      /// @param data a pointer to the data.
+      /// @param size the size of the data.
+      /// @return true if all of the data was written, false otherwise.
+      bool write(const char* data, size_t size)
+      {
+        while (size > 0u)
+        {
+#ifdef VIA_BODY_FILE_WINDOWS
+          auto written(::_write(fd_, data, static_cast<unsigned>(size)));
+#else
+          auto written(::write(fd_, data, size));
+#endif
+          if (written < 0)
+          {
+            if (errno == EINTR)
+              continue;
+            return false;
+          }
+
+          data  += written;
+          size  -= static_cast<size_t>(written);
+          size_ += static_cast<size_t>(written);
+        }
+        return true;
+      }
+
+      /// Map the body into memory, read only.
+      /// Note: the map is only valid until more data is written to the file,
+      /// or it is closed.
+      /// @return a view of the body, empty if it could not be mapped.
+      std::string_view map() const
+      {
+#ifndef VIA_BODY_FILE_WINDOWS
+        if (map_size_ != size_)
+        {
+          unmap();
+          if (size_ > 0u)
+          {
+            void* map(::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0));
+            if (map != MAP_FAILED)
+            {
+              map_ = map;
+              map_size_ = size_;
+            }
+          }
+        }
+#endif
+        return map_ ? std::string_view(static_cast<const char*>(map_), map_size_)
+                    : std::string_view();
+      }
+
+      /// Whether the file is open.
+      bool is_open() const noexcept
+      { return fd_ >= 0; }
+
+      /// Accessor for the file descriptor.
+      /// Note: the application must not close it.
+      /// @return the file descriptor, -1 if the file is not open.
+      int fd() const noexcept
+      { return fd_; }
+
+      /// Accessor for the size of the body in the file.
+      size_t size() const noexcept
+      { return size_; }
+    };
+  }
+}
+
+#endif
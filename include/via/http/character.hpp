@@ -22,6 +22,9 @@
 #include <sstream>
 #include <cstdlib>
 #include <cerrno>
+#include <iterator>
+#include <type_traits>
+#include <charconv>
 
 namespace via
 {
@@ -30,6 +33,35 @@ namespace via
     /// The standard HTTP line terminator.
     constexpr char CRLF[]{"\r\n"};
 
+    /// The end of an HTTP message head, i.e. a line terminator followed by
+    /// an empty line.
+    constexpr char CRLFCRLF[]{"\r\n\r\n"};
+
+    /// Test whether an iterator refers to a contiguous array of bytes,
+    /// i.e. whether the data between two iterators can be viewed as a
+    /// std::string_view.
+    /// @tparam ForwardIterator the type of iterator.
+    /// @return true if the iterator is a pointer or an iterator of a
+    /// std::vector or std::string of bytes, false otherwise.
+    template<typename ForwardIterator>
+    constexpr bool is_contiguous_char_iterator() noexcept
+    {
+      using value_type = std::remove_cv_t<
+        typename std::iterator_traits<ForwardIterator>::value_type>;
+
+      if constexpr ((sizeof(value_type) != 1u) ||
+                    std::is_same_v<value_type, bool>)
+        return false;
+      else
+        return std::is_pointer_v<ForwardIterator> ||
+          std::is_same_v<ForwardIterator,
+                         typename std::vector<value_type>::iterator> ||
+          std::is_same_v<ForwardIterator,
+                         typename std::vector<value_type>::const_iterator> ||
+          std::is_same_v<ForwardIterator, std::string::iterator> ||
+          std::is_same_v<ForwardIterator, std::string::const_iterator>;
+    }
+
     /// Test whether a character is an end of line character,
     /// i.e. CR or LF.
     /// @param c the character
@@ -142,6 +174,30 @@ namespace via
       return output;
     }
 
+    /// Append the http version string, i.e. HTTP/1.1, to the output.
+    /// @param output the string to append to.
+    /// @param major_version the http major version number.
+    /// @param minor_version the http minor version number.
+    inline void append_http_version(std::string& output,
+                                    char major_version, char minor_version)
+    {
+      output.append("HTTP/", 5);
+      output.push_back(major_version);
+      output.push_back('.');
+      output.push_back(minor_version);
+    }
+
+    /// Append an unsigned number to the output, without a temporary string.
+    /// @param output the string to append to.
+    /// @param number the number to append.
+    /// @param base the number base: 10 for decimal, 16 for hexadecimal.
+    inline void append_number(std::string& output, size_t number, int base = 10)
+    {
+      char buffer[24];
+      auto result(std::to_chars(buffer, buffer + sizeof(buffer), number, base));
+      output.append(buffer, result.ptr);
+    }
+
     /// Convert a string representing a hexadecimal number to an unsigned int.
     /// @param hex_string the string containing a valid hexadecimal number
     /// @return the number represented by the string, -1 if invalid.
@@ -172,9 +228,9 @@ namespace via
     /// @return the string containing the number in hexadecimal.
     inline std::string to_hex_string(size_t number)
     {
-      std::stringstream number_stream;
-      number_stream << std::hex << number;
-      return number_stream.str();
+      std::string output;
+      append_number(output, number, 16);
+      return output;
     }
 
     /// Convert a string representing a decimal number to an unsigned int.
@@ -202,6 +258,36 @@ namespace via
         return -1;
     }
 
+    /// Test whether a string contains some lowercase text, ignoring the
+    /// case of the string. I.e. a case insensitive search without copying
+    /// the string.
+    /// @param input the input string.
+    /// @param lc_text the text to find, in lowercase.
+    /// @return true if the input contains the text, false otherwise.
+    inline bool contains_lowercase(std::string_view input,
+                                   std::string_view lc_text) noexcept
+    {
+      return std::search(input.cbegin(), input.cend(),
+                         lc_text.cbegin(), lc_text.cend(),
+                         [](char lhs, char rhs)
+      { return std::tolower(static_cast<unsigned char>(lhs)) == rhs; })
+          != input.cend();
+    }
+
+    /// Test whether a string is equal to some lowercase text, ignoring the
+    /// case of the string.
+    /// @param input the input string.
+    /// @param lc_text the text to compare, in lowercase.
+    /// @return true if the input is equal to the text, false otherwise.
+    inline bool equal_lowercase(std::string_view input,
+                                std::string_view lc_text) noexcept
+    {
+      return std::equal(input.cbegin(), input.cend(),
+                        lc_text.cbegin(), lc_text.cend(),
+                        [](char lhs, char rhs)
+      { return std::tolower(static_cast<unsigned char>(lhs)) == rhs; });
+    }
+
     /// Get the string values between the delimiters.
     /// @param input the input string.
     /// @param delimiter the delimiter.
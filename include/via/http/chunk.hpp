@@ -298,15 +298,22 @@ namespace via
       void set_extension(std::string_view extension)
       { extension_ = extension; }
 
+      /// Append the chunk line to the output.
+      /// @param output the string to append to.
+      void serialize(std::string& output) const
+      {
+        output.append(hex_size_);
+        if (!extension_.empty())
+          output.append("; ", 2u).append(extension_);
+        output.append(CRLF);
+      }
+
       /// Output as a string.
       /// @return a string containing the chunk line.
       std::string to_string() const
       {
-        std::string output(hex_size_);
-        if (!extension_.empty())
-          output += "; " + extension_;
-
-        output += CRLF;
+        std::string output;
+        serialize(output);
         return output;
       }
     }; // class chunk_header
@@ -345,7 +352,10 @@ namespace via
                                        STRICT_CRLF>;
 
       Container data_ {};           ///< the data contained in the chunk
+      std::string_view data_view_ {}; ///< a view of the data in the chunk
       MessageHeaders trailers_ {}; ///< the HTTP field headers for the last chunk
+      size_t data_size_ { 0u };     ///< the size of the data parsed as fragments
+      bool data_cr_ { false };      ///< the CR after the data has been parsed
       bool valid_ { false };        ///< true if the chunk is valid
 
     public:
@@ -366,7 +376,10 @@ namespace via
       {
         ChunkHeader::clear();
         data_.clear();
+        data_view_ = std::string_view();
         trailers_.clear();
+        data_size_ = 0u;
+        data_cr_ = false;
         valid_ =  false;
       }
 
@@ -376,7 +389,10 @@ namespace via
       {
         ChunkHeader::swap(other);
         data_.swap(other.data_);
+        std::swap(data_view_, other.data_view_);
         trailers_.swap(other.trailers_);
+        std::swap(data_size_, other.data_size_);
+        std::swap(data_cr_, other.data_cr_);
         std::swap(valid_, other.valid_);
       }
 
@@ -440,6 +456,117 @@ namespace via
           }
         }
 
+        if constexpr (is_contiguous_char_iterator<typename Container::iterator>())
+          data_view_ = std::string_view(reinterpret_cast<const char*>(data_.data()),
+                                        data_.size());
+        valid_ = true;
+        return valid_;
+      }
+
+      /// Parse an HTTP chunk, only copying its data if necessary.
+      /// If the chunk data is all in the received buffer, data_view() refers
+      /// to it in the buffer and it is not copied into data(). Otherwise, the
+      /// data is copied into data() and data_view() refers to data().
+      /// Note: data_view() is only valid until the buffer is reused.
+      /// @retval iter reference to an iterator to the start of the data.
+      /// If the chunk is valid it will refer to:
+      ///   - the start of the next data chunk,
+      ///   - the start of the next http message, or
+      ///   - the end of the data buffer.
+      /// @param end the end of the data buffer.
+      /// @return true if parsed ok false otherwise.
+      template<typename ForwardIterator>
+      bool parse_view(ForwardIterator& iter, ForwardIterator end)
+      {
+        static_assert(is_contiguous_char_iterator<typename Container::iterator>(),
+                      "chunk views require a contiguous Container");
+
+        std::string_view fragment;
+        bool parsed(parse(iter, end, fragment));
+
+        // the whole of the data is in the received buffer
+        if (parsed && (fragment.size() == data_size_))
+          data_view_ = fragment;
+        else
+        {
+          if (!fragment.empty())
+            data_.insert(data_.end(), fragment.begin(), fragment.end());
+          data_view_ = std::string_view(reinterpret_cast<const char*>(data_.data()),
+                                        data_.size());
+        }
+
+        return parsed;
+      }
+
+      /// Parse an HTTP chunk without copying its data.
+      /// The chunk data in the received buffer is returned as a fragment
+      /// of the buffer, so the data of a chunk may be returned in several
+      /// fragments. Note: the data() of the chunk is not used.
+      /// @retval iter reference to an iterator to the start of the data.
+      /// If the chunk is valid it will refer to:
+      ///   - the start of the next data chunk,
+      ///   - the start of the next http message, or
+      ///   - the end of the data buffer.
+      /// @param end the end of the data buffer.
+      /// @retval fragment the chunk data in the buffer, may be empty.
+      /// @return true if parsed ok false otherwise.
+      template<typename ForwardIterator>
+      bool parse(ForwardIterator& iter, ForwardIterator end,
+                 std::string_view& fragment)
+      {
+        static_assert(is_contiguous_char_iterator<ForwardIterator>(),
+                      "chunk fragments require a contiguous buffer");
+
+        fragment = std::string_view();
+        if (!ChunkHeader::valid() && !ChunkHeader::parse(iter, end))
+          return false;
+
+        // Only the last chunk has a trailer.
+        if (ChunkHeader::is_last())
+        {
+          if (!trailers_.parse(iter, end))
+            return false;
+        }
+        else
+        {
+          // get the data in the received buffer
+          size_t rx_size(static_cast<size_t>(std::distance(iter, end)));
+          size_t fragment_size(std::min(ChunkHeader::size() - data_size_, rx_size));
+          if (fragment_size > 0u)
+          {
+            fragment = std::string_view(reinterpret_cast<const char*>(&*iter),
+                                        fragment_size);
+            iter += fragment_size;
+            data_size_ += fragment_size;
+          }
+
+          // and the CRLF after it
+          if ((data_size_ < ChunkHeader::size()) || (iter == end))
+            return false;
+
+          if (!data_cr_)
+          {
+            // Chunk should end in CRLF
+            if ('\r' == *iter)
+            {
+              data_cr_ = true;
+              if (++iter == end)
+                return false;
+            }
+            else
+            { // enforce if strict
+              if (STRICT_CRLF)
+                return false;
+            }
+          }
+
+          // But it must end with an LF
+          if ('\n' != *iter)
+            return false;
+          else // ('\n' == *iter)
+            ++iter;
+        }
+
         valid_ = true;
         return valid_;
       }
@@ -450,10 +577,17 @@ namespace via
       { return trailers_; }
 
       /// Accessor for the chunk message data.
+      /// Note: it is empty if the chunk was parsed by parse_view and its data
+      /// was all in one received buffer, see data_view().
       /// @return a constant reference to the data
       const Container& data() const noexcept
       { return data_; }
 
+      /// Accessor for a view of the chunk message data.
+      /// @return a view of the data, in the received buffer or data().
+      std::string_view data_view() const noexcept
+      { return data_view_; }
+
       /// Accessor for the valid flag.
       /// @return the valid flag.
       bool valid() const noexcept
@@ -482,23 +616,32 @@ namespace via
 
       /// Add a free form trailer to the chunk.
       void add_trailer(std::string_view field, std::string_view value)
-      { trailer_string_ += header_field::to_header(field, value);  }
+      { header_field::append_header(trailer_string_, field, value); }
 
       /// Add a standard trailer to the chunk.
       void add_trailer(header_field::id field_id, std::string_view value)
-      { trailer_string_ += header_field::to_header(field_id, value);  }
+      {
+        header_field::append_header(trailer_string_,
+                                    header_field::standard_name(field_id), value);
+      }
 
-      /// The http chunk header string.
-      std::string to_string() const
+      /// Append the http chunk header to the output.
+      /// @param output the string to append to.
+      void serialize(std::string& output) const
       {
-        std::string output("0");
+        output.push_back('0');
         if (!extension_.empty())
-          output += "; " + extension_;
-
-        output += CRLF;
-        output += trailer_string_;
+          output.append("; ", 2u).append(extension_);
+        output.append(CRLF);
+        output.append(trailer_string_);
+        output.append(CRLF);
+      }
 
-        output += CRLF;
+      /// The http chunk header string.
+      std::string to_string() const
+      {
+        std::string output;
+        serialize(output);
         return output;
       }
     };
@@ -0,0 +1,392 @@
+#ifndef COMPRESSION_HPP_VIA_HTTPLIB_
+#define COMPRESSION_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file compression.hpp
+/// @brief Content codings: Accept-Encoding negotiation and the compressor
+/// class.
+/// Note: gzip and deflate require zlib and the macro HTTP_ZLIB,
+/// zstd requires libzstd and the macro HTTP_ZSTD.
+//////////////////////////////////////////////////////////////////////////////
+#include "character.hpp"
+#include <string_view>
+#include <climits>
+#include <cstddef>
+
+#ifdef HTTP_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HTTP_ZSTD
+#include <zstd.h>
+#endif
+
+namespace via
+{
+  namespace http
+  {
+    namespace content_coding
+    {
+      /// The content codings, in order of preference.
+      enum class id
+      {
+        IDENTITY, ///< no compression
+        ZSTD,     ///< zstd, RFC8878
+        GZIP,     ///< gzip, RFC1952
+        DEFLATE,  ///< zlib deflate, RFC1950
+        NUMBER_OF_IDS
+      };
+
+      /// The number of content coding ids.
+      constexpr size_t NUMBER_OF_IDS
+        { static_cast<size_t>(id::NUMBER_OF_IDS) };
+
+      /// The default compression level: a compromise between speed and size.
+      constexpr int DEFAULT_LEVEL { 6 };
+
+      /// The default minimum size of a response body to compress.
+      constexpr size_t DEFAULT_THRESHOLD { 1024u };
+
+      /// The name of a content coding, as used in the Content-Encoding and
+      /// Accept-Encoding headers.
+      /// @param coding the content coding id.
+      /// @return the name of the content coding.
+      constexpr std::string_view name(id coding) noexcept
+      {
+        switch (coding)
+        {
+        case id::ZSTD:    return "zstd";
+        case id::GZIP:    return "gzip";
+        case id::DEFLATE: return "deflate";
+        default:          return "identity";
+        }
+      }
+
+      /// Whether a content coding is supported by this build.
+      /// @param coding the content coding id.
+      /// @return true if it can compress the content coding, false otherwise.
+      constexpr bool is_supported(id coding) noexcept
+      {
+        switch (coding)
+        {
+#ifdef HTTP_ZSTD
+        case id::ZSTD:    return true;
+#endif
+#ifdef HTTP_ZLIB
+        case id::GZIP:    return true;
+        case id::DEFLATE: return true;
+#endif
+        default:          return false;
+        }
+      }
+
+      /// Whether any content codings are supported by this build.
+      constexpr bool is_supported() noexcept
+      {
+        return is_supported(id::ZSTD) || is_supported(id::GZIP) ||
+               is_supported(id::DEFLATE);
+      }
+
+      /// Read the quality value of an Accept-Encoding element, see RFC7231
+      /// section 5.3.1.
+      /// @param parameters the parameters following the coding name.
+      /// @return the quality value in thousandths, 1000 if none.
+      inline int quality(std::string_view parameters) noexcept
+      {
+        auto pos(parameters.find_first_of("qQ"));
+        while (pos != std::string_view::npos)
+        {
+          auto value(parameters.substr(pos + 1u));
+          while (!value.empty() && std::isblank(static_cast<unsigned char>(value[0])))
+            value.remove_prefix(1u);
+
+          // "q=" must follow a ';' or whitespace
+          bool is_q((pos == 0u) || (parameters[pos - 1u] == ';') ||
+                    std::isblank(static_cast<unsigned char>(parameters[pos - 1u])));
+          if (is_q && !value.empty() && (value[0] == '='))
+          {
+            value.remove_prefix(1u);
+            while (!value.empty() && std::isblank(static_cast<unsigned char>(value[0])))
+              value.remove_prefix(1u);
+            if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])))
+              return 0;
+
+            int thousandths((value[0] - '0') * 1000);
+            if ((value.size() > 1u) && (value[1] == '.'))
+            {
+              int scale(100);
+              for (size_t i(2u); (i < value.size()) && (i < 5u) &&
+                                 std::isdigit(static_cast<unsigned char>(value[i])); ++i)
+              {
+                thousandths += (value[i] - '0') * scale;
+                scale /= 10;
+              }
+            }
+            return (thousandths > 1000) ? 1000 : thousandths;
+          }
+          pos = parameters.find_first_of("qQ", pos + 1u);
+        }
+        return 1000;
+      }
+
+      /// Choose a content coding from an Accept-Encoding header, see RFC7231
+      /// section 5.3.4.
+      /// The supported coding with the highest quality value is chosen, or
+      /// the first in order of preference if they're equal.
+      /// @param accept_encoding the value of the Accept-Encoding header.
+      /// @param available whether each content coding is available, indexed by
+      /// id, default: those supported by this build.
+      /// @return the content coding, IDENTITY if none are acceptable.
+      inline id negotiate(std::string_view accept_encoding,
+                          const bool* available = nullptr) noexcept
+      {
+        int qualities[NUMBER_OF_IDS] = {};
+        int identity_quality(-1);
+        int star_quality(-1);
+        bool listed[NUMBER_OF_IDS] = {};
+
+        while (!accept_encoding.empty())
+        {
+          auto end(accept_encoding.find(','));
+          auto element(accept_encoding.substr(0u, end));
+          accept_encoding.remove_prefix((end == std::string_view::npos) ?
+                                         accept_encoding.size() : end + 1u);
+
+          auto name_end(element.find(';'));
+          auto coding(element.substr(0u, name_end));
+          while (!coding.empty() && std::isblank(static_cast<unsigned char>(coding.front())))
+            coding.remove_prefix(1u);
+          while (!coding.empty() && std::isblank(static_cast<unsigned char>(coding.back())))
+            coding.remove_suffix(1u);
+          if (coding.empty())
+            continue;
+
+          int q((name_end == std::string_view::npos) ? 1000 :
+                quality(element.substr(name_end + 1u)));
+          if (coding == "*")
+            star_quality = q;
+          else if (equal_lowercase(coding, "identity"))
+            identity_quality = q;
+          else
+          {
+            for (size_t i(1u); i < NUMBER_OF_IDS; ++i)
+              if (equal_lowercase(coding, name(static_cast<id>(i))) ||
+                  ((static_cast<id>(i) == id::GZIP) &&
+                    equal_lowercase(coding, "x-gzip")))
+              {
+                qualities[i] = q;
+                listed[i] = true;
+              }
+          }
+        }
+
+        id chosen(id::IDENTITY);
+        int best(0);
+        for (size_t i(1u); i < NUMBER_OF_IDS; ++i)
+        {
+          auto coding(static_cast<id>(i));
+          bool can_use(available ? available[i] : is_supported(coding));
+          int q(listed[i] ? qualities[i] : (star_quality > 0 ? star_quality : 0));
+          if (can_use && (q > best))
+          {
+            chosen = coding;
+            best = q;
+          }
+        }
+
+        // identity is preferred only if the client explicitly prefers it
+        return (identity_quality > best) ? id::IDENTITY : chosen;
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @class compressor
+    /// A class to compress a message body or a stream of chunks.
+    //////////////////////////////////////////////////////////////////////////
+    class compressor
+    {
+      /// The size of the blocks appended to the output.
+      static constexpr size_t BLOCK_SIZE { 16384u };
+
+      content_coding::id coding_ { content_coding::id::IDENTITY };
+#ifdef HTTP_ZLIB
+      z_stream zstream_ {}; ///< the zlib stream
+#endif
+#ifdef HTTP_ZSTD
+      ZSTD_CCtx* zstd_context_ { nullptr }; ///< the zstd context
+#endif
+
+    public:
+
+      /// Default constructor, the compressor is not open.
+      compressor() = default;
+
+      /// The destructor frees the compression stream.
+      ~compressor()
+      { close(); }
+
+      compressor(compressor const&) = delete;
+      compressor& operator=(compressor const&) = delete;
+
+      /// Start compressing a stream.
+      /// @param coding the content coding.
+      /// @param level the compression level: 1 (fastest) to 9 (smallest).
+      /// @return true if the coding is supported, false otherwise.
+      bool open(content_coding::id coding,
+                int level = content_coding::DEFAULT_LEVEL)
+      {
+        close();
+        switch (coding)
+        {
+#ifdef HTTP_ZLIB
+        case content_coding::id::GZIP:
+        case content_coding::id::DEFLATE:
+          zstream_ = z_stream{};
+          // window bits + 16 for a gzip header and trailer
+          if (deflateInit2(&zstream_, level, Z_DEFLATED,
+                           (coding == content_coding::id::GZIP) ? 31 : 15,
+                           8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+          break;
+#endif
+#ifdef HTTP_ZSTD
+        case content_coding::id::ZSTD:
+          zstd_context_ = ZSTD_createCCtx();
+          if (!zstd_context_)
+            return false;
+          ZSTD_CCtx_setParameter(zstd_context_, ZSTD_c_compressionLevel, level);
+          break;
+#endif
+        default:
+          (void)level;
+          return false;
+        }
+
+        coding_ = coding;
+        return true;
+      }
+
+      /// Free the compression stream.
+      void close() noexcept
+      {
+#ifdef HTTP_ZLIB
+        if ((coding_ == content_coding::id::GZIP) ||
+            (coding_ == content_coding::id::DEFLATE))
+          deflateEnd(&zstream_);
+#endif
+#ifdef HTTP_ZSTD
+        if (zstd_context_)
+          ZSTD_freeCCtx(zstd_context_);
+        zstd_context_ = nullptr;
+#endif
+        coding_ = content_coding::id::IDENTITY;
+      }
+
+      /// Whether the compressor is open.
+      bool is_open() const noexcept
+      { return coding_ != content_coding::id::IDENTITY; }
+
+      /// Accessor for the content coding.
+      content_coding::id coding() const noexcept
+      { return coding_; }
+
+      /// Compress some data and append it to the output.
+      /// The compressed data is flushed, so that the output can be sent
+      /// immediately, e.g. as a chunk.
+      /// @pre the compressor is open.
+      /// @param data a pointer to the data.
+      /// @param size the size of the data.
+      /// @retval output the container to append the compressed data to.
+      /// @param finish whether this is the end of the stream.
+      /// @return true if successful, false otherwise.
+      template <typename Container>
+      bool compress(const char* data, size_t size, Container& output,
+                    bool finish)
+      {
+        (void)data; (void)size; (void)output; (void)finish;
+#ifdef HTTP_ZLIB
+        if ((coding_ == content_coding::id::GZIP) ||
+            (coding_ == content_coding::id::DEFLATE))
+        {
+          do
+          {
+            // zlib counts bytes in unsigned ints
+            auto input(static_cast<uInt>((size < UINT_MAX) ? size : UINT_MAX));
+            zstream_.next_in =
+              reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            zstream_.avail_in = input;
+            data += input;
+            size -= input;
+            int flush((size > 0u) ? Z_NO_FLUSH :
+                      (finish ? Z_FINISH : Z_SYNC_FLUSH));
+
+            do
+            {
+              auto start(output.size());
+              output.resize(start + BLOCK_SIZE);
+              zstream_.next_out = reinterpret_cast<Bytef*>(&output[start]);
+              zstream_.avail_out = static_cast<uInt>(BLOCK_SIZE);
+              int result(deflate(&zstream_, flush));
+              output.resize(start + BLOCK_SIZE - zstream_.avail_out);
+              if (result == Z_STREAM_ERROR)
+                return false;
+            } while (zstream_.avail_out == 0u);
+          } while (size > 0u);
+
+          return true;
+        }
+#endif
+#ifdef HTTP_ZSTD
+        if (coding_ == content_coding::id::ZSTD)
+        {
+          ZSTD_inBuffer input{ data, size, 0u };
+          size_t remaining(0u);
+          do
+          {
+            auto start(output.size());
+            output.resize(start + BLOCK_SIZE);
+            ZSTD_outBuffer block{ &output[start], BLOCK_SIZE, 0u };
+            remaining = ZSTD_compressStream2(zstd_context_, &block, &input,
+                                        finish ? ZSTD_e_end : ZSTD_e_flush);
+            output.resize(start + block.pos);
+            if (ZSTD_isError(remaining))
+              return false;
+          } while (remaining > 0u);
+
+          return true;
+        }
+#endif
+        return false;
+      }
+    };
+
+    /// Compress a whole message body.
+    /// @param coding the content coding.
+    /// @param level the compression level: 1 (fastest) to 9 (smallest).
+    /// @param body the message body to compress.
+    /// @retval output the compressed message body.
+    /// @return true if successful, false otherwise.
+    template <typename Container>
+    bool compress(content_coding::id coding, int level,
+                  Container const& body, Container& output)
+    {
+      compressor stream;
+      if (!stream.open(coding, level))
+        return false;
+
+      output.clear();
+      output.reserve(body.size() / 2u + 64u);
+      return stream.compress(body.data(), body.size(), output, true);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef ETAG_HPP_VIA_HTTPLIB_
+#define ETAG_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file etag.hpp
+/// @brief Functions to create and compare entity tags, see RFC7232.
+//////////////////////////////////////////////////////////////////////////////
+#include "character.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+namespace via
+{
+  namespace http
+  {
+    /// The 64 bit xxHash (XXH64) of some data: a fast non-cryptographic hash.
+    /// See: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    /// Note: the data is read in the byte order of the host, so the hash
+    /// is only the same as the reference implementation on little endian
+    /// hosts.
+    /// @param data a pointer to the data.
+    /// @param size the size of the data.
+    /// @param seed the hash seed, default zero.
+    /// @return the hash value.
+    inline std::uint64_t hash64(const char* data, size_t size,
+                                std::uint64_t seed = 0u) noexcept
+    {
+      constexpr std::uint64_t PRIME1 { 0x9E3779B185EBCA87ULL };
+      constexpr std::uint64_t PRIME2 { 0xC2B2AE3D27D4EB4FULL };
+      constexpr std::uint64_t PRIME3 { 0x165667B19E3779F9ULL };
+      constexpr std::uint64_t PRIME4 { 0x85EBCA77C2B2AE63ULL };
+      constexpr std::uint64_t PRIME5 { 0x27D4EB2F165667C5ULL };
+
+      auto rotl([](std::uint64_t value, int bits) noexcept
+      { return (value << bits) | (value >> (64 - bits)); });
+      auto read64([](const char* p) noexcept
+      { std::uint64_t value; std::memcpy(&value, p, 8u); return value; });
+      auto read32([](const char* p) noexcept
+      { std::uint32_t value; std::memcpy(&value, p, 4u); return value; });
+      auto round([&rotl](std::uint64_t acc, std::uint64_t input) noexcept
+      { return rotl(acc + input * PRIME2, 31) * PRIME1; });
+      auto merge([&round](std::uint64_t acc, std::uint64_t value) noexcept
+      { return (acc ^ round(0u, value)) * PRIME1 + PRIME4; });
+
+      const char* end(data + size);
+      std::uint64_t hash(0u);
+      if (size >= 32u)
+      {
+        std::uint64_t v1(seed + PRIME1 + PRIME2);
+        std::uint64_t v2(seed + PRIME2);
+        std::uint64_t v3(seed);
+        std::uint64_t v4(seed - PRIME1);
+        for (; data + 32u <= end; data += 32u)
+        {
+          v1 = round(v1, read64(data));
+          v2 = round(v2, read64(data + 8u));
+          v3 = round(v3, read64(data + 16u));
+          v4 = round(v4, read64(data + 24u));
+        }
+
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = merge(hash, v1);
+        hash = merge(hash, v2);
+        hash = merge(hash, v3);
+        hash = merge(hash, v4);
+      }
+      else
+        hash = seed + PRIME5;
+
+      hash += static_cast<std::uint64_t>(size);
+      for (; data + 8u <= end; data += 8u)
+        hash = rotl(hash ^ round(0u, read64(data)), 27) * PRIME1 + PRIME4;
+      if (data + 4u <= end)
+      {
+        hash = rotl(hash ^ (read32(data) * PRIME1), 23) * PRIME2 + PRIME3;
+        data += 4u;
+      }
+      for (; data < end; ++data)
+        hash = rotl(hash ^ (static_cast<unsigned char>(*data) * PRIME5), 11)
+               * PRIME1;
+
+      hash ^= hash >> 33;
+      hash *= PRIME2;
+      hash ^= hash >> 29;
+      hash *= PRIME3;
+      hash ^= hash >> 32;
+      return hash;
+    }
+
+    /// A strong entity tag for a message body, from its hash.
+    /// @param body the message body.
+    /// @return the entity tag, e.g. "\"ef46db3751d8e999\"".
+    inline std::string make_etag(std::string_view body)
+    {
+      auto hash(hash64(body.data(), body.size()));
+      std::string etag("\"");
+      auto digits(etag.size());
+      append_number(etag, static_cast<size_t>(hash), 16);
+      // pad the hash to 16 hex digits
+      etag.insert(digits, 17u - etag.size(), '0');
+      etag += '"';
+      return etag;
+    }
+
+    /// Whether an If-None-Match header matches an entity tag, using the weak
+    /// comparison of RFC7232 section 2.3.2.
+    /// @param if_none_match the value of the If-None-Match header.
+    /// @param etag the entity tag.
+    /// @return true if it matches, false otherwise.
+    inline bool etag_matches(std::string_view if_none_match,
+                             std::string_view etag) noexcept
+    {
+      auto opaque([](std::string_view tag) noexcept
+      {
+        while (!tag.empty() && std::isblank(static_cast<unsigned char>(tag.front())))
+          tag.remove_prefix(1u);
+        while (!tag.empty() && std::isblank(static_cast<unsigned char>(tag.back())))
+          tag.remove_suffix(1u);
+        if ((tag.size() > 2u) && (tag[0] == 'W') && (tag[1] == '/'))
+          tag.remove_prefix(2u);
+        return tag;
+      });
+
+      etag = opaque(etag);
+      while (!if_none_match.empty())
+      {
+        auto end(if_none_match.find(','));
+        auto tag(opaque(if_none_match.substr(0u, end)));
+        if ((tag == "*") || (tag == etag))
+          return true;
+        if (end == std::string_view::npos)
+          break;
+        if_none_match.remove_prefix(end + 1u);
+      }
+      return false;
+    }
+  }
+}
+
+#endif
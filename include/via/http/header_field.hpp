@@ -17,6 +17,9 @@
 #include "character.hpp"
 #include <string>
 #include <string_view>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 
 namespace via
@@ -347,11 +350,90 @@ namespace via
         }
       }
 
+      /// The number of standard header field ids, i.e. excluding
+      /// EXTENSION_HEADER.
+      constexpr size_t NUMBER_OF_IDS{static_cast<size_t>(id::EXTENSION_HEADER)};
+
+      /// The size of the header field name hash table: a power of 2.
+      constexpr size_t NAME_HASH_TABLE_SIZE{128u};
+
+      /// A hash of a lowercase header field name.
+      /// The coefficients have been chosen so that the hash is perfect for
+      /// the lowercase names of the standard header fields, i.e. every
+      /// standard header name hashes to a different value.
+      /// @param lc_name the lowercase header field name, must not be empty.
+      /// @return the hash of the name, less than NAME_HASH_TABLE_SIZE.
+      constexpr size_t name_hash(std::string_view lc_name) noexcept
+      {
+        return (lc_name.size()
+              + 22u * static_cast<unsigned char>(lc_name.front())
+              + 24u * static_cast<unsigned char>(lc_name.back())
+              + 28u * static_cast<unsigned char>(lc_name[lc_name.size() / 2]))
+             & (NAME_HASH_TABLE_SIZE - 1u);
+      }
+
+      /// The table of header field ids indexed by name_hash.
+      /// Unused entries contain EXTENSION_HEADER.
+      /// Note: a hash collision causes a compilation error.
+      struct name_hash_table
+      {
+        id ids[NAME_HASH_TABLE_SIZE]; ///< the header field ids
+
+        /// Constructor, hashes the lowercase names of the standard headers.
+        constexpr name_hash_table()
+          : ids{}
+        {
+          for (auto& field_id : ids)
+            field_id = id::EXTENSION_HEADER;
+
+          for (size_t i(0u); i < NUMBER_OF_IDS; ++i)
+          {
+            auto field_id(static_cast<id>(i));
+            auto& entry(ids[name_hash(lowercase_name(field_id))]);
+            if (entry != id::EXTENSION_HEADER)
+              throw "header_field::name_hash is not a perfect hash";
+            entry = field_id;
+          }
+        }
+      };
+
+      /// The header field name hash table.
+      inline constexpr name_hash_table NAME_HASH_TABLE{};
+
+      /// Lookup the id of a header field from its lowercase name.
+      /// @param lc_name the lowercase header field name.
+      /// @return the id of a standard header field, EXTENSION_HEADER otherwise.
+      constexpr id find_id(std::string_view lc_name) noexcept
+      {
+        if (lc_name.empty())
+          return id::EXTENSION_HEADER;
+
+        auto field_id(NAME_HASH_TABLE.ids[name_hash(lc_name)]);
+        return ((field_id != id::EXTENSION_HEADER) &&
+                (lowercase_name(field_id) == lc_name)) ?
+                  field_id : id::EXTENSION_HEADER;
+      }
+
+      /// Append the field name and value to the output as an http header line.
+      /// @param output the string to append to.
+      /// @param name header field name.
+      /// @param value header field value.
+      inline void append_header(std::string& output,
+                                std::string_view name, std::string_view value)
+      {
+        output.append(name).append(SEPARATOR).append(value).append(CRLF);
+      }
+
       /// Format the field name and value into an http header line.
       /// @param name header field name.
       /// @param value header field value.
       inline std::string to_header(std::string_view name, std::string_view value)
-      { return std::string(name) + SEPARATOR + std::string(value) + CRLF; }
+      {
+        std::string output;
+        output.reserve(name.size() + value.size() + 4u);
+        append_header(output, name, value);
+        return output;
+      }
 
       /// Format the field id and value into an http header line.
       /// @param field_id header field id.
@@ -359,27 +441,213 @@ namespace via
       inline std::string to_header(id field_id, std::string_view value)
       { return to_header(standard_name(field_id), value); }
 
-#ifdef _MSC_VER
-#pragma warning( push )
-#pragma warning( disable : 4996 ) // MSVC doesn't like gmtime...
-#endif
+      /// The length of an http date in RFC1123 format,
+      /// e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+      constexpr size_t DATE_LENGTH { 29u };
+
+      /// Format a time as an http date in RFC1123 format.
+      /// Note: unlike gmtime and strftime, it is thread safe and independent
+      /// of the locale.
+      /// @param time the time in seconds since the epoch.
+      /// @param date a buffer of at least DATE_LENGTH characters.
+      inline void format_date(std::time_t time, char* date) noexcept
+      {
+        static constexpr char DAYS[]   {"ThuFriSatSunMonTueWed"};
+        static constexpr char MONTHS[] {"JanFebMarAprMayJunJulAugSepOctNovDec"};
+        constexpr long long SECONDS_PER_DAY { 86400 };
+
+        auto seconds(static_cast<long long>(time));
+        auto days(seconds / SECONDS_PER_DAY);
+        auto day_seconds(seconds % SECONDS_PER_DAY);
+        if (day_seconds < 0)
+        {
+          day_seconds += SECONDS_PER_DAY;
+          --days;
+        }
+
+        // Convert the days since the epoch to a civil date.
+        // See: http://howardhinnant.github.io/date_algorithms.html
+        auto weekday(days % 7);
+        if (weekday < 0)
+          weekday += 7;
+        auto z(days + 719468);
+        auto era((z >= 0 ? z : z - 146096) / 146097);
+        auto day_of_era(z - era * 146097);
+        auto year_of_era((day_of_era - day_of_era / 1460 + day_of_era / 36524
+                          - day_of_era / 146096) / 365);
+        auto day_of_year(day_of_era -
+                         (365 * year_of_era + year_of_era / 4 - year_of_era / 100));
+        auto mp((5 * day_of_year + 2) / 153);
+        auto day(day_of_year - (153 * mp + 2) / 5 + 1);
+        auto month(mp < 10 ? mp + 3 : mp - 9);
+        auto year(year_of_era + era * 400 + (month <= 2 ? 1 : 0));
+
+        auto put2([](char* out, long long value) noexcept
+        {
+          out[0] = static_cast<char>('0' + value / 10);
+          out[1] = static_cast<char>('0' + value % 10);
+        });
+
+        std::memcpy(date, DAYS + weekday * 3, 3);
+        date[3] = ',';
+        date[4] = ' ';
+        put2(date + 5, day);
+        date[7] = ' ';
+        std::memcpy(date + 8, MONTHS + (month - 1) * 3, 3);
+        date[11] = ' ';
+        put2(date + 12, (year / 100) % 100);
+        put2(date + 14, year % 100);
+        date[16] = ' ';
+        put2(date + 17, day_seconds / 3600);
+        date[19] = ':';
+        put2(date + 20, (day_seconds / 60) % 60);
+        date[22] = ':';
+        put2(date + 23, day_seconds % 60);
+        std::memcpy(date + 25, " GMT", 4);
+      }
+
+      /// Parse an http date in RFC1123 format, the inverse of format_date.
+      /// Note: the obsolete RFC850 and asctime formats are not accepted.
+      /// @param date the http date, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+      /// @return the time in seconds since the epoch, -1 if it is invalid.
+      inline std::time_t parse_date(std::string_view date) noexcept
+      {
+        static constexpr std::string_view MONTHS
+          {"JanFebMarAprMayJunJulAugSepOctNovDec"};
+
+        if ((date.size() != DATE_LENGTH) || (date[3] != ',') ||
+            (date.substr(25) != " GMT"))
+          return -1;
+
+        bool valid(true);
+        auto get([&date, &valid](size_t pos, size_t length) noexcept
+        {
+          long long value(0);
+          for (size_t i(pos); i < pos + length; ++i)
+          {
+            if (!std::isdigit(static_cast<unsigned char>(date[i])))
+              valid = false;
+            value = value * 10 + (date[i] - '0');
+          }
+          return value;
+        });
+
+        auto day(get(5, 2));
+        auto month_pos(MONTHS.find(date.substr(8, 3)));
+        auto year(get(12, 4));
+        auto hours(get(17, 2));
+        auto minutes(get(20, 2));
+        auto seconds(get(23, 2));
+        if (!valid || (month_pos == std::string_view::npos) || (month_pos % 3) ||
+            (day < 1) || (day > 31) || (hours > 23) || (minutes > 59) ||
+            (seconds > 60))
+          return -1;
+
+        // Convert the civil date to days since the epoch.
+        // See: http://howardhinnant.github.io/date_algorithms.html
+        auto month(static_cast<long long>(month_pos / 3 + 1));
+        year -= (month <= 2) ? 1 : 0;
+        auto era(year / 400);
+        auto year_of_era(year - era * 400);
+        auto day_of_year((153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+                         + day - 1);
+        auto day_of_era(year_of_era * 365 + year_of_era / 4 - year_of_era / 100
+                        + day_of_year);
+        auto days(era * 146097 + day_of_era - 719468);
+
+        return static_cast<std::time_t>
+            (days * 86400 + hours * 3600 + minutes * 60 + seconds);
+      }
+
+      //////////////////////////////////////////////////////////////////////////
+      /// @class date_cache
+      /// The current http date, formatted at most once a second and shared
+      /// by all threads.
+      /// It is a sequence lock: the thread that finds that the second has
+      /// changed formats the date, while any other threads continue to read
+      /// it without waiting on a mutex.
+      //////////////////////////////////////////////////////////////////////////
+      class date_cache
+      {
+        /// The number of words to hold the date.
+        static constexpr size_t WORDS { (DATE_LENGTH + 7u) / 8u };
+
+        std::atomic<unsigned> sequence_ { 0u }; ///< odd while being updated
+        std::atomic<long long> second_ { -1 };  ///< the second of the date
+        std::atomic<std::uint64_t> words_[WORDS] {}; ///< the formatted date
+
+        /// Format the date for a new second, unless another thread is.
+        /// @param now the current time.
+        void update(std::time_t now) noexcept
+        {
+          auto sequence(sequence_.load(std::memory_order_relaxed));
+          if ((sequence & 1u) ||
+              !sequence_.compare_exchange_strong(sequence, sequence + 1u,
+                                                 std::memory_order_relaxed))
+            return;
+          std::atomic_thread_fence(std::memory_order_release);
+
+          char date[WORDS * 8u] {};
+          format_date(now, date);
+          for (size_t i(0u); i < WORDS; ++i)
+          {
+            std::uint64_t word;
+            std::memcpy(&word, date + i * 8u, 8u);
+            words_[i].store(word, std::memory_order_relaxed);
+          }
+
+          second_.store(static_cast<long long>(now), std::memory_order_relaxed);
+          sequence_.store(sequence + 2u, std::memory_order_release);
+        }
+
+      public:
+
+        /// Copy the current http date.
+        /// @param date a buffer of at least DATE_LENGTH characters.
+        void read(char* date) noexcept
+        {
+          auto now(std::time(nullptr));
+          if (static_cast<long long>(now) !=
+              second_.load(std::memory_order_relaxed))
+            update(now);
+
+          std::uint64_t words[WORDS];
+          for (;;)
+          {
+            auto sequence(sequence_.load(std::memory_order_acquire));
+            if ((sequence & 1u) == 0u)
+            {
+              for (size_t i(0u); i < WORDS; ++i)
+                words[i] = words_[i].load(std::memory_order_relaxed);
+              std::atomic_thread_fence(std::memory_order_acquire);
+              if (sequence_.load(std::memory_order_relaxed) == sequence)
+                break;
+            }
+          }
+          std::memcpy(date, words, DATE_LENGTH);
+        }
+      };
+
+      /// The process wide cache of the current http date.
+      inline date_cache DATE_CACHE {};
+
+      /// Append an http header line for the current date and time.
+      /// @param output the string to append to.
+      inline void append_date_header(std::string& output)
+      {
+        char date[DATE_LENGTH];
+        DATE_CACHE.read(date);
+        output.append(HEADER_DATE).append(SEPARATOR)
+              .append(date, DATE_LENGTH).append(CRLF);
+      }
+
       /// Create an http header line for the current date and time.
       inline std::string date_header()
       {
-        /// The value to use to format an HTTP date into RFC1123 format.
-        static constexpr char DATE_FORMAT[] {"%a, %d %b %Y %H:%M:%S GMT"};
-
-        char dateBuffer[30] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-        time_t uTime;
-        time(&uTime);
-        strftime(dateBuffer, 30, DATE_FORMAT, std::gmtime(&uTime));
-        return to_header(HEADER_DATE, dateBuffer);
+        std::string output;
+        append_date_header(output);
+        return output;
       }
-#ifdef _MSC_VER
-#pragma warning( pop )
-#endif
 
       /// Create an http header line for this server.
       inline std::string server_header()
@@ -389,13 +657,78 @@ namespace via
       inline std::string content_http_header()
       { return to_header(HEADER_CONTENT_TYPE, MESSAGE_HTTP); }
 
+      /// Append an http content length header line for the given size.
+      /// @param output the string to append to.
+      /// @param size the size of the message body.
+      inline void append_content_length(std::string& output, size_t size)
+      {
+        output.append(HEADER_CONTENT_LENGTH).append(SEPARATOR);
+        append_number(output, size);
+        output.append(CRLF);
+      }
+
+      /// Whether a header string contains a header line with the given name.
+      /// @param header_string the header lines.
+      /// @param lc_name the header field name, in lowercase.
+      /// @return true if a header line has the name, false otherwise.
+      inline bool contains_field(std::string_view header_string,
+                                 std::string_view lc_name) noexcept
+      {
+        size_t start(0u);
+        while (start < header_string.size())
+        {
+          auto end(header_string.find('\n', start));
+          auto line(header_string.substr(start, end - start));
+          if ((line.size() > lc_name.size()) && (line[lc_name.size()] == ':') &&
+              equal_lowercase(line.substr(0u, lc_name.size()), lc_name))
+            return true;
+
+          if (end == std::string_view::npos)
+            break;
+          start = end + 1u;
+        }
+        return false;
+      }
+
+      /// Find the value of a header field in a string of header lines.
+      /// @param header_string the header lines.
+      /// @param lc_name the header field name, in lowercase.
+      /// @return the value of the first header line with the name, without
+      /// leading or trailing whitespace, empty if not found.
+      inline std::string_view find_field(std::string_view header_string,
+                                         std::string_view lc_name) noexcept
+      {
+        size_t start(0u);
+        while (start < header_string.size())
+        {
+          auto end(header_string.find('\n', start));
+          auto line(header_string.substr(start, end - start));
+          if ((line.size() > lc_name.size()) && (line[lc_name.size()] == ':') &&
+              equal_lowercase(line.substr(0u, lc_name.size()), lc_name))
+          {
+            auto value(line.substr(lc_name.size() + 1u));
+            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front())))
+              value.remove_prefix(1u);
+            while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back())))
+              value.remove_suffix(1u);
+            return value;
+          }
+
+          if (end == std::string_view::npos)
+            break;
+          start = end + 1u;
+        }
+        return std::string_view();
+      }
+
       /// An http content length header line for the given size.
       /// @param size
       /// @return http content length header line for the size.
       inline std::string content_length(size_t size)
       {
-        return std::string(HEADER_CONTENT_LENGTH) + SEPARATOR
-             + std::to_string(size) + CRLF;
+        std::string output;
+        append_content_length(output, size);
+        return output;
       }
 
       /// An http transfer encoding header line containing "Chunked".
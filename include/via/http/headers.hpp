@@ -16,6 +16,11 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "header_field.hpp"
 #include <unordered_map>
+#include <array>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace via
 {
@@ -34,7 +39,9 @@ namespace via
       EXPECT_CONTINUE, ///< the client expects a 100 Continue response
       INCOMPLETE,      ///< the message requires more data
       VALID,           ///< a valid request or response
-      CHUNK            ///< a valid chunk received
+      CHUNK,           ///< a valid chunk received
+      HEADERS,         ///< a valid request header, its body shall be streamed
+      BODY             ///< a fragment of a streamed request body received
     };
 
     //////////////////////////////////////////////////////////////////////////
@@ -212,12 +219,406 @@ namespace via
     /// An unordered_map of strings indexed by strings.
     typedef std::unordered_map<std::string, std::string> StringMap;
 
+    //////////////////////////////////////////////////////////////////////////
+    /// @class inline_vector
+    /// A vector that stores up to N items in an array inside the object and
+    /// only uses the heap when it holds more than N items.
+    /// Note: clear() moves it back to the array but retains the capacity of
+    /// the heap, so a second overflow doesn't allocate memory either.
+    /// @tparam T the type of the items, it must be trivially copyable.
+    /// @tparam N the number of items stored in the object.
+    //////////////////////////////////////////////////////////////////////////
+    template <typename T, size_t N>
+    class inline_vector
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "inline_vector items must be trivially copyable");
+
+      std::array<T, N> array_ {}; ///< the items, if not on_heap_
+      std::vector<T> heap_ {};    ///< the items, if on_heap_
+      size_t size_ { 0u };        ///< the number of items
+      bool on_heap_ { false };    ///< whether the items are in heap_
+
+    public:
+
+      /// A pointer to the first item.
+      T* data() noexcept
+      { return on_heap_ ? heap_.data() : array_.data(); }
+
+      /// A pointer to the first item.
+      T const* data() const noexcept
+      { return on_heap_ ? heap_.data() : array_.data(); }
+
+      /// The number of items.
+      size_t size() const noexcept
+      { return size_; }
+
+      /// Whether there are no items.
+      bool empty() const noexcept
+      { return size_ == 0u; }
+
+      /// The item at the given index.
+      T& operator[](size_t index) noexcept
+      { return data()[index]; }
+
+      /// The item at the given index.
+      T const& operator[](size_t index) const noexcept
+      { return data()[index]; }
+
+      /// A pointer to the first item.
+      T* begin() noexcept
+      { return data(); }
+
+      /// A pointer beyond the last item.
+      T* end() noexcept
+      { return data() + size_; }
+
+      /// A pointer to the first item.
+      T const* begin() const noexcept
+      { return data(); }
+
+      /// A pointer beyond the last item.
+      T const* end() const noexcept
+      { return data() + size_; }
+
+      /// Add an item to the end.
+      /// @param item the item.
+      void push_back(T const& item)
+      {
+        if (!on_heap_)
+        {
+          if (size_ < N)
+          {
+            array_[size_++] = item;
+            return;
+          }
+
+          heap_.assign(array_.cbegin(), array_.cbegin() + size_);
+          on_heap_ = true;
+        }
+
+        heap_.push_back(item);
+        ++size_;
+      }
+
+      /// Remove all of the items.
+      void clear() noexcept
+      {
+        heap_.clear();
+        size_ = 0u;
+        on_heap_ = false;
+      }
+
+      /// Swap the items with another inline_vector.
+      /// @param other the other inline_vector
+      void swap(inline_vector& other) noexcept
+      {
+        array_.swap(other.array_);
+        heap_.swap(other.heap_);
+        std::swap(size_, other.size_);
+        std::swap(on_heap_, other.on_heap_);
+      }
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @class header_fields
+    /// A flat collection of HTTP header fields.
+    /// The field names and values are stored in a single character buffer
+    /// and the fields are held in a vector in the order that they were
+    /// added. The standard header fields are also indexed by their
+    /// header_field::id, so that finding them is just an array lookup.
+    /// Each name and value in the buffer is null terminated, so the data()
+    /// of a returned string_view may be used as a C string.
+    /// The fields of a typical message are held inside the object, in an
+    /// inline_vector, so only the buffer is allocated.
+    /// Note: clear() retains the capacity of the buffer, so once it has grown
+    /// to hold a typical message's headers, subsequent messages are stored
+    /// without allocating any memory.
+    //////////////////////////////////////////////////////////////////////////
+    class header_fields
+    {
+    public:
+
+      /// The number of fields stored without allocating memory.
+      static constexpr size_t INLINE_FIELDS { 16u };
+
+    private:
+
+      /// The location of a header field in the buffer.
+      struct field
+      {
+        header_field::id id;  ///< the field id, EXTENSION_HEADER if non-standard
+        size_t name_offset;   ///< the offset of an extension header name
+        size_t name_length;   ///< the length of an extension header name
+        size_t value_offset;  ///< the offset of the field value
+        size_t value_length;  ///< the length of the field value
+      };
+
+      /// The field names (extension headers only) and values.
+      std::string buffer_ {};
+      /// The fields in the order that they were added.
+      inline_vector<field, INLINE_FIELDS> fields_ {};
+      /// The positions of the standard fields in fields_ plus one, zero if
+      /// the field is not present.
+      std::array<unsigned short, header_field::NUMBER_OF_IDS> index_ {};
+      /// The size of the values in the buffer that have been replaced.
+      size_t unused_ { 0u };
+
+      /// The name of the field.
+      std::string_view name(field const& f) const noexcept
+      {
+        return (f.id != header_field::id::EXTENSION_HEADER) ?
+          header_field::lowercase_name(f.id) :
+          std::string_view(buffer_.data() + f.name_offset, f.name_length);
+      }
+
+      /// The value of the field.
+      std::string_view value(field const& f) const noexcept
+      { return std::string_view(buffer_.data() + f.value_offset, f.value_length); }
+
+      /// Copy the names and values of the fields to the start of the
+      /// buffer, removing the values that have been replaced.
+      void compact()
+      {
+        std::string compacted;
+        compacted.reserve(buffer_.capacity());
+        for (auto& f : fields_)
+        {
+          if (f.id == header_field::id::EXTENSION_HEADER)
+          {
+            auto name_offset(compacted.size());
+            compacted.append(buffer_, f.name_offset, f.name_length + 1u);
+            f.name_offset = name_offset;
+          }
+
+          auto value_offset(compacted.size());
+          compacted.append(buffer_, f.value_offset, f.value_length + 1u);
+          f.value_offset = value_offset;
+        }
+
+        buffer_.swap(compacted);
+        unused_ = 0u;
+      }
+
+      /// Find a field.
+      /// @param field_id the id of the field.
+      /// @param lc_name the lowercase name of the field.
+      /// @return a pointer to the field, nullptr if not found.
+      field* find_field(header_field::id field_id, std::string_view lc_name) noexcept
+      {
+        if (field_id != header_field::id::EXTENSION_HEADER)
+        {
+          auto position(index_[static_cast<size_t>(field_id)]);
+          return position ? &fields_[position - 1u] : nullptr;
+        }
+
+        for (auto& f : fields_)
+          if ((f.id == header_field::id::EXTENSION_HEADER) && (name(f) == lc_name))
+            return &f;
+
+        return nullptr;
+      }
+
+    public:
+
+      /// @class const_iterator
+      /// An iterator over the name, value pairs of the header fields.
+      class const_iterator
+      {
+        header_fields const* fields_;                      ///< the collection
+        field const* iter_;                                ///< the current field
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<std::string_view, std::string_view>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        /// Constructor.
+        const_iterator(header_fields const* fields,
+                       field const* iter) noexcept
+          : fields_(fields)
+          , iter_(iter)
+        {}
+
+        /// @return the name, value pair of the current field.
+        value_type operator*() const noexcept
+        { return value_type(fields_->name(*iter_), fields_->value(*iter_)); }
+
+        /// Pre-increment.
+        const_iterator& operator++() noexcept
+        {
+          ++iter_;
+          return *this;
+        }
+
+        /// Post-increment.
+        const_iterator operator++(int) noexcept
+        {
+          const_iterator tmp(*this);
+          ++iter_;
+          return tmp;
+        }
+
+        friend bool operator==(const_iterator const& lhs,
+                               const_iterator const& rhs) noexcept
+        { return lhs.iter_ == rhs.iter_; }
+
+        friend bool operator!=(const_iterator const& lhs,
+                               const_iterator const& rhs) noexcept
+        { return lhs.iter_ != rhs.iter_; }
+      };
+
+      /// Default Constructor.
+      header_fields() = default;
+
+      /// Clear the header_fields.
+      /// Note: retains the capacity of the buffer and the fields.
+      void clear() noexcept
+      {
+        for (auto const& f : fields_)
+          if (f.id != header_field::id::EXTENSION_HEADER)
+            index_[static_cast<size_t>(f.id)] = 0u;
+
+        fields_.clear();
+        buffer_.clear();
+        unused_ = 0u;
+      }
+
+      /// Swap member variables with another header_fields.
+      /// @param other the other header_fields
+      void swap(header_fields& other) noexcept
+      {
+        buffer_.swap(other.buffer_);
+        fields_.swap(other.fields_);
+        index_.swap(other.index_);
+        std::swap(unused_, other.unused_);
+      }
+
+      /// Add a header field to the collection.
+      /// If the field is already present, then the value is appended to
+      /// the existing value, separated by the separator.
+      /// @param lc_name the field name (in lower case)
+      /// @param value the field value.
+      /// @param separator the character to separate repeated values.
+      /// @return the id of the header field.
+      header_field::id add(std::string_view lc_name, std::string_view value,
+                           char separator)
+      {
+        auto field_id(header_field::find_id(lc_name));
+        auto existing(find_field(field_id, lc_name));
+        if (existing)
+        {
+          // append the new value in place if the existing value is the last
+          // in the buffer, e.g. consecutive repeated fields
+          if (existing->value_offset + existing->value_length + 1u
+                == buffer_.size())
+            buffer_.pop_back();
+          else
+          {
+            // otherwise copy the existing value to the end of the buffer
+            auto value_offset(buffer_.size());
+            buffer_.append(buffer_, existing->value_offset, existing->value_length);
+            existing->value_offset = value_offset;
+            unused_ += existing->value_length + 1u;
+          }
+
+          buffer_.push_back(separator);
+          buffer_.append(value);
+          existing->value_length = buffer_.size() - existing->value_offset;
+          buffer_.push_back('\0');
+
+          // remove the replaced values once they fill half of the buffer
+          if (unused_ > buffer_.size() / 2u)
+            compact();
+        }
+        else
+        {
+          field f{ field_id, 0u, 0u, 0u, value.size() };
+          if (field_id == header_field::id::EXTENSION_HEADER)
+          {
+            f.name_offset = buffer_.size();
+            f.name_length = lc_name.size();
+            buffer_.append(lc_name);
+            buffer_.push_back('\0');
+          }
+          else
+            index_[static_cast<size_t>(field_id)] =
+              static_cast<unsigned short>(fields_.size() + 1u);
+
+          f.value_offset = buffer_.size();
+          buffer_.append(value);
+          buffer_.push_back('\0');
+          fields_.push_back(f);
+        }
+
+        return field_id;
+      }
+
+      /// Find the value for a given header name.
+      /// @param lc_name the name of the header in lowercase.
+      /// @return the value, blank if not found
+      std::string_view find(std::string_view lc_name) const noexcept
+      {
+        auto field_id(header_field::find_id(lc_name));
+        if (field_id != header_field::id::EXTENSION_HEADER)
+          return find(field_id);
+
+        for (auto const& f : fields_)
+          if ((f.id == header_field::id::EXTENSION_HEADER) && (name(f) == lc_name))
+            return value(f);
+
+        return std::string_view();
+      }
+
+      /// Find the value for a given header id.
+      /// @param field_id the id of the header.
+      /// @return the value, blank if not found
+      std::string_view find(header_field::id field_id) const noexcept
+      {
+        if (field_id == header_field::id::EXTENSION_HEADER)
+          return std::string_view();
+
+        auto position(index_[static_cast<size_t>(field_id)]);
+        return position ? value(fields_[position - 1u]) : std::string_view();
+      }
+
+      /// The number of header fields.
+      size_t size() const noexcept
+      { return fields_.size(); }
+
+      /// Whether there are any header fields.
+      bool empty() const noexcept
+      { return fields_.empty(); }
+
+      /// An iterator to the first header field.
+      const_iterator begin() const noexcept
+      { return const_iterator(this, fields_.begin()); }
+
+      /// An iterator beyond the last header field.
+      const_iterator end() const noexcept
+      { return const_iterator(this, fields_.end()); }
+
+      /// Copy the header fields into a StringMap, e.g. for code written for
+      /// the StringMap that message_headers::fields() used to return.
+      /// @return the lowercase names and the values of the header fields.
+      StringMap to_map() const
+      {
+        StringMap map;
+        for (auto const& [lc_name, field_value] : *this)
+          map.emplace(lc_name, field_value);
+        return map;
+      }
+    }; // class header_fields
+
     //////////////////////////////////////////////////////////////////////////
     /// @class message_headers
     /// The collection of HTTP headers received with a request, response or a
     /// chunk (trailers).
     /// Note: the parse function converts the received field names into lower
-    /// case before storing them in a unordered_map for efficient access.
+    /// case before storing them in a header_fields collection for efficient
+    /// access.
     /// @tparam MAX_HEADER_NUMBER the maximum number of HTTP header field lines:
     /// max 65534.
     /// @tparam MAX_HEADER_LENGTH the maximum cumulative length the HTTP header
@@ -239,11 +640,50 @@ namespace via
     class message_headers
     {
       /// The HTTP message header fields.
-      StringMap fields_ {};
+      header_fields fields_ {};
       /// The current field being parsed
       field_line<MAX_LINE_LENGTH, MAX_WHITESPACE_CHARS, STRICT_CRLF> field_ {};
       bool       valid_ { false }; ///< true if the headers are valid
       size_t     length_ { 0u };   ///< the length of the message headers
+      std::string lc_name_ {};     ///< a field name converted to lower case
+
+      // The message framing metadata, cached as the fields are added.
+      std::ptrdiff_t content_length_ { 0 };  ///< the Content-Length value
+      bool is_chunked_ { false };            ///< Transfer-Encoding not identity
+      bool close_connection_ { false };      ///< Connection: close
+      bool expect_continue_ { false };       ///< Expect: 100-continue
+      bool has_host_ { false };              ///< a non-empty Host field
+
+      /// Update the cached framing metadata for a header field.
+      /// Note: repeated fields are evaluated on their combined value.
+      /// @param field_id the id of the header field.
+      void update_metadata(header_field::id field_id) noexcept
+      {
+        switch (field_id)
+        {
+        case header_field::id::CONTENT_LENGTH:
+        {
+          auto value(fields_.find(field_id));
+          content_length_ = value.empty() ? 0 : from_dec_string(value);
+          break;
+        }
+        case header_field::id::TRANSFER_ENCODING:
+          // Note: is transfer encoding if "identity" is NOT found.
+          is_chunked_ = !contains_lowercase(fields_.find(field_id), IDENTITY);
+          break;
+        case header_field::id::CONNECTION:
+          close_connection_ = contains_lowercase(fields_.find(field_id), CLOSE);
+          break;
+        case header_field::id::EXPECT:
+          expect_continue_ = contains_lowercase(fields_.find(field_id), CONTINUE);
+          break;
+        case header_field::id::HOST:
+          has_host_ = !fields_.find(field_id).empty();
+          break;
+        default:
+          break;
+        }
+      }
 
     public:
 
@@ -258,6 +698,11 @@ namespace via
         field_.clear();
         valid_ = false;
         length_ = 0;
+        content_length_ = 0;
+        is_chunked_ = false;
+        close_connection_ = false;
+        expect_continue_ = false;
+        has_host_ = false;
       }
 
       /// Swap member variables with another message_headers.
@@ -268,6 +713,11 @@ namespace via
         field_.swap(other.field_);
         std::swap(valid_, other.valid_);
         std::swap(length_, other.length_);
+        std::swap(content_length_, other.content_length_);
+        std::swap(is_chunked_, other.is_chunked_);
+        std::swap(close_connection_, other.close_connection_);
+        std::swap(expect_continue_, other.expect_continue_);
+        std::swap(has_host_, other.has_host_);
       }
 
       /// Parse message_headers from a received request or response.
@@ -310,103 +760,145 @@ namespace via
         return valid_;
       }
 
+      /// Parse a complete block of message_headers in a single pass.
+      /// Note: it only accepts header field lines without obsolete line
+      /// folding, any other form (or an invalid field line) is left for the
+      /// incremental parser to parse or reject.
+      /// @pre the message_headers are clear.
+      /// @param block the header field lines, including the blank line at
+      /// the end of the message_headers.
+      /// @return true if parsed ok, false otherwise.
+      bool parse_block(std::string_view block)
+      {
+        while (!block.empty())
+        {
+          auto line_end(block.find('\n'));
+          if (line_end == std::string_view::npos)
+            return false;
+
+          auto line(block.substr(0u, line_end));
+          block.remove_prefix(line_end + 1u);
+          bool has_cr(!line.empty() && ('\r' == line.back()));
+          if (has_cr)
+            line.remove_suffix(1u);
+
+          // the blank line at the end of message_headers
+          if (line.empty())
+          {
+            valid_ = block.empty();
+            return valid_;
+          }
+
+          if ((STRICT_CRLF && !has_cr) || (line_end + 1u > MAX_LINE_LENGTH))
+            return false;
+
+          // leave obsolete line folding to the incremental parser
+          if (!block.empty() && std::isblank(static_cast<unsigned char>(block.front())))
+            return false;
+
+          auto colon(line.find(':'));
+          if (colon == std::string_view::npos)
+            return false;
+
+          // validate the field name and convert it to lower case
+          auto name(line.substr(0u, colon));
+          lc_name_.resize(name.size());
+          for (size_t i(0u); i < name.size(); ++i)
+          {
+            char c(name[i]);
+            if (('A' <= c) && (c <= 'Z'))
+              c = static_cast<char>(c + ('a' - 'A'));
+            else if (((c < 'a') || ('z' < c)) && ('-' != c))
+              return false;
+            lc_name_[i] = c;
+          }
+
+          auto value(line.substr(colon + 1u));
+          auto leading_ws(std::min(value.find_first_not_of(" \t"), value.size()));
+          if (leading_ws > MAX_WHITESPACE_CHARS)
+            return false;
+
+          value.remove_prefix(leading_ws);
+          if (value.find('\r') != std::string_view::npos)
+            return false;
+
+          length_ += name.size() + value.size();
+          add(lc_name_, value);
+
+          if ((length_ > MAX_HEADER_LENGTH)
+           || (fields_.size() > MAX_HEADER_NUMBER))
+            return false;
+        }
+
+        return false;
+      }
+
       /// Add a header to the collection.
       /// @param name the field name (in lower case)
       /// @param value the field value.
       void add(std::string_view name, std::string_view value)
       {
-        auto iter(fields_.find(name.data()));
-        // if the field name was found previously
-        if (iter != fields_.end())
-        {
-          char separator((name.find(COOKIE) != std::string::npos) ? ';' : ',');
-          iter->second.append({separator});
-          iter->second.append(value);
-        }
-        else
-          fields_.insert(StringMap::value_type(name, value));
+        // repeated cookie values are separated by ';' others by ','
+        char separator((name.find(COOKIE) != std::string::npos) ? ';' : ',');
+        update_metadata(fields_.add(name, value, separator));
       }
 
       /// Find the value for a given header name.
       /// Note: the name must be in lowercase for received message_headers.
       /// @param name the name of the header.
       /// @return the value, blank if not found
-      std::string_view find(std::string_view name) const
-      {
-        const auto iter(fields_.find(name.data()));
-        return (iter != fields_.end()) ? iter->second : std::string_view();
-      }
+      std::string_view find(std::string_view name) const noexcept
+      { return fields_.find(name); }
 
       /// Find the value for a given header id.
       /// @param field_id the id of the header.
       /// @return the value, blank if not found
-      std::string_view find(header_field::id field_id) const
-      { return find(header_field::lowercase_name(field_id)); }
+      std::string_view find(header_field::id field_id) const noexcept
+      { return fields_.find(field_id); }
 
       /// If there is a Content-Length field return its size.
       /// @return the value of the Content-Length field or
       /// -1 if it was invalid.
       /// May also return zero if it was not found.
       std::ptrdiff_t content_length() const noexcept
-      {
-        // Find whether there is a content length field.
-        auto content_length(find(header_field::LC_CONTENT_LENGTH));
-        return (content_length.empty()) ? 0 : from_dec_string(content_length);
-      }
+      { return content_length_; }
 
       /// Whether Chunked Transfer Coding is applied to the message.
       /// @return true if there is a transfer-encoding header and it does
       /// NOT contain the keyword "identity". See RFC2616 section 4.4 para 2.
-      bool is_chunked() const
-      {
-        // Find whether there is a transfer encoding header.
-        std::string xfer_encoding(find(header_field::LC_TRANSFER_ENCODING));
-        if (xfer_encoding.empty())
-          return false;
-
-        std::transform(xfer_encoding.begin(), xfer_encoding.end(),
-                       xfer_encoding.begin(), ::tolower);
-        // Note: is transfer encoding if "identity" is NOT found.
-        return (xfer_encoding.find(IDENTITY) == std::string::npos);
-      }
+      bool is_chunked() const noexcept
+      { return is_chunked_; }
 
       /// Whether the connection should be closed after the response.
       /// @return true if there is a Connection: close header, false otherwise
-      bool close_connection() const
-      {
-        // Find whether there is a connection header.
-        std::string connection(find(header_field::LC_CONNECTION));
-        if (connection.empty())
-          return false;
-
-        std::transform(connection.begin(), connection.end(),
-                       connection.begin(), ::tolower);
-        return (connection.find(CLOSE) != std::string::npos);
-      }
+      bool close_connection() const noexcept
+      { return close_connection_; }
 
       /// Whether the client expects a "100-continue" response.
       /// @return true if there is an Expect: 100-continue header, false
       /// otherwise
-      bool expect_continue() const
-      {
-        // Find whether there is a expect header.
-        std::string expect(find(header_field::LC_EXPECT));
-        if (expect.empty())
-          return false;
+      bool expect_continue() const noexcept
+      { return expect_continue_; }
 
-        std::transform(expect.begin(), expect.end(),
-                       expect.begin(), ::tolower);
-        return (expect.find(CONTINUE) != std::string::npos);
-      }
+      /// Whether there is a Host header field with a value.
+      /// @return true if there is a non-empty Host header, false otherwise
+      bool has_host() const noexcept
+      { return has_host_; }
 
       /// Accessor for the valid flag.
       /// @return the valid flag.
       bool valid() const noexcept
       { return valid_; }
 
+      /// Accessor for the cumulative length of the header field names and
+      /// values.
+      /// @return the length of the message headers.
+      size_t length() const noexcept
+      { return length_; }
+
       /// Accessor for the header fields.
-      /// @return headers as a map
-      const StringMap& fields() const
+      /// @return the header fields collection.
+      const header_fields& fields() const noexcept
       { return fields_; }
       
       /// Output the message_headers as a string.
@@ -416,9 +908,8 @@ namespace via
       std::string to_string() const
       {
         std::string output;
-        for (StringMap::const_iterator
-             iter(fields_.begin()); iter != fields_.end(); ++iter)
-          output += header_field::to_header(iter->first, iter->second);
+        for (auto const& [name, value] : fields_)
+          output += header_field::to_header(name, value);
 
         return output;
       }
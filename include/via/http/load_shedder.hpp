@@ -0,0 +1,179 @@
+#ifndef LOAD_SHEDDER_HPP_VIA_HTTPLIB_
+#define LOAD_SHEDDER_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file load_shedder.hpp
+/// @brief A class to decide when to shed requests from the queueing delay.
+//////////////////////////////////////////////////////////////////////////////
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace via
+{
+  namespace http
+  {
+    /// @enum route_priority the priority of a route when shedding load.
+    enum class route_priority
+    {
+      LOW,    ///< shed whenever the server is overloaded.
+      NORMAL, ///< shed at an increasing rate while the server is overloaded.
+      HIGH    ///< never shed.
+    };
+
+    /// @class load_shedder
+    /// Decides when to shed requests, from samples of the time that work
+    /// waits to be run, using the CoDel (controlled delay) algorithm, see:
+    /// https://queue.acm.org/detail.cfm?id=2209336
+    ///
+    /// The server is overloaded when the minimum delay over an interval is
+    /// above the target, i.e. a queue has persisted for the whole interval,
+    /// not just a burst. It's no longer overloaded when a delay is below the
+    /// target.
+    /// While it's overloaded, all LOW priority requests are shed and NORMAL
+    /// priority requests are shed at a rate that increases with the square
+    /// root of the number shed, like CoDel drops packets, until the delay
+    /// falls. HIGH priority requests are never shed.
+    class load_shedder
+    {
+    public:
+
+      /// The clock of the samples.
+      typedef std::chrono::steady_clock clock;
+
+      /// The default target delay.
+      static constexpr clock::duration DEFAULT_TARGET
+        { std::chrono::milliseconds(5) };
+
+      /// The default interval.
+      static constexpr clock::duration DEFAULT_INTERVAL
+        { std::chrono::milliseconds(100) };
+
+      /// @struct statistics
+      /// A snapshot of the state of a load_shedder.
+      struct statistics
+      {
+        bool overloaded;          ///< whether requests are being shed
+        clock::duration delay;    ///< the minimum delay of the last interval
+        std::uint64_t shed_low;   ///< the number of LOW requests shed
+        std::uint64_t shed_normal;///< the number of NORMAL requests shed
+      };
+
+    private:
+
+      clock::duration target_;                 ///< the target delay
+      clock::duration interval_;               ///< the interval
+      clock::time_point interval_end_{};       ///< the end of this interval
+      clock::duration interval_min_{ clock::duration::max() }; ///< min delay
+      clock::duration last_min_{};             ///< min delay of the last interval
+      bool overloaded_{ false };               ///< whether shedding requests
+      std::uint64_t count_{ 0u };              ///< NORMAL sheds while overloaded
+      clock::time_point next_shed_{};          ///< time of next NORMAL shed
+      std::uint64_t shed_low_{ 0u };           ///< LOW requests shed
+      std::uint64_t shed_normal_{ 0u };        ///< NORMAL requests shed
+      mutable std::mutex mutex_{};             ///< protects the data above
+
+    public:
+
+      /// Constructor.
+      /// @param target the target delay, default 5ms.
+      /// @param interval the interval that the delay must be above the target
+      /// for the server to be overloaded, default 100ms.
+      explicit load_shedder(clock::duration target = DEFAULT_TARGET,
+                            clock::duration interval = DEFAULT_INTERVAL) noexcept
+        : target_(target)
+        , interval_(interval)
+      {}
+
+      /// The target delay.
+      clock::duration target() const noexcept
+      { return target_; }
+
+      /// The interval.
+      clock::duration interval() const noexcept
+      { return interval_; }
+
+      /// Record a sample of the delay.
+      /// @param delay the time that some work waited to be run.
+      /// @param now the time of the sample.
+      void record(clock::duration delay, clock::time_point now = clock::now())
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (delay < interval_min_)
+          interval_min_ = delay;
+
+        // Stop shedding as soon as the delay falls below the target
+        if (delay < target_)
+          overloaded_ = false;
+
+        if (now >= interval_end_)
+        {
+          last_min_ = interval_min_;
+          if (!overloaded_ && (interval_end_ != clock::time_point()) &&
+              (interval_min_ > target_))
+          {
+            overloaded_ = true;
+            count_ = 0u;
+            next_shed_ = now;
+          }
+
+          interval_min_ = clock::duration::max();
+          interval_end_ = now + interval_;
+        }
+      }
+
+      /// Whether to shed a request.
+      /// @param priority the priority of the request's route.
+      /// @param now the time of the request.
+      /// @return true if the request should be shed, false otherwise.
+      bool shed(route_priority priority, clock::time_point now = clock::now())
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!overloaded_ || (priority == route_priority::HIGH))
+          return false;
+
+        if (priority == route_priority::LOW)
+        {
+          ++shed_low_;
+          return true;
+        }
+
+        if (now < next_shed_)
+          return false;
+
+        // The CoDel control law: shed more often the longer it's overloaded
+        ++count_;
+        next_shed_ = now + std::chrono::duration_cast<clock::duration>
+                             (interval_ / std::sqrt(static_cast<double>(count_)));
+        ++shed_normal_;
+        return true;
+      }
+
+      /// Whether requests are being shed.
+      bool is_overloaded() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return overloaded_;
+      }
+
+      /// A snapshot of the state, e.g. to export as metrics.
+      statistics stats() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return { overloaded_, last_min_, shed_low_, shed_normal_ };
+      }
+    };
+  }
+}
+
+#endif
@@ -18,7 +18,12 @@
 #include "response_status.hpp"
 #include "headers.hpp"
 #include "chunk.hpp"
+#include "body_file.hpp"
 #include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 
 namespace via
 {
@@ -68,6 +73,8 @@ namespace via
 
       // Request information
       std::string method_ {};    ///< the request method
+      /// the request method id
+      request_method::id method_id_ { request_method::id::EXTENSION_METHOD };
       std::string uri_ {};       ///< the request uri
       char major_version_ { 0 }; ///< the HTTP major version character
       char minor_version_ { 0 }; ///< the HTTP minor version character
@@ -99,6 +106,7 @@ namespace via
           // If this char is whitespace and method has been read
           else if (std::isblank(c) && !method_.empty())
           {
+            method_id_ = request_method::find_id(method_);
             ws_count_ = 1;
             state_ = Request::URI;
           }
@@ -264,6 +272,7 @@ namespace via
       void clear() noexcept
       {
         method_.clear();
+        method_id_ = request_method::id::EXTENSION_METHOD;
         uri_.clear();
         major_version_ = 0;
         minor_version_ = 0;
@@ -279,6 +288,7 @@ namespace via
       void swap(request_line& other) noexcept
       {
         method_.swap(other.method_);
+        std::swap(method_id_, other.method_id_);
         uri_.swap(other.uri_);
         std::swap(major_version_, other.major_version_);
         std::swap(minor_version_, other.minor_version_);
@@ -317,11 +327,71 @@ namespace via
 #ifdef _MSC_VER
 #pragma warning( pop )
 #endif
-      /// Accessor for the HTTP minor version number.
-      /// @return the minor version number.
+      /// Parse a complete request line in a single pass.
+      /// Note: it only accepts the canonical form of a request line, i.e.:
+      /// method SP uri SP HTTP/d.d CRLF, any other form (or an invalid line)
+      /// is left for the incremental parser to parse or reject.
+      /// @pre the request_line is clear.
+      /// @param line the request line, including its line terminator.
+      /// @return true if parsed ok, false otherwise.
+      bool parse_line(std::string_view line)
+      {
+        // the incremental parser rejects single spaces if MAX_WHITESPACE_CHARS < 2
+        if constexpr (MAX_WHITESPACE_CHARS < 2)
+          return false;
+
+        auto method_end(line.find(' '));
+        if ((method_end == std::string_view::npos) || (method_end == 0u) ||
+            (method_end > MAX_METHOD_LENGTH))
+          return false;
+
+        auto method(line.substr(0u, method_end));
+        if (!std::all_of(method.cbegin(), method.cend(), [](char c)
+            { return std::isupper(static_cast<unsigned char>(c)); }))
+          return false;
+
+        auto uri_start(method_end + 1u);
+        auto uri_end(line.find(' ', uri_start));
+        if ((uri_end == std::string_view::npos) || (uri_end == uri_start) ||
+            (uri_end - uri_start > MAX_URI_LENGTH))
+          return false;
+
+        auto uri(line.substr(uri_start, uri_end - uri_start));
+        if (uri.find_first_of("\t\r\n") != std::string_view::npos)
+          return false;
+
+        // HTTP/d.d followed by the line terminator
+        auto version(line.substr(uri_end + 1u));
+        if ((version.size() < 9u) || (version.compare(0u, 5u, "HTTP/") != 0) ||
+            !std::isdigit(static_cast<unsigned char>(version[5])) ||
+            (version[6] != '.') ||
+            !std::isdigit(static_cast<unsigned char>(version[7])))
+          return false;
+
+        auto terminator(version.substr(8u));
+        if ((terminator != CRLF) && (STRICT_CRLF || (terminator != "\n")))
+          return false;
+
+        method_.assign(method);
+        method_id_ = request_method::find_id(method_);
+        uri_.assign(uri);
+        major_version_ = version[5];
+        minor_version_ = version[7];
+        state_ = Request::VALID;
+        valid_ = true;
+        return valid_;
+      }
+
+      /// Accessor for the request method.
+      /// @return the request method.
       const std::string& method() const noexcept
       { return method_; }
 
+      /// Accessor for the request method id.
+      /// @return the id of a standard method, EXTENSION_METHOD otherwise.
+      request_method::id method_id() const noexcept
+      { return method_id_; }
+
       /// Accessor for the request uri.
       /// @return the request uri string.
       const std::string& uri() const noexcept
@@ -375,6 +445,7 @@ namespace via
                     char major_version = '1',
                     char minor_version = '1') :
         method_(request_method::name(method_id)),
+        method_id_(method_id),
         uri_(uri),
         major_version_(major_version),
         minor_version_(minor_version),
@@ -393,6 +464,7 @@ namespace via
                      char major_version = '1',
                      char minor_version = '1') :
         method_(method),
+        method_id_(request_method::find_id(method)),
         uri_(uri),
         major_version_(major_version),
         minor_version_(minor_version),
@@ -404,7 +476,10 @@ namespace via
       /// Set the request method.
       /// @param method the HTTP request method.
       void set_method(std::string_view method)
-      { method_ = method; }
+      {
+        method_ = method;
+        method_id_ = request_method::find_id(method);
+      }
 
       /// Set the request uri.
       /// @param uri the HTTP request uri.
@@ -421,14 +496,24 @@ namespace via
       void set_minor_version(char minor_version) noexcept
       { minor_version_ = minor_version; }
 
+      /// Append the request line to the output.
+      /// @param output the string to append to.
+      void serialize(std::string& output) const
+      {
+        output.append(method_);
+        output.push_back(' ');
+        output.append(uri_);
+        output.push_back(' ');
+        append_http_version(output, major_version_, minor_version_);
+        output.append(CRLF);
+      }
+
       /// Output as a string.
       /// @return a string containing the request line.
       std::string to_string() const
       {
-        std::string output(method_);
-        output += ' ' + uri_ + ' '
-               + http_version(major_version_, minor_version_)
-               + CRLF;
+        std::string output;
+        serialize(output);
         return output;
       }
     }; // class request_line
@@ -476,6 +561,17 @@ namespace via
       MessageHeaders headers_ {}; ///< the HTTP headers for the request
       bool valid_ { false };       ///< true if the request is valid
 
+      /// Parse a complete request head in a single pass.
+      /// @param head the request line and headers, including the blank line.
+      /// @return true if parsed ok, false otherwise.
+      bool parse_head(std::string_view head)
+      {
+        auto line_end(head.find('\n'));
+        return (line_end != std::string_view::npos) &&
+               request_ln::parse_line(head.substr(0u, line_end + 1u)) &&
+               headers_.parse_block(head.substr(line_end + 1u));
+      }
+
     public:
 
       /// Default Constructor.
@@ -513,6 +609,39 @@ namespace via
       template<typename ForwardIterator>
       bool parse(ForwardIterator& iter, ForwardIterator end)
       {
+        // If the whole head of a new request is in a contiguous buffer,
+        // parse it in a single pass.
+        if constexpr (is_contiguous_char_iterator<ForwardIterator>())
+        {
+          if ((iter != end) &&
+              (request_ln::state() == request_ln::Request::METHOD) &&
+              request_ln::method().empty())
+          {
+            std::string_view buffer(reinterpret_cast<const char*>(&*iter),
+                                    static_cast<size_t>(std::distance(iter, end)));
+            auto head_end(buffer.find(CRLFCRLF));
+            if (head_end != std::string_view::npos)
+            {
+              auto head_size(head_end + std::char_traits<char>::length(CRLFCRLF));
+              if (parse_head(buffer.substr(0u, head_size)))
+              {
+                iter += head_size;
+                valid_ = true;
+                return valid_;
+              }
+
+              // reject headers that are too long or too many immediately
+              if ((headers_.length() > MAX_HEADER_LENGTH) ||
+                  (headers_.fields().size() > MAX_HEADER_NUMBER))
+                return false;
+
+              // otherwise leave the head to the incremental parser
+              request_ln::clear();
+              headers_.clear();
+            }
+          }
+        }
+
         if (!request_ln::valid() && !request_ln::parse(iter, end))
           return false;
 
@@ -558,17 +687,17 @@ namespace via
       /// header field.
       /// @return true if the request should have a host header, false
       /// otherwise
-      bool missing_host_header() const
+      bool missing_host_header() const noexcept
       {
         return request_ln::major_version() == '1' &&
                request_ln::minor_version() == '1' &&
-               headers_.find(header_field::LC_HOST).empty();
+               !headers_.has_host();
       }
 
       /// Whether the client expects a "100-continue" response.
       /// @return true if the server should send a 100-Continue header, false
       /// otherwise
-      bool expect_continue() const
+      bool expect_continue() const noexcept
       {
         return !request_ln::is_http_1_0_or_earlier() &&
                headers_.expect_continue();
@@ -577,12 +706,12 @@ namespace via
       /// Whether the request is "HEAD"
       /// @return true if the request is "HEAD"
       bool is_head() const noexcept
-      { return request_method::HEAD == request_ln::method(); }
+      { return request_method::id::HEAD == request_ln::method_id(); }
 
       /// Whether the request is "TRACE"
       /// @return true if the request is "TRACE"
       bool is_trace() const noexcept
-      { return request_method::TRACE == request_ln::method(); }
+      { return request_method::id::TRACE == request_ln::method_id(); }
     }; // class rx_request
 
     //////////////////////////////////////////////////////////////////////////
@@ -594,6 +723,27 @@ namespace via
       using request_ln = request_line<8190, 8, 8, true>;
 
       std::string header_string_ {}; ///< The headers as a string.
+      bool has_content_length_ { false };   ///< a Content-Length header
+      bool has_transfer_encoding_ { false }; ///< a Transfer-Encoding header
+
+      /// Record whether the header string contains the framing headers.
+      void find_framing_headers()
+      {
+        has_content_length_ = header_field::contains_field
+                    (header_string_, header_field::LC_CONTENT_LENGTH);
+        has_transfer_encoding_ = header_field::contains_field
+                    (header_string_, header_field::LC_TRANSFER_ENCODING);
+      }
+
+      /// Record whether a header is one of the framing headers.
+      /// @param field the header field name.
+      void set_framing_header(std::string_view field) noexcept
+      {
+        if (equal_lowercase(field, header_field::LC_CONTENT_LENGTH))
+          has_content_length_ = true;
+        else if (equal_lowercase(field, header_field::LC_TRANSFER_ENCODING))
+          has_transfer_encoding_ = true;
+      }
 
     public:
 
@@ -615,7 +765,7 @@ namespace via
                   char minor_version = '1') :
         request_ln(method_id, uri, major_version, minor_version),
         header_string_(header_string)
-      {}
+      { find_framing_headers(); }
 
       /// Constructor for creating a request with a non-standard method.
       /// @param method the HTTP request method name
@@ -630,7 +780,7 @@ namespace via
                   char minor_version = '1') :
         request_ln(method, uri, major_version, minor_version),
         header_string_(header_string)
-      {}
+      { find_framing_headers(); }
 
       virtual ~tx_request() {}
 
@@ -639,45 +789,69 @@ namespace via
       /// the following add_header fucntions.
       /// @param header_string the new header string
       void set_header_string(std::string_view header_string)
-      { header_string_ = header_string; }
+      {
+        header_string_ = header_string;
+        find_framing_headers();
+      }
 
       /// Add a standard header to the request.
       /// @see http::header_field::field_id
       /// @param field_id the header field id
       /// @param value the header field value
       void add_header(header_field::id field_id, std::string_view value)
-      { header_string_ += header_field::to_header(field_id, value);  }
+      { add_header(header_field::standard_name(field_id), value); }
 
       /// Add a free form header to the request.
       /// @param field the header field name
       /// @param value the header field value
       void add_header(std::string_view field, std::string_view value)
-      { header_string_ += header_field::to_header(field, value);  }
+      {
+        set_framing_header(field);
+        header_field::append_header(header_string_, field, value);
+      }
 
       /// Add an http content length header line for the given size.
       /// @param size the size of the message body.
       void add_content_length_header(size_t size)
-      { header_string_ += header_field::content_length(size); }
+      {
+        has_content_length_ = true;
+        header_field::append_content_length(header_string_, size);
+      }
 
-      /// The http message header string.
+      /// Whether a Content-Length header has been set.
+      bool has_content_length() const noexcept
+      { return has_content_length_; }
+
+      /// Whether a Transfer-Encoding header has been set.
+      bool has_transfer_encoding() const noexcept
+      { return has_transfer_encoding_; }
+
+      /// Append the http message header to the output.
+      /// Note: the output is appended to, so that a buffer can be reused
+      /// without reallocating its memory.
+      /// @param output the string to append to.
       /// @param content_length the size of the message body for the
       /// content_length header.
-      /// @return The http message header as a std:string.
-      std::string message(size_t content_length = 0) const
+      void serialize(std::string& output, size_t content_length = 0) const
       {
-        std::string output(request_ln::to_string());
-        output += header_string_;
+        request_ln::serialize(output);
+        output.append(header_string_);
 
         // Ensure that it's got a content length header unless
         // a tranfer encoding is being applied.
-        bool no_content_length(std::string::npos == header_string_.find
-              (header_field::HEADER_CONTENT_LENGTH));
-        bool no_transfer_encoding(std::string::npos == header_string_.find
-              (header_field::HEADER_TRANSFER_ENCODING));
-        if (no_content_length && no_transfer_encoding)
-          output += header_field::content_length(content_length);
-        output += CRLF;
+        if (!has_content_length_ && !has_transfer_encoding_)
+          header_field::append_content_length(output, content_length);
+        output.append(CRLF);
+      }
 
+      /// The http message header string.
+      /// @param content_length the size of the message body for the
+      /// content_length header.
+      /// @return The http message header as a std:string.
+      std::string message(size_t content_length = 0) const
+      {
+        std::string output;
+        serialize(output, content_length);
         return output;
       }
     }; // class tx_request
@@ -737,6 +911,9 @@ namespace via
       /// The default maximum size of request content, 1M.
       static constexpr size_t DEFAULT_MAX_CONTENT_LENGTH = 1048576u;
 
+      /// The size of the per-request arena's own buffer, 1K.
+      static constexpr size_t ARENA_SIZE = 1024u;
+
     private:
 
       /// Behaviour
@@ -744,17 +921,125 @@ namespace via
       size_t max_content_length_ { DEFAULT_MAX_CONTENT_LENGTH };
       bool translate_head_ { true };     ///< pass a HEAD request as a GET request.
       bool concatenate_chunks_ { true }; ///< concatenate chunk data into the body
+      bool stream_body_ { false };       ///< pass the body in fragments
+      /// the minimum Content-Length to receive directly into the body,
+      /// zero is disabled.
+      size_t direct_read_threshold_ { 0u };
+      /// the size of body above which it is written to a file,
+      /// zero is disabled.
+      size_t spill_threshold_ { 0u };
+      /// the maximum size of a body written to a file.
+      size_t max_spill_length_ { 0u };
+      std::string spill_directory_ {};   ///< the directory for body files
 
       /// Request information
       Request   request_ {}; ///< the received request
       Chunk     chunk_ {};   ///< the received chunk
       Container body_ {};    ///< the request body or data for the last chunk
+      /// the request body, if it is received directly. It's shared with the
+      /// read into it, see direct_body_owner().
+      std::shared_ptr<Container> direct_buffer_ {};
+      body_file body_file_ {}; ///< the request body, if written to a file
       /// the appropriate response to the request:
       /// either an error code or 100 Continue.
       response_status::code response_code_{ response_status::code::NO_CONTENT };
       bool       continue_sent_ { false };   ///< a 100 Continue response has been sent
       bool       is_head_ { false };         ///< whether it's a HEAD request
 
+      /// The buffer for the per-request arena.
+      alignas(std::max_align_t) std::byte arena_buffer_[ARENA_SIZE] {};
+      /// The per-request arena, released by clear().
+      std::pmr::monotonic_buffer_resource arena_ { arena_buffer_, ARENA_SIZE };
+
+      /// Streamed body information
+      std::string_view fragment_ {};         ///< the latest fragment of the body
+      size_t     body_size_ { 0u };          ///< the size of the body received
+      bool       body_complete_ { false };   ///< the whole body has been received
+      bool       direct_body_ { false };     ///< the body is sized to Content-Length
+
+      /// Take the next fragment of a streamed body from the received data.
+      /// @retval iter an iterator to the beginning of the received data.
+      /// @param end an iterator to the end of the received data.
+      /// @param required the size of the rest of the body.
+      /// @return the fragment of the body in the received data.
+      template<typename ForwardIterator>
+      std::string_view next_fragment(ForwardIterator& iter, ForwardIterator end,
+                                     size_t required)
+      {
+        size_t size(std::min(static_cast<size_t>(std::distance(iter, end)),
+                             required));
+        if (size == 0u)
+          return std::string_view();
+
+        std::string_view fragment(reinterpret_cast<const char*>(&*iter), size);
+        iter += size;
+        body_size_ += size;
+        return fragment;
+      }
+
+      /// Whether a request body is too large.
+      /// A body held in memory is limited to max_content_length_, only a body
+      /// written to a file may be as large as max_spill_length_.
+      /// @param length the size of the body.
+      /// @return true if the body is too large, false otherwise.
+      bool is_body_too_large(size_t length) const noexcept
+      {
+        bool in_file(body_file_.is_open() ||
+                     ((spill_threshold_ > 0u) && (length > spill_threshold_)));
+        return length > (in_file ? std::max(max_content_length_, max_spill_length_)
+                                 : max_content_length_);
+      }
+
+      /// The size of the request body received so far.
+      size_t body_length() const noexcept
+      {
+        if (body_file_.is_open())
+          return body_file_.size();
+        return direct_body_ ? body_size_ : body_.size();
+      }
+
+      /// Move the request body from memory into a file.
+      /// @return true if successful, false otherwise.
+      bool spill_body()
+      {
+        if (!body_file_.open(spill_directory_))
+          return false;
+
+        bool written(body_file_.write
+                      (reinterpret_cast<const char*>(body_.data()), body_.size()));
+        Container().swap(body_);
+        return written;
+      }
+
+      /// Append data to the request body, writing it to a file once it is
+      /// larger than the spill threshold.
+      /// @param first an iterator to the beginning of the data.
+      /// @param last an iterator to the end of the data.
+      /// @return true if successful, false if the file could not be written.
+      template<typename ForwardIterator>
+      bool append_body(ForwardIterator first, ForwardIterator last)
+      {
+        if (first == last)
+          return true;
+
+        if (!body_file_.is_open())
+        {
+          body_.insert(body_.end(), first, last);
+          if ((spill_threshold_ == 0u) || (body_.size() <= spill_threshold_))
+            return true;
+          return spill_body();
+        }
+
+        if constexpr (is_contiguous_char_iterator<ForwardIterator>())
+          return body_file_.write(reinterpret_cast<const char*>(&*first),
+                                  static_cast<size_t>(std::distance(first, last)));
+        else
+        {
+          std::string buffer(first, last);
+          return body_file_.write(buffer.data(), buffer.size());
+        }
+      }
+
     public:
 
       /// Default Constructor
@@ -785,6 +1070,44 @@ namespace via
       void set_concatenate_chunks(bool enable) noexcept
       { concatenate_chunks_ = enable; }
 
+      /// Enable whether request bodies are passed in fragments.
+      /// If enabled, receive returns Rx::HEADERS when the header of a request
+      /// with a body (Content-Length or chunked) has been received and then
+      /// Rx::BODY for each fragment of the body, see fragment().
+      /// Note: the body is not stored and chunks are not concatenated.
+      /// It requires the received data to be in a contiguous buffer, e.g.
+      /// const char*, otherwise the body is received as usual.
+      /// @param enable enable the function.
+      void set_stream_body(bool enable) noexcept
+      { stream_body_ = enable; }
+
+      /// Set the minimum Content-Length of a request body to receive
+      /// directly into the body.
+      /// The body is sized to the Content-Length when the request header has
+      /// been received, so that the rest of the body can be read straight into
+      /// it, see body_space() and body_remaining().
+      /// It requires a Container with contiguous storage, e.g.
+      /// std::vector<char> or std::string.
+      /// @param threshold the minimum Content-Length, zero is disabled.
+      void set_direct_read_threshold(size_t threshold) noexcept
+      { direct_read_threshold_ = threshold; }
+
+      /// Set the size of request body above which it is written to an
+      /// anonymous temporary file instead of being held in memory,
+      /// see spilled_body().
+      /// @param threshold the size of the request body, zero is disabled.
+      /// @param max_length the maximum size of a request body written to
+      /// a file, if it is larger than the maximum content length.
+      /// @param directory the directory in which to create the files,
+      /// default (empty) the system's temporary directory.
+      void set_spill_to_file(size_t threshold, size_t max_length,
+                             std::string const& directory = std::string())
+      {
+        spill_threshold_ = threshold;
+        max_spill_length_ = max_length;
+        spill_directory_ = directory;
+      }
+
       /// set the continue_sent_ flag
       void set_continue_sent() noexcept
       { continue_sent_ = true; }
@@ -795,12 +1118,30 @@ namespace via
       {
         request_.clear();
         chunk_.clear();
+        // release a large body read directly, a read into it may still hold
+        // it, otherwise keep the capacity of the body
+        direct_buffer_.reset();
         body_.clear();
+        body_file_.close();
         // response_code_ is required for response so NOT cleared.
         continue_sent_ = false;
         is_head_ = false;
+        fragment_ = std::string_view();
+        body_size_ = 0u;
+        body_complete_ = false;
+        direct_body_ = false;
+        arena_.release();
       }
 
+      /// The per-request memory resource, e.g. for the route parameters.
+      /// It's a monotonic arena in a buffer in the request_receiver, so the
+      /// memory is only allocated from the heap if the buffer is exhausted.
+      /// Note: it is released by clear(), so it must only be used for objects
+      /// that are destroyed before the request is cleared.
+      /// @return a pointer to the memory resource.
+      std::pmr::memory_resource* resource() noexcept
+      { return &arena_; }
+
       /// Accessor for the is_head flag.
       bool is_head() const noexcept
       { return is_head_; }
@@ -818,12 +1159,71 @@ namespace via
       /// Accessor for the request body / last chunk data.
       /// @return a constant reference to the data.
       Container const& body() const noexcept
-      { return body_; }
+      { return direct_body_ ? *direct_buffer_ : body_; }
+
+      /// Accessor for a request body that has been written to a file.
+      /// @return a constant reference to the file, it is not open if the
+      /// body is in memory, see body().
+      body_file const& spilled_body() const noexcept
+      { return body_file_; }
+
+      /// Accessor for a request body that has been written to a file.
+      /// Note: the file is closed by clear(), unless it is moved from here.
+      /// @return a reference to the file, it is not open if the body is in
+      /// memory, see body().
+      body_file& spilled_body() noexcept
+      { return body_file_; }
 
       /// Accessor for the response code.
       response_status::code response_code() const noexcept
       { return response_code_; }
 
+      /// Accessor for the latest fragment of a streamed body.
+      /// Note: it refers to the received data, so it is only valid until
+      /// the receive buffer is reused.
+      /// @return the fragment of the body received by the last call to
+      /// receive that returned Rx::BODY.
+      std::string_view fragment() const noexcept
+      { return fragment_; }
+
+      /// Whether the whole of a streamed body has been received.
+      /// @return true if fragment() is the last fragment of the body.
+      bool body_complete() const noexcept
+      { return body_complete_; }
+
+      /// The size of the rest of a body that is being received directly.
+      /// @return the number of bytes of the body still to be received,
+      /// zero if the body is not being received directly.
+      size_t body_remaining() const noexcept
+      {
+        return direct_body_ ?
+          static_cast<size_t>(request_.content_length()) - body_size_ : 0u;
+      }
+
+      /// The space in the body for the rest of a body that is being received
+      /// directly: body_remaining() bytes.
+      /// If the data passed to the next call of receive starts here, it is
+      /// not copied.
+      /// @return a pointer to the space in the body, nullptr if the body is
+      /// not being received directly.
+      char* body_space() noexcept
+      {
+        if constexpr (is_contiguous_char_iterator<typename Container::iterator>())
+        {
+          if (direct_body_)
+            return reinterpret_cast<char*>(direct_buffer_->data()) + body_size_;
+        }
+        return nullptr;
+      }
+
+      /// The owner of the space returned by body_space(), to hold while
+      /// reading into it: it's released by clear(), but not freed until
+      /// the read has completed.
+      /// @return a shared pointer to the body, nullptr if the body is not
+      /// being received directly.
+      std::shared_ptr<void> direct_body_owner() const noexcept
+      { return direct_body_ ? direct_buffer_ : std::shared_ptr<void>(); }
+
       /// Create the body of the TRACE response in the request body.
       /// @return the body for a TRACE response.
       Container trace_body()
@@ -833,6 +1233,18 @@ namespace via
         return Container(trace_buffer.begin(), trace_buffer.end());
       }
 
+      /// Whether the body is being passed in fragments.
+      /// @tparam ForwardIterator the type of iterator to the received data.
+      /// @return true if the body is passed in fragments, false otherwise.
+      template<typename ForwardIterator>
+      bool streaming() const noexcept
+      {
+        if constexpr (is_contiguous_char_iterator<ForwardIterator>())
+          return stream_body_;
+        else
+          return false;
+      }
+
       /// Receive data for an HTTP request, body or data chunk.
       /// @param iter an iterator to the beginning of the received data.
       /// @param end an iterator to the end of the received data.
@@ -910,7 +1322,7 @@ namespace via
             if (content_length > 0)
             {
               // test the size
-              if (content_length > static_cast<std::ptrdiff_t>(max_content_length_))
+              if (is_body_too_large(static_cast<size_t>(content_length)))
               {
                 response_code_ = response_status::code::PAYLOAD_TOO_LARGE;
                 clear();
@@ -926,26 +1338,77 @@ namespace via
             }
           }
 
-          // received buffer contains more than the required data
-          std::ptrdiff_t required(content_length -
-                                  static_cast<std::ptrdiff_t>(body_.size()));
-          if (rx_size > required)
+          // pass the body in fragments, straight from the received data
+          if constexpr (is_contiguous_char_iterator<ForwardIterator>())
           {
-              ForwardIterator next(iter + required);
-              body_.insert(body_.end(), iter, next);
-              iter = next;
+            if (stream_body_ && (content_length > 0))
+            {
+              if (request_parsed)
+              {
+                is_head_ = request_.is_head();
+                return Rx::HEADERS;
+              }
+
+              auto length(static_cast<size_t>(content_length));
+              fragment_ = next_fragment(iter, end, length - body_size_);
+              body_complete_ = (body_size_ == length);
+              return fragment_.empty() ? Rx::INCOMPLETE : Rx::BODY;
+            }
           }
-          else // received buffer <= required data
+
+          // write a body larger than the spill threshold straight to a file
+          bool spill(request_parsed && (spill_threshold_ > 0u) &&
+                     (content_length > static_cast<std::ptrdiff_t>(spill_threshold_)));
+          if (spill && !body_file_.open(spill_directory_))
           {
-            if (end > iter)
+            response_code_ = response_status::code::INTERNAL_SERVER_ERROR;
+            clear();
+            return Rx::INVALID;
+          }
+
+          // size a large body to receive the rest of it directly
+          if constexpr (is_contiguous_char_iterator<ForwardIterator>() &&
+              is_contiguous_char_iterator<typename Container::iterator>())
+          {
+            if (request_parsed && !spill && (direct_read_threshold_ > 0u) &&
+                (content_length >= static_cast<std::ptrdiff_t>(direct_read_threshold_)))
+            {
+              direct_buffer_ = std::make_shared<Container>();
+              direct_buffer_->resize(static_cast<size_t>(content_length));
+              direct_body_ = true;
+            }
+
+            if (direct_body_)
             {
-              body_.insert(body_.end(), iter, end);
-              iter = end;
+              auto length(static_cast<size_t>(content_length));
+              size_t size(std::min(static_cast<size_t>(rx_size),
+                                   length - body_size_));
+              char* space(body_space());
+              // the data may have been read directly into the body
+              if ((size > 0u) && (reinterpret_cast<const char*>(&*iter) != space))
+                std::memcpy(space, &*iter, size);
+              iter += size;
+              body_size_ += size;
+            }
+          }
+
+          if (!direct_body_)
+          {
+            // received buffer may contain more than the required data
+            std::ptrdiff_t required(content_length -
+                                    static_cast<std::ptrdiff_t>(body_length()));
+            ForwardIterator next((rx_size > required) ? iter + required : end);
+            if (!append_body(iter, next))
+            {
+              response_code_ = response_status::code::INTERNAL_SERVER_ERROR;
+              clear();
+              return Rx::INVALID;
             }
+            iter = next;
           }
 
           // determine whether the body is complete
-          if (body_.size() == static_cast<size_t>(request_.content_length()))
+          if (body_length() == static_cast<size_t>(request_.content_length()))
           {
             is_head_ = request_.is_head();
             // If enabled, translate a HEAD request to a GET request
@@ -971,11 +1434,79 @@ namespace via
             }
             else
             {
+              if (streaming<ForwardIterator>())
+              {
+                is_head_ = request_.is_head();
+                return Rx::HEADERS;
+              }
+
               if (!concatenate_chunks_)
                 return Rx::VALID;
             }
           }
 
+          // pass the chunk data as fragments, straight from the received data
+          if constexpr (is_contiguous_char_iterator<ForwardIterator>())
+          {
+            if (stream_body_)
+            {
+              // if a parsing error (not run out of data)
+              if (!chunk_.parse(iter, end, fragment_) && (iter != end))
+              {
+                response_code_ = response_status::code::BAD_REQUEST;
+                clear();
+                return Rx::INVALID;
+              }
+
+              body_size_ += fragment_.size();
+              if (body_size_ > max_content_length_)
+              {
+                response_code_ = response_status::code::PAYLOAD_TOO_LARGE;
+                clear();
+                return Rx::INVALID;
+              }
+
+              body_complete_ = chunk_.valid() && chunk_.is_last();
+              return (body_complete_ || !fragment_.empty()) ?
+                      Rx::BODY : Rx::INCOMPLETE;
+            }
+          }
+
+          // concatenate the chunk data straight from the received data
+          if constexpr (is_contiguous_char_iterator<ForwardIterator>())
+          {
+            if (concatenate_chunks_)
+            {
+              std::string_view fragment;
+              // if a parsing error (not run out of data)
+              if (!chunk_.parse(iter, end, fragment) && (iter != end))
+              {
+                response_code_ = response_status::code::BAD_REQUEST;
+                clear();
+                return Rx::INVALID;
+              }
+
+              // Determine whether the total size of the concatenated chunks
+              // is within the maximum body size.
+              if (is_body_too_large(body_length() + fragment.size()))
+              {
+                response_code_ = response_status::code::PAYLOAD_TOO_LARGE;
+                clear();
+                return Rx::INVALID;
+              }
+
+              if (!append_body(fragment.begin(), fragment.end()))
+              {
+                response_code_ = response_status::code::INTERNAL_SERVER_ERROR;
+                clear();
+                return Rx::INVALID;
+              }
+
+              return (chunk_.valid() && chunk_.is_last()) ?
+                      Rx::VALID : Rx::INCOMPLETE;
+            }
+          }
+
           // parse the chunk
           if (!chunk_.parse(iter, end))
           {
@@ -999,15 +1530,19 @@ namespace via
               {
                 // Determine whether the total size of the concatenated chunks
                 // is within the maximum body size.
-                if ((body_.size() + chunk_.data().size()) > max_content_length_)
+                if (is_body_too_large(body_length() + chunk_.data().size()))
                 {
                   response_code_ = response_status::code::PAYLOAD_TOO_LARGE;
                   clear();
                   return Rx::INVALID;
                 }
-                else // concatenate the chunk into the message body
-                  body_.insert(body_.end(),
-                               chunk_.data().begin(), chunk_.data().end());
+                // concatenate the chunk into the message body
+                else if (!append_body(chunk_.data().begin(), chunk_.data().end()))
+                {
+                  response_code_ = response_status::code::INTERNAL_SERVER_ERROR;
+                  clear();
+                  return Rx::INVALID;
+                }
               }
             }
             else
@@ -16,6 +16,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "via/http/request.hpp"
 #include "via/http/response.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,81 @@ namespace via
 {
   namespace http
   {
+    /// @class responder
+    /// Sends the response of a deferred request handler, later and from any
+    /// thread. It may be copied, but only the first response is sent.
+    /// If all of the copies are destroyed without sending a response, an
+    /// Internal Server Error response is sent, so that the connection isn't
+    /// left waiting for it.
+    /// It may hold an owner, e.g. the connection, so that the request stays
+    /// valid until the response is sent or all of the copies are destroyed.
+    template <typename Container>
+    class responder
+    {
+    public:
+
+      /// The function signature to send the response.
+      typedef std::function<void (tx_response response,
+                                  Container body)> SendFunction;
+
+    private:
+
+      /// The state shared by the copies of a responder.
+      struct state
+      {
+        SendFunction send;                         ///< sends the response
+        std::shared_ptr<const void> owner;         ///< held until sent
+        std::atomic_flag sent = ATOMIC_FLAG_INIT;  ///< the response was sent
+
+        state(SendFunction send_function, std::shared_ptr<const void> owner_ptr)
+          : send(std::move(send_function))
+          , owner(std::move(owner_ptr))
+        {}
+
+        ~state()
+        {
+          if (!sent.test_and_set())
+            send(tx_response(response_status::code::INTERNAL_SERVER_ERROR),
+                 Container());
+        }
+      };
+
+      std::shared_ptr<state> state_{}; ///< the shared state, if any
+
+    public:
+
+      /// Default constructor, a responder that can't send a response.
+      responder() = default;
+
+      /// Constructor.
+      /// @param send the function to send the response.
+      /// @param owner an object to hold until the response has been sent or
+      /// all of the copies have been destroyed, default none.
+      explicit responder(SendFunction send,
+                         std::shared_ptr<const void> owner = nullptr)
+        : state_(std::make_shared<state>(std::move(send), std::move(owner)))
+      {}
+
+      /// Whether the responder can send a response.
+      explicit operator bool() const noexcept
+      { return static_cast<bool>(state_); }
+
+      /// Send the response, if it hasn't been sent already.
+      /// @param response the response.
+      /// @param body the response body, default empty.
+      /// @return true if sent, false otherwise.
+      bool operator()(tx_response response, Container body = Container()) const
+      {
+        if (!state_ || state_->sent.test_and_set())
+          return false;
+
+        state_->send(std::move(response), std::move(body));
+        // only the sender may reach here, so the owner can be released
+        state_->owner.reset();
+        return true;
+      }
+    };
+
     /// @class request_handler
     /// An abstract base template class for defining the interface to be
     /// provided by HTTP request handlers.
@@ -51,9 +51,13 @@ namespace via
         PUT,
         DELETE,
         TRACE,
-        CONNECT
+        CONNECT,
+        EXTENSION_METHOD ///< any other (non-standard) method
       };
 
+      /// The number of standard method ids.
+      constexpr size_t NUMBER_OF_IDS{static_cast<size_t>(id::EXTENSION_METHOD)};
+
       /// The standard method name associated with ids above.
       /// @return the standard method name.
       inline const std::string_view name(id method_id) noexcept
@@ -73,6 +77,39 @@ namespace via
         default:          return std::string_view();
         }
       }
+
+      /// Find the id of a method name.
+      /// Note: method names are case sensitive.
+      /// @param method the method name.
+      /// @return the id of a standard method, EXTENSION_METHOD otherwise.
+      constexpr id find_id(std::string_view method) noexcept
+      {
+        switch(method.size())
+        {
+        case 3:
+          if (method == GET)     return id::GET;
+          if (method == PUT)     return id::PUT;
+          break;
+        case 4:
+          if (method == POST)    return id::POST;
+          if (method == HEAD)    return id::HEAD;
+          break;
+        case 5:
+          if (method == TRACE)   return id::TRACE;
+          break;
+        case 6:
+          if (method == DELETE)  return id::DELETE;
+          break;
+        case 7:
+          if (method == OPTIONS) return id::OPTIONS;
+          if (method == CONNECT) return id::CONNECT;
+          break;
+        default:
+          break;
+        }
+
+        return id::EXTENSION_METHOD;
+      }
     }
   }
 }
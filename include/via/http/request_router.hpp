@@ -16,8 +16,16 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "via/http/request_handler.hpp"
 #include "via/http/request_uri.hpp"
+#include "via/http/static_files.hpp"
 #include "via/http/authentication/authentication.hpp"
+#include "via/http/load_shedder.hpp"
+#include "via/thread/worker_pool.hpp"
 #include <map>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <iostream>
 
 namespace via
@@ -25,43 +33,58 @@ namespace via
   namespace http
   {
     /// A map of strings to hold route parameters for the request handlers.
-    typedef std::map<std::string, std::string> Parameters;
+    /// Note: it's allocated from the connection's per-request memory
+    /// resource, so it must not be kept after the handler returns.
+    typedef std::pmr::map<std::pmr::string, std::pmr::string, std::less<>>
+      Parameters;
 
     /// Get the route parameters from the uri_path given the route_path.
     /// @param uri_path the path received in the request_uri.
     /// @param route_path the path in the Route.
+    /// @param resource the memory resource to allocate the parameters from,
+    /// default: the default memory resource.
     /// @return the map of route parameter name:value pairs extracted from the
     /// paths, empty if none or if their was a problem reading the parameters.
-    inline Parameters get_route_parameters(std::string uri_path, std::string route_path)
+    inline Parameters get_route_parameters(std::string_view uri_path,
+                       std::string_view route_path,
+                       std::pmr::memory_resource* resource =
+                         std::pmr::get_default_resource())
     {
-      Parameters parameters;
+      Parameters parameters(resource);
 
       // Find the first ':' in the route_path
       auto param_start(route_path.find(':'));
-      if (param_start != std::string::npos)
+      if ((param_start != std::string_view::npos) &&
+          (param_start <= uri_path.size()))
       {
-        // erase both paths prior to the ':'
-        route_path = route_path.substr(param_start);
-        uri_path   = uri_path.substr(param_start);
+        // ignore both paths prior to the ':'
+        route_path.remove_prefix(param_start);
+        uri_path.remove_prefix(param_start);
 
-        // get the strings between the '/'s
-        const std::vector<std::string> names{split(route_path, '/')};
-        const std::vector<std::string> values{split(uri_path, '/')};
-
-        // get the route_parameter name value pairs
-        if (names.size() == values.size())
+        // compare the strings between the '/'s
+        while (true)
         {
-          for (auto i(0U); i < names.size(); ++i)
+          auto name_end(route_path.find('/'));
+          auto value_end(uri_path.find('/'));
+          std::string_view name(route_path.substr(0, name_end));
+          std::string_view value(uri_path.substr(0, value_end));
+
+          if (!name.empty() && (name[0] == ':'))
+            parameters.emplace(name.substr(1), value); // ignore the ':'
+          else if (name != value)
+            return Parameters(resource);
+
+          // both paths must have the same number of strings
+          if ((name_end == std::string_view::npos) ||
+              (value_end == std::string_view::npos))
           {
-            std::string name(names[i]);
-            if ((name[0] != ':') && (name != values[i]))
-              return Parameters();
-            else
-            {
-              name.erase(0, 1); // ignore the ':'
-              parameters.insert(Parameters::value_type(name, values[i]));
-            }
+            if (name_end != value_end)
+              return Parameters(resource);
+            break;
           }
+
+          route_path.remove_prefix(name_end + 1);
+          uri_path.remove_prefix(value_end + 1);
         }
       }
 
@@ -74,15 +97,28 @@ namespace via
     /// @return the value corresponding to the parameter name, or an empty
     /// string if not found.
     inline std::string get_parameter(Parameters const& params,
-                                     std::string const& name)
+                                     std::string_view name)
     {
       auto iter(params.find(name));
-      return (iter != params.cend()) ? iter->second : std::string();
+      return (iter != params.cend()) ? std::string(iter->second) : std::string();
     }
 
+    /// The maximum number of parameters in a route path.
+    constexpr size_t MAX_ROUTE_PARAMETERS { 16u };
+
     /// @class request_router
     /// The class contains the route paths to search in HTTP requests.
-    /// Note: the routes are searched in the order that they are added.
+    /// The routes are held in a tree of path segments, which is searched
+    /// for a request without allocating memory. At each segment a literal
+    /// match is preferred to a ':' parameter, which is preferred to a '*'
+    /// wildcard.
+    ///
+    /// The routes and the tree are an immutable table, read with
+    /// std::atomic_load. The functions that change the routes copy the
+    /// table, change the copy and publish it with std::atomic_store, so
+    /// routes may be added and removed while requests are being handled on
+    /// other threads. A request is handled by the table that it loaded, which
+    /// is deleted after the last request using it.
     template <typename Container, typename R>
     class request_router : public request_handler<Container, R>
     {
@@ -93,11 +129,26 @@ namespace via
                                          Container const& data,
                                          Container& response_body)> Handler;
 
+      /// The responder of a deferred request handler.
+      typedef responder<Container> Responder;
+
+      /// A deferred HTTP request handler function: it sends the response
+      /// later with the responder, e.g. after waiting for a database.
+      /// Note: the responder holds the connection, so the request and data
+      /// are valid until the response is sent or the responder is destroyed,
+      /// but the parameters must be copied if they're needed after it returns.
+      typedef std::function<void (R const& request,
+                                  Parameters const& parameters,
+                                  Container const& data,
+                                  Responder responder)> DeferredHandler;
+
       /// A request handler with an (optional) authentication object pointer.
       struct AuthenticatedHandler
       {
         Handler handler;
         authentication::authentication const* auth_ptr;
+        /// The deferred handler, if it's not a Handler.
+        DeferredHandler deferred{};
       };
 
       /// A map of handlers
@@ -106,6 +157,13 @@ namespace via
       /// The value_type stored in the map of handlers
       typedef typename MethodHandlers::value_type MethodHandlers_value_type;
 
+      /// An array of handlers indexed by request_method::id.
+      typedef std::array<AuthenticatedHandler, request_method::NUMBER_OF_IDS>
+        StandardHandlers;
+
+      /// A serialized response for a cacheable route.
+      typedef cached_response<Container> CachedResponse;
+
       /// @class Route
       /// The data stored for each route associated with this type of request.
       struct Route
@@ -114,25 +172,111 @@ namespace via
         std::string    path;
         /// The search path upto the first ':' parameter, if any.
         std::string    search_path;
+        /// The names of the ':' parameters and '*' wildcard, in order.
+        std::vector<std::string> parameter_names{};
         /// The map of HTTP methods to request handlers.
         MethodHandlers method_handlers;
+        /// The handlers of the standard methods, indexed by method id.
+        StandardHandlers standard_handlers{};
+        /// The time to cache a GET response for, zero if it's not cached.
+        std::chrono::steady_clock::duration cache_ttl{};
+        /// Whether to add an ETag to GET responses and answer matching
+        /// If-None-Match requests with Not Modified.
+        bool etag{ false };
+        /// The worker pool to run the handlers on, if any.
+        std::shared_ptr<thread::worker_pool> workers{};
+        /// The priority of the route's requests when the server sheds load.
+        route_priority priority{ route_priority::NORMAL };
+        /// The cached GET response, if any.
+        /// Note: it must be accessed with std::atomic_load and atomic_store.
+        mutable std::shared_ptr<const CachedResponse> cached{};
+
+        /// Copy constructor, loads the cached response atomically since
+        /// it may be stored by a request using the Route being copied.
+        Route(Route const& other)
+          : path(other.path)
+          , search_path(other.search_path)
+          , parameter_names(other.parameter_names)
+          , method_handlers(other.method_handlers)
+          , standard_handlers(other.standard_handlers)
+          , cache_ttl(other.cache_ttl)
+          , etag(other.etag)
+          , workers(other.workers)
+          , priority(other.priority)
+          , cached(std::atomic_load(&other.cached))
+        {}
+
+        /// Move constructor.
+        Route(Route&&) = default;
+
+        /// Move assignment operator.
+        Route& operator=(Route&&) = default;
 
         /// Constructor
         Route(std::string const& path_str,
               MethodHandlers_value_type method_handler)
           : path(path_str)
           , search_path(path_str)
-          , method_handlers{method_handler}
+          , method_handlers{}
         {
           // Find the first ':' in the path
           auto param_start(search_path.find(':'));
           if (param_start != std::string::npos)
             search_path.erase(param_start); // delete it and everything after it
+
+          // Find the names of the parameters
+          std::string_view segments(path);
+          while (true)
+          {
+            auto end(segments.find('/'));
+            auto segment(segments.substr(0u, end));
+            if (!segment.empty() && (segment[0] == ':'))
+              parameter_names.emplace_back(segment.substr(1u));
+            else if ((end == std::string_view::npos) &&
+                     !segment.empty() && (segment[0] == '*'))
+              parameter_names.emplace_back(segment.size() > 1u ?
+                                           segment.substr(1u) : segment);
+            if (end == std::string_view::npos)
+              break;
+            segments.remove_prefix(end + 1u);
+          }
+
+          add_handler(method_handler);
         }
 
-        /// Whether the Route has parameters i.e. a ':'
+        /// Add a handler for a method, if the method doesn't have one.
+        /// @param method_handler the method name and handler.
+        void add_handler(MethodHandlers_value_type method_handler)
+        {
+          auto method_id(request_method::find_id(method_handler.first));
+          if (method_handlers.insert(method_handler).second &&
+              (method_id != request_method::id::EXTENSION_METHOD))
+            standard_handlers[static_cast<size_t>(method_id)] =
+              method_handler.second;
+        }
+
+        /// Find the handler for a request method.
+        /// @param method_id the request method id.
+        /// @param method the request method name.
+        /// @return a pointer to the handler, nullptr if not found.
+        AuthenticatedHandler const* find_handler(request_method::id method_id,
+                                        std::string const& method) const
+        {
+          if (method_id != request_method::id::EXTENSION_METHOD)
+          {
+            auto const& method_handler
+              (standard_handlers[static_cast<size_t>(method_id)]);
+            return (method_handler.handler || method_handler.deferred) ?
+              &method_handler : nullptr;
+          }
+
+          auto iter(method_handlers.find(method));
+          return (iter != method_handlers.cend()) ? &iter->second : nullptr;
+        }
+
+        /// Whether the Route has parameters i.e. a ':' or a '*'
         bool has_parameters() const
-        { return path.size() != search_path.size(); }
+        { return !parameter_names.empty(); }
 
         /// The string of methods allowed for a given url
         std::string allowed_methods() const
@@ -156,39 +300,355 @@ namespace via
       /// A collection of routes.
       typedef std::vector<Route> Routes;
 
-      /// A const_iterator to the collection of routes.
-      typedef typename Routes::const_iterator Routes_const_iterator;
+      /// The server's context for routing a request: it passes in the
+      /// responder factory and the load shedder and gets back how the
+      /// request was handled, i.e. a cached response, a route to cache the
+      /// response in, a static file or whether the request was deferred.
+      struct RouteContext
+      {
+        /// The cached response to send instead of the handler's response.
+        std::shared_ptr<const CachedResponse> response{};
+        /// The cacheable route to store the handler's response in,
+        /// see cache_response. It keeps the route's table alive.
+        std::shared_ptr<const Route> route{};
+        /// The body of a static file response, to send from the memory
+        /// mapped file instead of the response body.
+        std::shared_ptr<const file_body> file{};
+        /// Creates the responder for a deferred handler. If it's empty,
+        /// a request for a deferred handler is sent an Internal Server Error.
+        std::function<Responder ()> make_responder{};
+        /// Whether the request was passed to a deferred handler, which
+        /// sends the response with its responder instead.
+        bool deferred{ false };
+        /// The server's load shedder, if any: a request is sent a Service
+        /// Unavailable response if it sheds the request's route priority.
+        load_shedder* shedder{ nullptr };
+      };
+
+      /// A directory of static files and the uri path prefix to serve it on.
+      struct StaticRoute
+      {
+        /// The uri path prefix, ending in '/'.
+        std::string prefix;
+        /// The static files.
+        std::shared_ptr<static_files> files;
+      };
+
 
     private:
 
-      /// The routes to search for an HTTP request.
-      Routes routes_;
+      /// A route index that is not a route.
+      static constexpr size_t NO_ROUTE { static_cast<size_t>(-1) };
+
+      /// A node in the tree of route path segments.
+      struct RouteNode
+      {
+        /// The children for literal segments.
+        std::map<std::string, std::unique_ptr<RouteNode>, std::less<>> literals{};
+        /// The child for a ':' parameter segment, if any.
+        std::unique_ptr<RouteNode> parameter{};
+        /// The index of the route ending in a '*' wildcard here, if any.
+        size_t wildcard{ NO_ROUTE };
+        /// The index of the route ending here, if any.
+        size_t route{ NO_ROUTE };
+      };
+
+      /// The values of the parameters of a route, in order.
+      typedef std::array<std::string_view, MAX_ROUTE_PARAMETERS> ParameterValues;
+
+      /// Add a route to a tree of route path segments.
+      /// Note: if another route has the same segments, it's found instead.
+      /// @param tree the root of the tree.
+      /// @param path the route path.
+      /// @param index the index of the route in the routes.
+      static void insert_route(RouteNode& tree, std::string_view path,
+                               size_t index)
+      {
+        RouteNode* node(&tree);
+        while (true)
+        {
+          auto end(path.find('/'));
+          auto segment(path.substr(0u, end));
+          bool last(end == std::string_view::npos);
+
+          if (last && !segment.empty() && (segment[0] == '*'))
+          {
+            if (node->wildcard == NO_ROUTE)
+              node->wildcard = index;
+            return;
+          }
+
+          if (!segment.empty() && (segment[0] == ':'))
+          {
+            if (!node->parameter)
+              node->parameter = std::make_unique<RouteNode>();
+            node = node->parameter.get();
+          }
+          else
+          {
+            auto iter(node->literals.find(segment));
+            if (iter == node->literals.end())
+              iter = node->literals.emplace(std::string(segment),
+                                            std::make_unique<RouteNode>()).first;
+            node = iter->second.get();
+          }
+
+          if (last)
+          {
+            if (node->route == NO_ROUTE)
+              node->route = index;
+            return;
+          }
+          path.remove_prefix(end + 1u);
+        }
+      }
+
+      /// Search the tree of route path segments for a path.
+      /// @param node the node of the previous segment.
+      /// @param path the rest of the path.
+      /// @param at_end whether all of the path has been matched.
+      /// @retval values the values of the parameters.
+      /// @param count the number of parameter values before this segment.
+      /// @retval found_count the number of parameter values of the route.
+      /// @return the index of the route, NO_ROUTE if not found.
+      static size_t match_route(RouteNode const& node, std::string_view path,
+                                bool at_end, ParameterValues& values,
+                                size_t count, size_t& found_count) noexcept
+      {
+        if (at_end)
+        {
+          found_count = count;
+          return node.route;
+        }
+
+        auto end(path.find('/'));
+        auto segment(path.substr(0u, end));
+        bool last(end == std::string_view::npos);
+        auto rest(last ? std::string_view() : path.substr(end + 1u));
+
+        auto iter(node.literals.find(segment));
+        if (iter != node.literals.end())
+        {
+          auto index(match_route(*iter->second, rest, last, values, count,
+                                 found_count));
+          if (index != NO_ROUTE)
+            return index;
+        }
+
+        if (node.parameter && !segment.empty() && (count < values.size()))
+        {
+          values[count] = segment;
+          auto index(match_route(*node.parameter, rest, last, values,
+                                 count + 1u, found_count));
+          if (index != NO_ROUTE)
+            return index;
+        }
+
+        if ((node.wildcard != NO_ROUTE) && (count < values.size()))
+        {
+          values[count] = path;
+          found_count = count + 1u;
+          return node.wildcard;
+        }
+
+        return NO_ROUTE;
+      }
+
+      /// An immutable version of the routes to search for an HTTP request.
+      struct RouteTable
+      {
+        /// The routes.
+        Routes routes{};
+        /// The tree of route path segments, indexing the routes.
+        RouteNode tree{};
+        /// The static file directories, searched if no route is found.
+        std::vector<StaticRoute> static_routes{};
+
+        /// Default constructor, an empty table.
+        RouteTable() = default;
+
+        /// Copy the routes of a table, without its tree.
+        /// @see build_tree
+        /// @param other the table to copy.
+        RouteTable(RouteTable const& other)
+          : routes(other.routes)
+          , tree{}
+          , static_routes(other.static_routes)
+        {}
+
+        /// Build the tree from the routes.
+        void build_tree()
+        {
+          tree = RouteNode();
+          for (size_t i(0u); i < routes.size(); ++i)
+            insert_route(tree, routes[i].path, i);
+        }
+
+        /// Find a route.
+        /// @param path the uri path of the route.
+        /// @return an iterator to the route, routes.end() if not found.
+        typename Routes::iterator find(std::string_view path)
+        {
+          return std::find_if(routes.begin(), routes.end(),
+                              [path](Route const& route)
+                              { return route.path == path; });
+        }
+      };
+
+      /// The current route table.
+      /// Note: it must be accessed with std::atomic_load and atomic_store.
+      std::shared_ptr<const RouteTable> table_{ std::make_shared<RouteTable>() };
+
+      /// Serialises the changes to the route table.
+      std::mutex update_mutex_{};
+
+      /// Change a copy of the route table and publish it, if changed.
+      /// @param change a function to change the table, it returns whether
+      /// the table was changed.
+      /// @return the result of change.
+      template <typename F>
+      bool update_table(F change)
+      {
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        auto table(std::make_shared<RouteTable>(*std::atomic_load(&table_)));
+        if (!change(*table))
+          return false;
+
+        table->build_tree();
+        std::atomic_store(&table_, std::shared_ptr<const RouteTable>(table));
+        return true;
+      }
+
+      /// Add a strong ETag, the hash of the response body, to a response to
+      /// a GET request. If the request has a matching If-None-Match header,
+      /// the response is changed to Not Modified and the body is discarded.
+      /// Note: the ETag is made weak if the body is compressed when it's sent.
+      /// @param request the HTTP request.
+      /// @retval response the response from the handler.
+      /// @retval response_body the response body from the handler.
+      static void add_etag(R const& request, tx_response& response,
+                           Container& response_body)
+      {
+        if ((request.method_id() != request_method::id::GET) ||
+            (response.status() != static_cast<int>(response_status::code::OK)) ||
+            response.has_transfer_encoding() ||
+            !response.find_header(header_field::LC_ETAG).empty())
+          return;
+
+        auto etag(make_etag(std::string_view(response_body.data(),
+                                             response_body.size())));
+        response.add_header(header_field::id::ETAG, etag);
+
+        auto if_none_match
+          (request.headers().find(header_field::id::IF_NONE_MATCH));
+        if (!if_none_match.empty() && etag_matches(if_none_match, etag))
+        {
+          response.set_status(response_status::code::NOT_MODIFIED);
+          response_body.clear();
+        }
+      }
+
+      /// Respond to a request for a static file.
+      /// @param static_routes the static file directories.
+      /// @param request the HTTP request.
+      /// @param uri_path the http request uri path.
+      /// @retval response_body the body for the HTTP response, if context is
+      /// null.
+      /// @retval context if not null, the file body is returned in context->file.
+      /// @return the response, NOT_FOUND if the path isn't in a static route.
+      static tx_response static_file_response
+                               (std::vector<StaticRoute> const& static_routes,
+                                R const& request,
+                                std::string_view uri_path,
+                                Container& response_body,
+                                RouteContext* context)
+      {
+        for (auto const& route : static_routes)
+        {
+          if (uri_path.substr(0u, route.prefix.size()) != route.prefix)
+            continue;
+
+          if ((request.method_id() != request_method::id::GET) &&
+              (request.method_id() != request_method::id::HEAD))
+          {
+            tx_response response(response_status::code::METHOD_NOT_ALLOWED);
+            response.add_header(header_field::HEADER_ALLOW, "GET, HEAD");
+            return response;
+          }
+
+          std::string path;
+          if (!percent_decode(uri_path.substr(route.prefix.size()), path))
+            return tx_response(response_status::code::NOT_FOUND);
+
+          auto body(std::make_shared<file_body>());
+          tx_response response(route.files->respond(request, path, *body));
+          if (context)
+            context->file = std::move(body);
+          else
+            for (auto const& segment : body->segments)
+              response_body.insert(response_body.end(),
+                                   segment.cbegin(), segment.cend());
+          return response;
+        }
 
-      /// Searches for the request in the routes collection.
+        return tx_response(response_status::code::NOT_FOUND);
+      }
+
+      /// Searches for the request in a route table.
+      /// @param table the route table.
       /// @param uri_path the http request uri path
       /// @retval parameters the route paramters (if any)
-      /// @return a constant iterator to the route in routes_, cend if not found.
-      Routes_const_iterator find_route(std::string const& uri_path,
-                                       Parameters& parameters) const
+      /// @return a pointer to the route in the table, nullptr if not found.
+      static Route const* find_route(RouteTable const& table,
+                                     std::string_view uri_path,
+                                     Parameters& parameters)
+      {
+        ParameterValues values;
+        size_t count(0u);
+        auto index(match_route(table.tree, uri_path, false, values, 0u, count));
+        if (index == NO_ROUTE)
+          return nullptr;
+
+        auto const& route(table.routes[index]);
+        for (size_t i(0u); i < count; ++i)
+          parameters.emplace(route.parameter_names[i], values[i]);
+        return &route;
+      }
+
+      /// Add a method and it's handler to the given path.
+      /// @param method the method name (an uppercase string).
+      /// @param path the uri path.
+      /// @param handler the request handler and authentication.
+      /// @return true if the path is new, false otherwise.
+      bool add_route_handler(std::string_view method, std::string_view path,
+                             AuthenticatedHandler handler)
       {
-        Routes_const_iterator iter(routes_.cbegin());
-        for (; iter != routes_.cend (); ++iter)
+        MethodHandlers_value_type method_handler(std::string(method),
+                                                 std::move(handler));
+        bool is_new_path(false);
+        update_table([&](RouteTable& table)
         {
-          bool found_path(uri_path.find(iter->search_path) != std::string::npos);
-          if (found_path)
+          // Serach for the path in the existing routes
+          auto iter(table.find(path));
+          is_new_path = (iter == table.routes.end());
+          if (!is_new_path)
           {
-            if (iter->has_parameters())
-            {
-              parameters = get_route_parameters(uri_path, iter->path);
-              if (!parameters.empty())
-                break;
-            }
-            else if (uri_path.size() == iter->search_path.size())
-              break;
+            iter->add_handler(method_handler);
+            return true;
           }
-        }
 
-        return iter;
+          Route route(std::string(path), method_handler);
+          if (route.parameter_names.size() > MAX_ROUTE_PARAMETERS)
+          {
+            is_new_path = false;
+            return false;
+          }
+
+          table.routes.push_back(std::move(route));
+          return true;
+        });
+
+        return is_new_path;
       }
 
     public:
@@ -202,28 +662,19 @@ namespace via
 
       /// Add a method and it's handler to the given path.
       /// Creates the path if it's not already got any handlers.
+      /// Note: it may be called while the server is running.
       /// @param method the method name (an uppercase string).
-      /// @param path the uri path. Note: it may contain ':' characters to
-      /// capture paramters from the uri path like Node.js.
+      /// @param path the uri path. Note: it may contain ':' segments to
+      /// capture paramters from the uri path like Node.js and a final '*'
+      /// segment to capture the rest of the path, e.g. "/files/*path".
       /// @param handler the request handler to be called.
       /// @param auth_ptr a shared pointer to an authentication, default nullptr.
-      /// @return true if the path is new, false otherwise.
+      /// @return true if the path is new, false otherwise or if it has more
+      /// than MAX_ROUTE_PARAMETERS parameters.
       bool add_method(std::string_view method, std::string_view path,
                       Handler handler,
                       authentication::authentication const* auth_ptr = nullptr)
-      {
-        // Serach for the path in the existing routes
-        auto iter(std::find(routes_.begin(), routes_.end(), path.data()));
-        bool is_new_path(iter == routes_.end());
-        if (is_new_path)
-          routes_.push_back(Route(std::string(path),
-                    MethodHandlers_value_type(std::string(method), { handler, auth_ptr })));
-        else
-          iter->method_handlers.insert
-              (MethodHandlers_value_type(std::string(method), { handler, auth_ptr }));
-
-        return is_new_path;
-      }
+      { return add_route_handler(method, path, { handler, auth_ptr }); }
 
       /// Add a method and it's handler to the given path.
       /// Creates the path if it's not already got any handlers.
@@ -238,6 +689,61 @@ namespace via
                       authentication::authentication const* auth_ptr = nullptr)
       { return add_method(request_method::name(method_id), path, handler, auth_ptr); }
 
+      /// Add a method and it's deferred handler to the given path.
+      /// Creates the path if it's not already got any handlers.
+      /// The handler is passed a responder to send the response later,
+      /// from any thread, so it doesn't block the connection's thread while
+      /// it waits, e.g. for a database. The responder holds the connection,
+      /// so the request and data stay valid until the response is sent or
+      /// the responder is destroyed, even if the client disconnects. The connection doesn't handle any
+      /// more requests until the response has been sent, so the responses
+      /// are sent in the order of the requests.
+      /// Note: deferred responses aren't cached and don't get ETags.
+      /// @param method the method name (an uppercase string).
+      /// @param path the uri path, see add_method.
+      /// @param handler the deferred request handler to be called.
+      /// @param auth_ptr a shared pointer to an authentication, default nullptr.
+      /// @return true if the path is new, false otherwise.
+      bool add_deferred_method(std::string_view method, std::string_view path,
+                               DeferredHandler handler,
+                               authentication::authentication const* auth_ptr
+                                 = nullptr)
+      { return add_route_handler(method, path, { nullptr, auth_ptr, handler }); }
+
+      /// Add a method and it's deferred handler to the given path.
+      /// @see add_deferred_method
+      /// @param method_id the method id, e.g. request_method::id::GET.
+      /// @param path the uri path, see add_method.
+      /// @param handler the deferred request handler to be called.
+      /// @param auth_ptr a shared pointer to an authentication, default nullptr.
+      /// @return true if the path is new, false otherwise.
+      bool add_deferred_method(request_method::id method_id,
+                               std::string_view path, DeferredHandler handler,
+                               authentication::authentication const* auth_ptr
+                                 = nullptr)
+      {
+        return add_deferred_method(request_method::name(method_id), path,
+                                   handler, auth_ptr);
+      }
+
+      /// Remove the route of a path and all of its handlers.
+      /// Note: it may be called while the server is running, requests that
+      /// have already found the route are still handled by it.
+      /// @param path the uri path of the route.
+      /// @return true if the route was found, false otherwise.
+      bool remove_route(std::string_view path)
+      {
+        return update_table([path](RouteTable& table)
+        {
+          auto iter(table.find(path));
+          if (iter == table.routes.end())
+            return false;
+
+          table.routes.erase(iter);
+          return true;
+        });
+      }
+
       /// The function handle HTTP requests.
       /// It validates the request and routes it to the
       /// @param request the HTTP request.
@@ -249,31 +755,218 @@ namespace via
                                          Container const& request_body,
                                          Container& response_body) const
       {
-        request_uri uri(request.uri());
+        return handle_request(request, request_body, response_body,
+                              std::pmr::get_default_resource());
+      }
+
+      /// Cache the GET responses of a route for a period of time.
+      /// Later GET requests for the route are sent the cached response
+      /// without calling its handler, unless they have a query string.
+      /// Note: it may be called while the server is running.
+      /// @param path the uri path of the route. Note: the route must not have
+      /// any ':' parameters.
+      /// @param ttl the time to cache a response for, zero to stop caching.
+      /// @return true if the route was found, false otherwise.
+      bool set_cacheable(std::string_view path,
+                         std::chrono::steady_clock::duration ttl)
+      {
+        return update_table([path, ttl](RouteTable& table)
+        {
+          auto iter(table.find(path));
+          if ((iter == table.routes.end()) || iter->has_parameters())
+            return false;
+
+          iter->cache_ttl = ttl;
+          iter->cached.reset();
+          return true;
+        });
+      }
+
+      /// Serve the files in a directory on a uri path prefix.
+      /// GET and HEAD requests for paths starting with the prefix, that
+      /// don't match a route, are sent the file at the rest of the path.
+      /// Note: it may be called while the server is running.
+      /// @see static_files
+      /// @param prefix the uri path prefix, e.g. "/static/".
+      /// @param directory the directory containing the files.
+      /// @return the static_files, nullptr if the directory doesn't exist.
+      std::shared_ptr<static_files> add_static_files(std::string_view prefix,
+                                              std::string const& directory)
+      {
+        auto files(std::make_shared<static_files>(directory));
+        if (!files->is_valid())
+          return nullptr;
+
+        std::string path(prefix);
+        if (path.empty() || (path.back() != '/'))
+          path += '/';
+        update_table([&path, &files](RouteTable& table)
+        {
+          table.static_routes.push_back({ std::move(path), files });
+          return true;
+        });
+        return files;
+      }
+
+      /// Add strong ETags to the GET responses of a route.
+      /// The ETag is a 64 bit xxHash of the response body. A request with a
+      /// matching If-None-Match header is sent a Not Modified response
+      /// without the body, instead of the handler's response.
+      /// Note: responses with an ETag header from the handler or a
+      /// Transfer-Encoding are not changed.
+      /// Note: it may be called while the server is running.
+      /// @param path the uri path of the route.
+      /// @param enable whether to add ETags, default true.
+      /// @return true if the route was found, false otherwise.
+      bool set_etag(std::string_view path, bool enable = true)
+      {
+        return update_table([path, enable](RouteTable& table)
+        {
+          auto iter(table.find(path));
+          if (iter == table.routes.end())
+            return false;
+
+          iter->etag = enable;
+          return true;
+        });
+      }
+
+      /// Run the handlers of a route on a worker pool, instead of the
+      /// connection's thread, so that CPU intensive handlers don't stall the
+      /// other connections. The request is deferred: the handler's response
+      /// is posted back to the connection's executor, like a deferred handler.
+      /// If the pool's queue is full, the request is sent a Service
+      /// Unavailable response with a Retry-After header immediately.
+      /// If the handler throws an exception, the request is sent an Internal
+      /// Server Error response.
+      /// Note: the responses of the route aren't cached.
+      /// Note: it may be called while the server is running.
+      /// @param path the uri path of the route.
+      /// @param workers the worker pool, nullptr to run the handlers on the
+      /// connection's thread again.
+      /// @return true if the route was found, false otherwise.
+      bool set_worker_pool(std::string_view path,
+                           std::shared_ptr<thread::worker_pool> workers)
+      {
+        return update_table([path, &workers](RouteTable& table)
+        {
+          auto iter(table.find(path));
+          if (iter == table.routes.end())
+            return false;
+
+          iter->workers = std::move(workers);
+          return true;
+        });
+      }
+
+      /// Set the priority of a route's requests when the server sheds load,
+      /// see http_server::set_load_shedding.
+      /// Note: it may be called while the server is running.
+      /// @param path the uri path of the route.
+      /// @param priority the priority, the default is NORMAL.
+      /// @return true if the route was found, false otherwise.
+      bool set_priority(std::string_view path, route_priority priority)
+      {
+        return update_table([path, priority](RouteTable& table)
+        {
+          auto iter(table.find(path));
+          if (iter == table.routes.end())
+            return false;
+
+          iter->priority = priority;
+          return true;
+        });
+      }
+
+      /// Discard the cached responses.
+      /// Note: it may be called while the server is running.
+      /// @param path the uri path of the route, default all routes.
+      void clear_cache(std::string_view path = std::string_view())
+      {
+        auto table(std::atomic_load(&table_));
+        for (auto const& route : table->routes)
+          if (path.empty() || (route.path == path))
+            std::atomic_store(&route.cached,
+                              std::shared_ptr<const CachedResponse>());
+      }
+
+      /// Cache the response to a GET request for a cacheable route.
+      /// @pre CachedResponse::is_cacheable(response).
+      /// @param route the route from the RouteContext.
+      /// @param response the response from handle_request, with any headers
+      /// that the server adds.
+      /// @param response_body the response body from handle_request.
+      /// @param compression_level the compression level of the precompressed
+      /// variants, default 0: no compressed variants.
+      /// @param compression_threshold the minimum size of body to compress.
+      /// @return the cached response.
+      std::shared_ptr<const CachedResponse> cache_response(Route const& route,
+                                                  tx_response response,
+                                                  Container response_body,
+                                                  int compression_level = 0,
+                                                  size_t compression_threshold
+                                       = content_coding::DEFAULT_THRESHOLD) const
+      {
+        auto cached(std::make_shared<const CachedResponse>
+                      (std::move(response), std::move(response_body),
+                       std::chrono::steady_clock::now() + route.cache_ttl,
+                       compression_level, compression_threshold));
+        std::atomic_store(&route.cached, cached);
+        return cached;
+      }
+
+      /// The function handle HTTP requests.
+      /// It validates the request and routes it to the
+      /// @param request the HTTP request.
+      /// @param request_body the body of the HTTP request.
+      /// @retval response_body the body for the HTTP response.
+      /// @param resource the memory resource to allocate the route parameters
+      /// from, e.g. the connection's per-request arena.
+      /// @retval context if not null, a GET request for a cacheable route is
+      /// looked up in the cache. If the request has a cached response, it is
+      /// returned in context->response and the handler is not called.
+      /// Otherwise context->route is set, so that the response can be cached.
+      /// The body of a static file response is returned in context->file.
+      /// A request for a deferred handler is passed a responder from
+      /// context->make_responder and context->deferred is set.
+      /// If context->shedder sheds the route's priority, the request is sent a
+      /// Service Unavailable response with a Retry-After header.
+      /// @return the response header from the handler or NOT_FOUND if it could
+      /// not find a handler for the request.
+      tx_response handle_request(R const& request,
+                                 Container const& request_body,
+                                 Container& response_body,
+                                 std::pmr::memory_resource* resource,
+                                 RouteContext* context = nullptr) const
+      {
+        request_uri uri(request.uri(), resource);
+        auto table(std::atomic_load(&table_));
 
         // Search for the path and any route parameters associated with it
-        Parameters parameters;
-        auto route_itr(find_route(uri.path(), parameters));
-        if (route_itr == routes_.cend())
-          return tx_response(response_status::code::NOT_FOUND);
+        Parameters parameters(resource);
+        auto route(find_route(*table, uri.path(), parameters));
+        if (!route)
+          return static_file_response(table->static_routes, request,
+                                      uri.path(), response_body, context);
 
         // Search for the method
-        auto methods_iter(route_itr->method_handlers.find(request.method()));
-        if (methods_iter == route_itr->method_handlers.cend())
+        auto method_handler(route->find_handler(request.method_id(),
+                                                request.method()));
+        if (!method_handler)
         {
           // send a METHOD_NOT_ALLOWED response with an ALLOW header
           tx_response response(response_status::code::METHOD_NOT_ALLOWED);
-          response.add_header(header_field::HEADER_ALLOW, route_itr->allowed_methods());
+          response.add_header(header_field::HEADER_ALLOW, route->allowed_methods());
           return response;
         }
         else
         {
           // If this method has authentication
-          if (methods_iter->second.auth_ptr)
+          if (method_handler->auth_ptr)
           {
             // authenticate the request
             std::string challenge
-                (methods_iter->second.auth_ptr->authenticate(request));
+                (method_handler->auth_ptr->authenticate(request));
             if (!challenge.empty())
             {
               // authentication failed, send an UNAUTHORISED response
@@ -283,15 +976,110 @@ namespace via
             }
           }
 
+          // shed the request if the server is overloaded
+          if (context && context->shedder &&
+              context->shedder->shed(route->priority))
+          {
+            tx_response response(response_status::code::SERVICE_UNAVAILABLE);
+            response.add_header(header_field::id::RETRY_AFTER, "1");
+            return response;
+          }
+
+          // pass the request to a deferred handler with a responder
+          if (method_handler->deferred)
+          {
+            if (!context || !context->make_responder)
+              return tx_response(response_status::code::INTERNAL_SERVER_ERROR);
+
+            context->deferred = true;
+            method_handler->deferred(request, parameters, request_body,
+                                     context->make_responder());
+            return tx_response(response_status::code::OK);
+          }
+
+          // pass the request to the route's worker pool with a responder
+          if (route->workers)
+          {
+            if (!context || !context->make_responder)
+              return tx_response(response_status::code::INTERNAL_SERVER_ERROR);
+
+            context->deferred = true;
+            auto responder(context->make_responder());
+            // the responder holds the connection, so the request and its
+            // body stay valid while the task is queued or running, but the
+            // parameters are copied out of the request's memory resource
+            if (!route->workers->try_post([&request, &request_body, responder,
+                                           handler(method_handler->handler),
+                                           etag(route->etag),
+                                           parameters(Parameters(parameters,
+                                             std::pmr::get_default_resource()))]()
+                {
+                  Container response_body;
+                  tx_response response(handler(request, parameters,
+                                               request_body, response_body));
+                  if (etag)
+                    add_etag(request, response, response_body);
+                  responder(std::move(response), std::move(response_body));
+                }))
+            {
+              tx_response response(response_status::code::SERVICE_UNAVAILABLE);
+              response.add_header(header_field::id::RETRY_AFTER, "1");
+              responder(std::move(response));
+            }
+            return tx_response(response_status::code::OK);
+          }
+
+          // look up the response of a cacheable route
+          if (context && (route->cache_ttl.count() > 0) &&
+              (request.method_id() == request_method::id::GET) &&
+              uri.query().empty())
+          {
+            auto cached(std::atomic_load(&route->cached));
+            if (cached && !cached->expired(std::chrono::steady_clock::now()))
+            {
+              if (route->etag && !cached->etag().empty() &&
+                  etag_matches(request.headers().find
+                                 (header_field::id::IF_NONE_MATCH),
+                               cached->etag()))
+              {
+                // send the ETag of the variant that would have been sent
+                auto coding(content_coding::id::IDENTITY);
+                tx_response response(response_status::code::NOT_MODIFIED);
+                if (cached->is_compressed())
+                {
+                  coding = content_coding::negotiate(request.headers().find
+                             (header_field::id::ACCEPT_ENCODING),
+                             cached->available());
+                  response.add_header(header_field::id::VARY,
+                                      header_field::HEADER_ACCEPT_ENCODING);
+                }
+                response.add_header(header_field::id::ETAG,
+                                    cached->etag(coding));
+                return response;
+              }
+
+              context->response = std::move(cached);
+              return tx_response(response_status::code::OK);
+            }
+            context->route = std::shared_ptr<const Route>(table, route);
+          }
+
           // call the registered handler
-          return methods_iter->second.handler(request, parameters,
-                                              request_body, response_body);
+          tx_response response(method_handler->handler(request, parameters,
+                                                 request_body, response_body));
+          if (route->etag)
+            add_etag(request, response, response_body);
+          return response;
         }
       }
 
       /// Accessor for the stored routes
-      Routes const& routes() const
-      { return routes_; }
+      /// @return the routes of the current route table.
+      std::shared_ptr<const Routes> routes() const
+      {
+        auto table(std::atomic_load(&table_));
+        return std::shared_ptr<const Routes>(table, &table->routes);
+      }
     };
   }
 }
@@ -16,19 +16,170 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <string>
 #include <string_view>
+#include <optional>
+#include <memory_resource>
+#include <vector>
+#include <cstring>
 
 namespace via
 {
   namespace http
   {
+    /// The value of a hexadecimal digit.
+    /// @param c the character.
+    /// @return the value of the digit, -1 if c is not a hexadecimal digit.
+    constexpr int hex_value(char c) noexcept
+    {
+      return ((c >= '0') && (c <= '9')) ? c - '0' :
+             ((c >= 'A') && (c <= 'F')) ? c - 'A' + 10 :
+             ((c >= 'a') && (c <= 'f')) ? c - 'a' + 10 : -1;
+    }
+
+    /// Percent decode text in place, see rfc3986 section 2.1.
+    /// The text between escapes is moved in bulk, found with memchr.
+    /// @param data a pointer to the text.
+    /// @param size the size of the text.
+    /// @param plus_as_space decode '+' as a space, as in an html form query.
+    /// @return the size of the decoded text, std::string_view::npos if the
+    /// text contains an invalid escape.
+    inline size_t percent_decode(char* data, size_t size,
+                                 bool plus_as_space = false) noexcept
+    {
+      char* out(data);
+      const char* in(data);
+      const char* end(data + size);
+      while (in != end)
+      {
+        // move the text before the next escape
+        const char* next(static_cast<const char*>
+                           (std::memchr(in, '%', static_cast<size_t>(end - in))));
+        if (!next)
+          next = end;
+
+        size_t length(static_cast<size_t>(next - in));
+        if (out != in)
+          std::memmove(out, in, length);
+
+        if (plus_as_space)
+        {
+          char* plus_end(out + length);
+          for (char* plus(static_cast<char*>(std::memchr(out, '+', length)));
+               plus; plus = static_cast<char*>(std::memchr(plus, '+',
+                                      static_cast<size_t>(plus_end - plus))))
+            *plus = ' ';
+        }
+
+        out += length;
+        in = next;
+        if (in == end)
+          break;
+
+        // decode the escape
+        if ((end - in) < 3)
+          return std::string_view::npos;
+        int high(hex_value(in[1]));
+        int low(hex_value(in[2]));
+        if ((high < 0) || (low < 0))
+          return std::string_view::npos;
+
+        *out++ = static_cast<char>((high << 4) | low);
+        in += 3;
+      }
+
+      return static_cast<size_t>(out - data);
+    }
+
+    /// Percent decode text, appending it to a string.
+    /// @tparam String the type of string, e.g. std::string or std::pmr::string.
+    /// @param input the percent encoded text.
+    /// @retval output the string to append the decoded text to.
+    /// @param plus_as_space decode '+' as a space, as in an html form query.
+    /// @return true if decoded, false if the text contains an invalid escape.
+    template <typename String>
+    bool percent_decode(std::string_view input, String& output,
+                        bool plus_as_space = false)
+    {
+      auto start(output.size());
+      output.append(input.data(), input.size());
+      size_t size(percent_decode(output.data() + start, input.size(),
+                                 plus_as_space));
+      bool valid(size != std::string_view::npos);
+      output.resize(valid ? start + size : start);
+      return valid;
+    }
+
+    /// Compare percent encoded text with decoded text, without decoding it.
+    /// @param encoded the percent encoded text.
+    /// @param text the decoded text.
+    /// @param plus_as_space decode '+' as a space, as in an html form query.
+    /// @return true if the encoded text decodes to text, false otherwise.
+    inline bool percent_equal(std::string_view encoded, std::string_view text,
+                              bool plus_as_space = false) noexcept
+    {
+      // decoding never makes text longer
+      if (encoded.size() < text.size())
+        return false;
+
+      size_t j(0u);
+      for (size_t i(0u); i < encoded.size(); ++j)
+      {
+        if (j == text.size())
+          return false;
+
+        char c(encoded[i]);
+        if (c == '%')
+        {
+          if ((i + 2) >= encoded.size())
+            return false;
+          int high(hex_value(encoded[i + 1]));
+          int low(hex_value(encoded[i + 2]));
+          if ((high < 0) || (low < 0))
+            return false;
+          c = static_cast<char>((high << 4) | low);
+          i += 3;
+        }
+        else
+        {
+          if (plus_as_space && (c == '+'))
+            c = ' ';
+          ++i;
+        }
+
+        if (c != text[j])
+          return false;
+      }
+
+      return j == text.size();
+    }
+
     /// @class request_uri
     /// The class splits a uri contained in an HTTP request into it's parts:
     /// path, query and fragment. See: https://tools.ietf.org/pdf/rfc3986.pdf
+    /// The parts are views of the uri, they are not copied or decoded, so
+    /// the uri must outlive the request_uri. The query parameters are only
+    /// found when they're required, see query_parameters().
     class request_uri
     {
-      std::string path_;     ///< The path of the uri.
-      std::string query_;    ///< The (optional) query of the uri.
-      std::string fragment_; ///< The (optional) fragment of the uri.
+    public:
+
+      /// A query parameter: its percent encoded key and value.
+      struct query_parameter
+      {
+        std::string_view key;   ///< the key of the query parameter.
+        std::string_view value; ///< the value of the query parameter.
+      };
+
+      /// A collection of query parameters.
+      typedef std::pmr::vector<query_parameter> QueryParameters;
+
+    private:
+
+      std::string_view path_;     ///< The path of the uri.
+      std::string_view query_;    ///< The (optional) query of the uri.
+      std::string_view fragment_; ///< The (optional) fragment of the uri.
+      /// The index of the query parameters, created on demand.
+      mutable QueryParameters query_parameters_;
+      mutable bool query_indexed_ { false }; ///< query_parameters_ is valid.
 
     public:
 
@@ -37,26 +188,33 @@ namespace via
       /// It then searches for the query and fragment deleimiters.
       /// If either is found it modifies the path accordingly and sets the
       /// query and fragment with the appropriate text from the uri.
-      /// @param uri the uri from an HTTP request
-      explicit request_uri(std::string_view uri)
-        : path_(uri.data())
+      /// @param uri the uri from an HTTP request, it must outlive the
+      /// request_uri.
+      /// @param resource the memory resource for the query parameter index,
+      /// e.g. the connection's per-request arena, default: the default
+      /// memory resource.
+      explicit request_uri(std::string_view uri,
+                           std::pmr::memory_resource* resource =
+                             std::pmr::get_default_resource())
+        : path_(uri)
         , query_()
         , fragment_()
+        , query_parameters_(resource)
       {
-        auto query_start(path_.find('?'));
-        auto fragment_start(path_.find('#'));
+        auto query_start(uri.find('?'));
+        auto fragment_start(uri.find('#'));
 
-        bool has_fragment(fragment_start != std::string::npos);
+        bool has_fragment(fragment_start != std::string_view::npos);
         bool has_query(query_start < fragment_start);
         if (has_query || has_fragment)
         {
           if (has_query)
           {
-            path_.erase(query_start++);
+            path_ = uri.substr(0, query_start++);
             query_ = uri.substr(query_start, fragment_start - query_start);
           }
           else
-            path_.erase(fragment_start);
+            path_ = uri.substr(0, fragment_start);
 
           if (has_fragment)
             fragment_ = uri.substr(++fragment_start);
@@ -64,16 +222,85 @@ namespace via
       }
 
       /// Accessor for the uri path.
-      std::string const& path() const
+      std::string_view path() const noexcept
       { return path_; }
 
       /// Accessor for the (optional) query.
-      std::string const& query() const
+      std::string_view query() const noexcept
       { return query_; }
 
       /// Accessor for the (optional) fragment.
-      std::string const& fragment() const
+      std::string_view fragment() const noexcept
       { return fragment_; }
+
+      /// The query parameters: the key=value pairs separated by '&' in the
+      /// query. They are found the first time that this function is called.
+      /// Note: it is not thread safe.
+      /// @return the query parameters in the order that they are in the query.
+      QueryParameters const& query_parameters() const
+      {
+        if (!query_indexed_)
+        {
+          query_indexed_ = true;
+          size_t start(0u);
+          while (start < query_.size())
+          {
+            auto end(query_.find('&', start));
+            if (end == std::string_view::npos)
+              end = query_.size();
+
+            // ignore empty query parameters, e.g. "a=1&&b=2"
+            if (end > start)
+            {
+              std::string_view parameter(query_.substr(start, end - start));
+              auto equals(parameter.find('='));
+              if (equals == std::string_view::npos)
+                query_parameters_.push_back({ parameter, std::string_view() });
+              else
+                query_parameters_.push_back({ parameter.substr(0, equals),
+                                              parameter.substr(equals + 1) });
+            }
+
+            start = end + 1;
+          }
+        }
+
+        return query_parameters_;
+      }
+
+      /// Find the value of a query parameter, without allocating memory
+      /// (after the query parameters have been found).
+      /// @param key the decoded key of the query parameter.
+      /// @return the percent encoded value of the first query parameter with
+      /// the key, or std::nullopt if not found.
+      std::optional<std::string_view> find_query(std::string_view key) const
+      {
+        for (auto const& parameter : query_parameters())
+          if (percent_equal(parameter.key, key, true))
+            return parameter.value;
+
+        return std::nullopt;
+      }
+
+      /// Get the decoded value of a query parameter.
+      /// @tparam String the type of string, e.g. std::string or std::pmr::string.
+      /// @param key the decoded key of the query parameter.
+      /// @retval value the string to append the decoded value to.
+      /// @return true if found and decoded, false otherwise.
+      template <typename String>
+      bool query_value(std::string_view key, String& value) const
+      {
+        auto encoded(find_query(key));
+        return encoded && percent_decode(*encoded, value, true);
+      }
+
+      /// Get the decoded path.
+      /// @tparam String the type of string, e.g. std::string or std::pmr::string.
+      /// @retval path the string to append the decoded path to.
+      /// @return true if decoded, false if the path contains an invalid escape.
+      template <typename String>
+      bool decoded_path(String& path) const
+      { return percent_decode(path_, path); }
     };
   }
 }
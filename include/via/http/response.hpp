@@ -17,7 +17,9 @@
 #include "response_status.hpp"
 #include "headers.hpp"
 #include "chunk.hpp"
+#include "compression.hpp"
 #include <algorithm>
+#include <chrono>
 #include <climits>
 
 namespace via
@@ -454,14 +456,36 @@ namespace via
       void set_major_version(char major_version) noexcept
       { major_version_ = major_version; }
 
+      /// Append the response line to the output.
+      /// A standard response uses a precomputed status line.
+      /// @param output the string to append to.
+      void serialize(std::string& output) const
+      {
+        auto status_line(response_status::status_line(status_));
+        if (!status_line.empty() &&
+            (status_line.substr(13u, status_line.size() - 15u) == reason_phrase_))
+        {
+          auto start(output.size());
+          output.append(status_line);
+          output[start + 5u] = major_version_;
+          output[start + 7u] = minor_version_;
+        }
+        else
+        {
+          append_http_version(output, major_version_, minor_version_);
+          output.push_back(' ');
+          append_number(output, static_cast<size_t>(status_));
+          output.push_back(' ');
+          output.append(reason_phrase_).append(CRLF);
+        }
+      }
+
       /// Output as a string.
       /// @return a string containing the response line.
       std::string to_string() const
       {
-        std::string output(http_version(major_version_, minor_version_));
-        output += ' ' + std::to_string(status_)
-                + ' ' + reason_phrase_
-                + CRLF;
+        std::string output;
+        serialize(output);
         return output;
       }
     }; // class response_line
@@ -580,7 +604,7 @@ namespace via
       /// I.e. if the response is HTTP 1.1 and there is not a connection: close
       /// header field.
       /// @return true if it should be kept alive, false otherwise.
-      bool keep_alive() const
+      bool keep_alive() const noexcept
       {
         return !response_ln::is_http_1_0_or_earlier() &&
                !headers_.close_connection();
@@ -596,6 +620,33 @@ namespace via
       using response_ln = response_line<65534, 65534, 254, false>;
 
       std::string header_string_ {}; ///< The headers as a string.
+      bool has_content_length_ { false };   ///< a Content-Length header
+      bool has_transfer_encoding_ { false }; ///< a Transfer-Encoding header
+      bool has_content_encoding_ { false }; ///< a Content-Encoding header
+      bool has_date_ { false };             ///< add the cached Date header
+
+      /// Record whether the header string contains the framing headers.
+      void find_framing_headers()
+      {
+        has_content_length_ = header_field::contains_field
+                    (header_string_, header_field::LC_CONTENT_LENGTH);
+        has_transfer_encoding_ = header_field::contains_field
+                    (header_string_, header_field::LC_TRANSFER_ENCODING);
+        has_content_encoding_ = header_field::contains_field
+                    (header_string_, header_field::LC_CONTENT_ENCODING);
+      }
+
+      /// Record whether a header is one of the framing headers.
+      /// @param field the header field name.
+      void set_framing_header(std::string_view field) noexcept
+      {
+        if (equal_lowercase(field, header_field::LC_CONTENT_LENGTH))
+          has_content_length_ = true;
+        else if (equal_lowercase(field, header_field::LC_TRANSFER_ENCODING))
+          has_transfer_encoding_ = true;
+        else if (equal_lowercase(field, header_field::LC_CONTENT_ENCODING))
+          has_content_encoding_ = true;
+      }
 
     public:
 
@@ -611,7 +662,7 @@ namespace via
                            std::string_view header_string = std::string_view()) :
         response_ln(status_code),
         header_string_(header_string)
-      {}
+      { find_framing_headers(); }
 
       /// Constructor for creating a non-standard response.
       /// @param reason_phrase the reason phrase for the response status.
@@ -622,7 +673,7 @@ namespace via
                             std::string_view header_string = std::string_view()) :
         response_ln(status, reason_phrase),
         header_string_(header_string)
-      {}
+      { find_framing_headers(); }
 
       virtual ~tx_response() {}
 
@@ -635,6 +686,8 @@ namespace via
       bool set_header_string(std::string_view header_string)
       {
         header_string_ = header_string;
+        has_date_ = false;
+        find_framing_headers();
         return !are_headers_split(header_string_);
       }
 
@@ -643,59 +696,294 @@ namespace via
       /// @param field_id the header field id
       /// @param value the header field value
       void add_header(header_field::id field_id, std::string_view value)
-      { header_string_ += header_field::to_header(field_id, value);  }
+      { add_header(header_field::standard_name(field_id), value); }
 
       /// Add a free form header to the response.
       /// @param field the header field name
       /// @param value the header field value
       void add_header(std::string_view field, std::string_view value)
-      { header_string_ += header_field::to_header(field, value);  }
+      {
+        set_framing_header(field);
+        header_field::append_header(header_string_, field, value);
+      }
 
       /// Add an http content length header line for the given size.
       void add_content_length_header(size_t size)
-      { header_string_ += header_field::content_length(size); }
+      {
+        has_content_length_ = true;
+        header_field::append_content_length(header_string_, size);
+      }
 
       /// Add a Date header to the response.
-      void add_date_header()
-      { header_string_ += header_field::date_header(); }
+      /// Note: the current date is taken from header_field::DATE_CACHE when
+      /// the response is serialized, directly after the status line.
+      void add_date_header() noexcept
+      { has_date_ = true; }
 
       /// Add a Server header to the response.
       void add_server_header()
-      { header_string_ += header_field::server_header(); }
+      {
+        header_field::append_header(header_string_, header_field::HEADER_SERVER,
+                                    header_field::SERVER_NAME);
+      }
 
       /// Add a http content header to the response.
       void add_content_http_header()
-      { header_string_ += header_field::content_http_header(); }
+      {
+        header_field::append_header(header_string_,
+                                    header_field::HEADER_CONTENT_TYPE,
+                                    header_field::MESSAGE_HTTP);
+      }
 
       /// Determine whether the response is valid.
       /// @return true if the response does not contain "split headers".
       bool is_valid() const noexcept
       { return !are_headers_split(header_string_); }
 
-      /// The http message header string.
+      /// Whether a Content-Length header has been set.
+      bool has_content_length() const noexcept
+      { return has_content_length_; }
+
+      /// Whether a Transfer-Encoding header has been set.
+      bool has_transfer_encoding() const noexcept
+      { return has_transfer_encoding_; }
+
+      /// Whether a Content-Encoding header has been set.
+      bool has_content_encoding() const noexcept
+      { return has_content_encoding_; }
+
+      /// Find the value of a header that has been added to the response.
+      /// @param lc_name the header field name, in lowercase.
+      /// @return the header value, empty if not found.
+      std::string_view find_header(std::string_view lc_name) const noexcept
+      { return header_field::find_field(header_string_, lc_name); }
+
+      /// Make a strong ETag header weak, since the tag of a body doesn't
+      /// identify it once a content coding has been applied to it.
+      void weaken_etag()
+      {
+        auto etag(find_header(header_field::LC_ETAG));
+        if (!etag.empty() && (etag.front() == '"'))
+          header_string_.insert(static_cast<size_t>
+                                  (etag.data() - header_string_.data()), "W/");
+      }
+
+      /// Whether the response body may be compressed by the server.
+      /// I.e. content is permitted and the application has not set a
+      /// Content-Length or a Content-Encoding header.
+      bool is_compressible() const noexcept
+      {
+        return !has_content_length_ && !has_content_encoding_ &&
+               response_status::content_permitted(status());
+      }
+
+      /// Whether a Date header has been added by add_date_header.
+      bool has_date_header() const noexcept
+      { return has_date_; }
+
+      /// Append the header lines to the output, without the status line or
+      /// the Date header, but with a content length header if required and
+      /// the blank line that ends the message header.
+      /// @param output the string to append to.
       /// @param content_length the size of the message body for the
       /// content_length header.
-      /// @return The http message header as a std:string.
-      std::string message(size_t content_length = 0) const
+      void serialize_headers(std::string& output, size_t content_length) const
       {
-        std::string output(response_ln::to_string());
-        output += header_string_;
+        output.append(header_string_);
 
         // Ensure that it's got a content length header unless
         // a transfer encoding is being applied or content is not permitted
-        bool no_content_length(std::string::npos == header_string_.find
-              (header_field::HEADER_CONTENT_LENGTH));
-        bool no_transfer_encoding(std::string::npos == header_string_.find
-              (header_field::HEADER_TRANSFER_ENCODING));
-        if (no_content_length && no_transfer_encoding &&
+        if (!has_content_length_ && !has_transfer_encoding_ &&
             response_status::content_permitted(status()))
-          output += header_field::content_length(content_length);
-        output += CRLF;
+          header_field::append_content_length(output, content_length);
+        output.append(CRLF);
+      }
 
+      /// Append the http message header to the output.
+      /// Note: the output is appended to, so that a buffer can be reused
+      /// without reallocating its memory.
+      /// @param output the string to append to.
+      /// @param content_length the size of the message body for the
+      /// content_length header.
+      void serialize(std::string& output, size_t content_length = 0) const
+      {
+        response_ln::serialize(output);
+        if (has_date_)
+          header_field::append_date_header(output);
+        serialize_headers(output, content_length);
+      }
+
+      /// The http message header string.
+      /// @param content_length the size of the message body for the
+      /// content_length header.
+      /// @return The http message header as a std:string.
+      std::string message(size_t content_length = 0) const
+      {
+        std::string output;
+        serialize(output, content_length);
         return output;
       }
     }; // class tx_response
 
+    //////////////////////////////////////////////////////////////////////////
+    /// @class cached_response
+    /// A response that has been serialized, so that it can be sent again
+    /// without calling its request handler or formatting it.
+    /// The status line is HTTP/1.1, it's copied with the request's version
+    /// for other requests, and the Date header, if any, is added when the
+    /// response is sent.
+    /// If a compression level is given, the body is also compressed with
+    /// each supported content coding, so that the variant accepted by the
+    /// client can be sent without compressing it again. The ETag of a
+    /// compressed variant is weak.
+    /// Note: it is immutable, so it can be shared between connections.
+    /// @tparam Container std::string or std::vector<char>
+    //////////////////////////////////////////////////////////////////////////
+    template <typename Container>
+    class cached_response
+    {
+      /// The response headers and body for a content coding.
+      struct variant
+      {
+        std::string headers {}; ///< the header lines, except Date
+        std::string etag {};    ///< the ETag header value, if any
+        Container   body {};    ///< the response body
+      };
+
+      std::string status_line_; ///< the status line
+      variant     variants_[content_coding::NUMBER_OF_IDS]; ///< by coding
+      bool        available_[content_coding::NUMBER_OF_IDS]; ///< by coding
+      bool        has_date_;    ///< whether to add a Date header
+      std::chrono::steady_clock::time_point expiry_; ///< the expiry time
+
+    public:
+
+      /// Whether a response may be cached.
+      /// @param response the response.
+      /// @return true if it's a valid OK response without a
+      /// Transfer-Encoding, false otherwise.
+      static bool is_cacheable(tx_response const& response) noexcept
+      {
+        return (response.status() == static_cast<int>(response_status::code::OK))
+            && !response.has_transfer_encoding()
+            && response.is_valid();
+      }
+
+      /// Constructor.
+      /// @pre is_cacheable(response).
+      /// @param response the response.
+      /// @param body the response body.
+      /// @param expiry the time when the response expires.
+      /// @param compression_level the compression level for the compressed
+      /// variants, default 0: no compressed variants.
+      /// @param compression_threshold the minimum size of body to compress.
+      cached_response(tx_response response, Container body,
+                      std::chrono::steady_clock::time_point expiry,
+                      int compression_level = 0,
+                      size_t compression_threshold
+                        = content_coding::DEFAULT_THRESHOLD)
+        : status_line_()
+        , variants_()
+        , available_()
+        , has_date_(response.has_date_header())
+        , expiry_(expiry)
+      {
+        response.set_major_version('1');
+        response.set_minor_version('1');
+        status_line_ = response.to_string();
+
+        bool compress(content_coding::is_supported() &&
+                      (compression_level > 0) &&
+                      (body.size() >= compression_threshold) &&
+                      response.is_compressible());
+        if (compress)
+          response.add_header(header_field::id::VARY,
+                              header_field::HEADER_ACCEPT_ENCODING);
+
+        auto& identity(variants_[0]);
+        identity.etag = response.find_header(header_field::LC_ETAG);
+        identity.body = std::move(body);
+        response.serialize_headers(identity.headers, identity.body.size());
+        available_[0] = true;
+
+        if (compress)
+        {
+          for (size_t i(1u); i < content_coding::NUMBER_OF_IDS; ++i)
+          {
+            auto coding(static_cast<content_coding::id>(i));
+            auto& compressed(variants_[i]);
+            if (content_coding::is_supported(coding) &&
+                http::compress(coding, compression_level, identity.body,
+                               compressed.body) &&
+                (compressed.body.size() < identity.body.size()))
+            {
+              tx_response encoded(response);
+              encoded.add_header(header_field::id::CONTENT_ENCODING,
+                                 content_coding::name(coding));
+              encoded.weaken_etag();
+              compressed.etag = encoded.find_header(header_field::LC_ETAG);
+              encoded.serialize_headers(compressed.headers,
+                                        compressed.body.size());
+              available_[i] = true;
+            }
+            else
+              compressed.body = Container();
+          }
+        }
+      }
+
+      /// Accessor for the HTTP/1.1 status line.
+      std::string const& status_line() const noexcept
+      { return status_line_; }
+
+      /// Accessor for the value of the ETag header, empty if none.
+      /// Note: the tags of the compressed variants are weak.
+      /// @param coding the content coding, default identity.
+      std::string const& etag(content_coding::id coding
+                                = content_coding::id::IDENTITY) const noexcept
+      { return variants_[static_cast<size_t>(coding)].etag; }
+
+      /// Accessor for the header lines, including the blank line.
+      /// @param coding the content coding, default identity.
+      std::string const& headers(content_coding::id coding
+                                   = content_coding::id::IDENTITY) const noexcept
+      { return variants_[static_cast<size_t>(coding)].headers; }
+
+      /// Accessor for the response body.
+      /// @param coding the content coding, default identity.
+      Container const& body(content_coding::id coding
+                              = content_coding::id::IDENTITY) const noexcept
+      { return variants_[static_cast<size_t>(coding)].body; }
+
+      /// Whether each content coding variant is available, indexed by
+      /// content coding id, for content_coding::negotiate.
+      const bool* available() const noexcept
+      { return available_; }
+
+      /// Whether a content coding variant is available.
+      /// @param coding the content coding.
+      bool is_available(content_coding::id coding) const noexcept
+      { return available_[static_cast<size_t>(coding)]; }
+
+      /// Whether any compressed variants are available.
+      bool is_compressed() const noexcept
+      {
+        for (size_t i(1u); i < content_coding::NUMBER_OF_IDS; ++i)
+          if (available_[i])
+            return true;
+        return false;
+      }
+
+      /// Whether a Date header is sent after the status line.
+      bool has_date_header() const noexcept
+      { return has_date_; }
+
+      /// Whether the response has expired.
+      /// @param now the current time.
+      bool expired(std::chrono::steady_clock::time_point now) const noexcept
+      { return expiry_ <= now; }
+    }; // class cached_response
+
     //////////////////////////////////////////////////////////////////////////
     /// @class response_receiver
     /// A template class to receive HTTP responses and any associated data.
@@ -759,6 +1047,7 @@ namespace via
       /// Behaviour
       /// the maximum size of a response body.
       size_t max_body_size_ { LONG_MAX };
+      bool chunk_views_ { false }; ///< refer to chunk data in the received data
 
       /// Response information
       Response  response_ {}; ///< the received response
@@ -784,6 +1073,16 @@ namespace via
         body_()
       {}
 
+      /// Enable whether the data of received chunks is referred to in the
+      /// received data, instead of being copied into the chunk.
+      /// If enabled, use chunk().data_view() instead of chunk().data(), since
+      /// the data is only copied if a chunk is split across received buffers.
+      /// It requires the received data to be in a contiguous buffer, e.g.
+      /// const char*, otherwise the data is copied as usual.
+      /// @param enable enable the function.
+      void set_chunk_views(bool enable) noexcept
+      { chunk_views_ = enable; }
+
       /// clear the response_receiver.
       /// Sets all member variables to their initial state.
       void clear() noexcept
@@ -885,7 +1184,15 @@ namespace via
             return Rx::VALID;
 
           // parse the chunk
-          if (!chunk_.parse(iter, end))
+          bool parsed(false);
+          if constexpr (is_contiguous_char_iterator<ForwardIterator>() &&
+              is_contiguous_char_iterator<typename Container::iterator>())
+            parsed = chunk_views_ ? chunk_.parse_view(iter, end)
+                                  : chunk_.parse(iter, end);
+          else
+            parsed = chunk_.parse(iter, end);
+
+          if (!parsed)
           {
             // if a parsing error (not run out of data)
             if (iter != end)
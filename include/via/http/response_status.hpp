@@ -233,17 +233,168 @@ namespace via
       constexpr std::string_view reason_phrase(int status_code)
       { return reason_phrase(static_cast<code>(status_code)); }
 
+      /// The table of the standard HTTP/1.1 status lines, e.g.
+      /// "HTTP/1.1 200 OK\r\n", indexed by status code.
+      /// Unused entries are empty.
+      struct status_line_table
+      {
+        static constexpr int MIN_STATUS { 100 }; ///< the minimum status code
+        static constexpr int MAX_STATUS { 599 }; ///< the maximum status code
+        static constexpr size_t SIZE { 2048u };  ///< the size of the lines
+
+        char lines[SIZE];  ///< the concatenated status lines
+        unsigned short offsets[MAX_STATUS - MIN_STATUS + 2]; ///< line offsets
+
+        /// Constructor, formats the status lines of the standard responses.
+        constexpr status_line_table()
+          : lines{}
+          , offsets{}
+        {
+          constexpr std::string_view HTTP_1_1 {"HTTP/1.1 "};
+          size_t pos(0u);
+          for (int status(MIN_STATUS); status <= MAX_STATUS; ++status)
+          {
+            offsets[status - MIN_STATUS] = static_cast<unsigned short>(pos);
+            auto reason(reason_phrase(status));
+            if (reason.empty())
+              continue;
+
+            if (pos + HTTP_1_1.size() + reason.size() + 6u > SIZE)
+              throw "response_status::status_line_table is too small";
+
+            for (auto c : HTTP_1_1)
+              lines[pos++] = c;
+            lines[pos++] = static_cast<char>('0' + status / 100);
+            lines[pos++] = static_cast<char>('0' + (status / 10) % 10);
+            lines[pos++] = static_cast<char>('0' + status % 10);
+            lines[pos++] = ' ';
+            for (auto c : reason)
+              lines[pos++] = c;
+            lines[pos++] = '\r';
+            lines[pos++] = '\n';
+          }
+          offsets[MAX_STATUS - MIN_STATUS + 1] = static_cast<unsigned short>(pos);
+        }
+      };
+
+      /// The standard HTTP/1.1 status lines.
+      inline constexpr status_line_table STATUS_LINE_TABLE{};
+
+      /// The standard HTTP/1.1 status line for the response status code,
+      /// including the terminating CRLF.
+      /// @param status_code the response status code.
+      /// @return the status line, empty if not a standard status code.
+      constexpr std::string_view status_line(int status_code) noexcept
+      {
+        if ((status_code < status_line_table::MIN_STATUS) ||
+            (status_code > status_line_table::MAX_STATUS))
+          return std::string_view();
+
+        auto index(status_code - status_line_table::MIN_STATUS);
+        auto offset(STATUS_LINE_TABLE.offsets[index]);
+        return std::string_view(STATUS_LINE_TABLE.lines + offset,
+                          STATUS_LINE_TABLE.offsets[index + 1] - offset);
+      }
+
       /// Whether the response may contain a message body.
       /// See RFC7230 Section 3.3.
       /// @param status_code the reason status code.
       /// @return true if the response may contain a message body,
       /// false otherwise.
-      inline bool content_permitted(int status_code) noexcept
+      constexpr bool content_permitted(int status_code) noexcept
       {
         return (status_code >= static_cast<int>(code::OK))
             && (status_code != static_cast<int>(code::NO_CONTENT))
             && (status_code != static_cast<int>(code::NOT_MODIFIED));
       }
+
+      /// The table of fully serialized responses without headers or a body,
+      /// e.g. "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n",
+      /// for HTTP/1.0 and HTTP/1.1 indexed by status code.
+      /// Unused entries are empty.
+      struct canned_response_table
+      {
+        static constexpr int MIN_STATUS { status_line_table::MIN_STATUS };
+        static constexpr int MAX_STATUS { status_line_table::MAX_STATUS };
+        static constexpr int NUMBER { MAX_STATUS - MIN_STATUS + 1 };
+        static constexpr size_t SIZE { 8192u }; ///< the size of the responses
+
+        char responses[SIZE]; ///< the concatenated responses
+        unsigned short offsets[2 * NUMBER + 1]; ///< response offsets
+
+        /// Constructor, serializes the responses from the status lines.
+        constexpr canned_response_table()
+          : responses{}
+          , offsets{}
+        {
+          constexpr std::string_view CONTENT_LENGTH_0 {"Content-Length: 0\r\n"};
+          size_t pos(0u);
+          for (int minor_version(0); minor_version < 2; ++minor_version)
+          {
+            for (int status(MIN_STATUS); status <= MAX_STATUS; ++status)
+            {
+              offsets[minor_version * NUMBER + status - MIN_STATUS]
+                  = static_cast<unsigned short>(pos);
+              auto status_line(STATUS_LINE_TABLE.lines +
+                               STATUS_LINE_TABLE.offsets[status - MIN_STATUS]);
+              size_t length(STATUS_LINE_TABLE.offsets[status - MIN_STATUS + 1] -
+                            STATUS_LINE_TABLE.offsets[status - MIN_STATUS]);
+              if (length == 0u)
+                continue;
+
+              if (pos + length + CONTENT_LENGTH_0.size() + 2u > SIZE)
+                throw "response_status::canned_response_table is too small";
+
+              auto start(pos);
+              for (size_t i(0u); i < length; ++i)
+                responses[pos++] = status_line[i];
+              responses[start + 7u] = static_cast<char>('0' + minor_version);
+
+              if (content_permitted(status))
+                for (auto c : CONTENT_LENGTH_0)
+                  responses[pos++] = c;
+              responses[pos++] = '\r';
+              responses[pos++] = '\n';
+            }
+          }
+          offsets[2 * NUMBER] = static_cast<unsigned short>(pos);
+        }
+      };
+
+      /// The canned responses.
+      inline constexpr canned_response_table CANNED_RESPONSE_TABLE{};
+
+      /// A fully serialized response without headers or a body, for a
+      /// standard response status code.
+      /// It is for a HTTP/1.0 request if the versions are 1.0, for HTTP/1.1
+      /// if they are 1.1 or not known, e.g. the request line was invalid.
+      /// @param status_code the response status code.
+      /// @param major_version the request's HTTP major version.
+      /// @param minor_version the request's HTTP minor version.
+      /// @return the response, empty if not a standard status code or the
+      /// request is for another HTTP version, e.g. 1.2.
+      constexpr std::string_view canned_response(int status_code,
+                                                 char major_version = '1',
+                                                 char minor_version = '1')
+                                                 noexcept
+      {
+        if ((status_code < canned_response_table::MIN_STATUS) ||
+            (status_code > canned_response_table::MAX_STATUS))
+          return std::string_view();
+
+        bool http_1_0((major_version == '1') && (minor_version == '0'));
+        bool http_1_1((major_version == '1') && (minor_version == '1'));
+        bool known(('0' <= major_version) && (major_version <= '9') &&
+                   ('0' <= minor_version) && (minor_version <= '9'));
+        if (known && !http_1_0 && !http_1_1)
+          return std::string_view();
+
+        auto index((http_1_0 ? 0 : canned_response_table::NUMBER)
+                   + status_code - canned_response_table::MIN_STATUS);
+        auto offset(CANNED_RESPONSE_TABLE.offsets[index]);
+        return std::string_view(CANNED_RESPONSE_TABLE.responses + offset,
+                          CANNED_RESPONSE_TABLE.offsets[index + 1] - offset);
+      }
     }
   }
 }
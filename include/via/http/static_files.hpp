@@ -0,0 +1,774 @@
+#ifndef STATIC_FILES_HPP_VIA_HTTPLIB_
+#define STATIC_FILES_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file static_files.hpp
+/// @brief Contains the static_files class: serves the files in a directory
+/// from a cache of memory mapped files.
+//////////////////////////////////////////////////////////////////////////////
+#include "response.hpp"
+#include "etag.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <filesystem>
+#include <charconv>
+#include <cerrno>
+#include <ctime>
+#include <sys/stat.h>
+
+#if defined _WIN32 || defined WIN32 || defined _WIN64 || defined WIN64 \
+  || defined  WINNT || defined OS_WIN64
+#define VIA_STATIC_FILES_WINDOWS
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#define VIA_STATIC_FILES_INOTIFY
+#include <sys/inotify.h>
+#endif
+
+namespace via
+{
+  namespace http
+  {
+    /// The media type of a file, from its file extension.
+    /// @param path the path of the file.
+    /// @return the media type, "application/octet-stream" if unknown.
+    inline std::string_view content_type(std::string_view path) noexcept
+    {
+      static constexpr std::string_view TYPES[][2]
+      {
+        { "html", "text/html; charset=utf-8" },
+        { "htm",  "text/html; charset=utf-8" },
+        { "css",  "text/css; charset=utf-8" },
+        { "js",   "text/javascript; charset=utf-8" },
+        { "mjs",  "text/javascript; charset=utf-8" },
+        { "json", "application/json" },
+        { "txt",  "text/plain; charset=utf-8" },
+        { "xml",  "application/xml" },
+        { "svg",  "image/svg+xml" },
+        { "png",  "image/png" },
+        { "jpg",  "image/jpeg" },
+        { "jpeg", "image/jpeg" },
+        { "gif",  "image/gif" },
+        { "webp", "image/webp" },
+        { "avif", "image/avif" },
+        { "ico",  "image/vnd.microsoft.icon" },
+        { "woff", "font/woff" },
+        { "woff2","font/woff2" },
+        { "ttf",  "font/ttf" },
+        { "wasm", "application/wasm" },
+        { "pdf",  "application/pdf" },
+        { "zip",  "application/zip" },
+        { "gz",   "application/gzip" },
+        { "mp4",  "video/mp4" },
+        { "webm", "video/webm" },
+        { "mp3",  "audio/mpeg" }
+      };
+
+      auto dot(path.rfind('.'));
+      auto slash(path.rfind('/'));
+      if ((dot != std::string_view::npos) &&
+          ((slash == std::string_view::npos) || (dot > slash)))
+      {
+        auto extension(path.substr(dot + 1u));
+        for (auto const& type : TYPES)
+          if (equal_lowercase(extension, type[0]))
+            return type[1];
+      }
+
+      return "application/octet-stream";
+    }
+
+    /// A range of bytes in a file.
+    struct byte_range
+    {
+      size_t offset; ///< the position of the first byte
+      size_t length; ///< the number of bytes
+    };
+
+    /// The result of parsing a Range header.
+    enum class ranges_status
+    {
+      NONE,         ///< no valid Range header: send the whole file
+      SATISFIABLE,  ///< send the ranges
+      UNSATISFIABLE ///< none of the ranges are in the file
+    };
+
+    /// The maximum number of ranges in a Range header.
+    /// A Range header with more ranges is ignored.
+    constexpr size_t MAX_RANGES { 16u };
+
+    /// Parse a Range header, see RFC7233 section 3.1.
+    /// @param range the value of the Range header.
+    /// @param size the size of the file.
+    /// @retval ranges the satisfiable byte ranges.
+    /// @return the status of the ranges.
+    inline ranges_status parse_ranges(std::string_view range, size_t size,
+                                      std::vector<byte_range>& ranges)
+    {
+      ranges.clear();
+
+      auto trim([](std::string_view text) noexcept
+      {
+        while (!text.empty() && std::isblank(static_cast<unsigned char>(text.front())))
+          text.remove_prefix(1u);
+        while (!text.empty() && std::isblank(static_cast<unsigned char>(text.back())))
+          text.remove_suffix(1u);
+        return text;
+      });
+
+      auto to_number([](std::string_view text, size_t& value) noexcept
+      {
+        auto result(std::from_chars(text.data(), text.data() + text.size(),
+                                    value));
+        return !text.empty() && (result.ec == std::errc()) &&
+               (result.ptr == text.data() + text.size());
+      });
+
+      range = trim(range);
+      if ((range.size() < 6u) || !equal_lowercase(range.substr(0u, 6u), "bytes="))
+        return ranges_status::NONE;
+      range.remove_prefix(6u);
+
+      while (!range.empty())
+      {
+        auto end(range.find(','));
+        auto spec(trim(range.substr(0u, end)));
+        range.remove_prefix((end == std::string_view::npos) ? range.size()
+                                                            : end + 1u);
+        if (spec.empty())
+          continue;
+
+        auto dash(spec.find('-'));
+        if (dash == std::string_view::npos)
+          return ranges_status::NONE;
+        auto first_text(spec.substr(0u, dash));
+        auto last_text(spec.substr(dash + 1u));
+
+        size_t first(0u);
+        size_t last(0u);
+        if (first_text.empty())
+        {
+          // a suffix range: the last bytes of the file
+          if (!to_number(last_text, last))
+            return ranges_status::NONE;
+          if ((last == 0u) || (size == 0u))
+            continue;
+          auto length((last < size) ? last : size);
+          ranges.push_back({ size - length, length });
+        }
+        else
+        {
+          if (!to_number(first_text, first) ||
+              (!last_text.empty() && !to_number(last_text, last)))
+            return ranges_status::NONE;
+          if (last_text.empty() || (last >= size))
+            last = size - 1u;
+          else if (last < first)
+            return ranges_status::NONE;
+          if (first >= size)
+            continue;
+          ranges.push_back({ first, last - first + 1u });
+        }
+
+        if (ranges.size() > MAX_RANGES)
+          return ranges_status::NONE;
+      }
+
+      return ranges.empty() ? ranges_status::UNSATISFIABLE
+                            : ranges_status::SATISFIABLE;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @class static_file
+    /// A file mapped into memory, with the metadata to send it.
+    /// Note: it is immutable, so it can be shared between connections.
+    //////////////////////////////////////////////////////////////////////////
+    class static_file
+    {
+      const char*   data_ { nullptr };  ///< the contents of the file
+      size_t        size_ { 0u };       ///< the size of the file
+      std::time_t   modified_ { 0 };    ///< the last modification time
+      std::string   etag_ {};           ///< the entity tag
+      std::string   last_modified_ {};  ///< the Last-Modified date
+      std::string_view content_type_ {}; ///< the media type
+      struct stat   status_ {};         ///< the status when it was opened
+#ifdef VIA_STATIC_FILES_WINDOWS
+      std::string   contents_ {};       ///< the contents of the file
+#endif
+
+    public:
+
+      /// Default constructor, the file is not open.
+      static_file() = default;
+
+      /// The destructor unmaps the file.
+      ~static_file()
+      {
+#ifndef VIA_STATIC_FILES_WINDOWS
+        if (data_)
+          ::munmap(const_cast<char*>(data_), size_);
+#endif
+      }
+
+      static_file(static_file const&) = delete;
+      static_file& operator=(static_file const&) = delete;
+
+      /// Open a regular file and map it into memory, read only.
+      /// @pre the file is not open.
+      /// @param path the path of the file.
+      /// @return true if the file was opened, false otherwise.
+      bool open(std::string const& path)
+      {
+#ifdef VIA_STATIC_FILES_WINDOWS
+        if ((::stat(path.c_str(), &status_) != 0) ||
+            !(status_.st_mode & S_IFREG))
+          return false;
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+          return false;
+        contents_.assign(std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>());
+        data_ = contents_.data();
+        size_ = contents_.size();
+#else
+        int fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (fd < 0)
+          return false;
+
+        if ((::fstat(fd, &status_) != 0) || !S_ISREG(status_.st_mode))
+        {
+          ::close(fd);
+          return false;
+        }
+
+        size_ = static_cast<size_t>(status_.st_size);
+        if (size_ > 0u)
+        {
+          void* map(::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0));
+          if (map == MAP_FAILED)
+          {
+            ::close(fd);
+            size_ = 0u;
+            return false;
+          }
+          data_ = static_cast<const char*>(map);
+        }
+        ::close(fd);
+#endif
+        modified_ = status_.st_mtime;
+
+        char date[header_field::DATE_LENGTH];
+        header_field::format_date(modified_, date);
+        last_modified_.assign(date, header_field::DATE_LENGTH);
+
+        etag_ = "\"";
+        append_number(etag_, static_cast<size_t>(status_.st_ino), 16);
+        etag_ += '-';
+        append_number(etag_, size_, 16);
+        etag_ += '-';
+        append_number(etag_, static_cast<size_t>(modified_), 16);
+        etag_ += '"';
+
+        content_type_ = http::content_type(path);
+        return true;
+      }
+
+      /// Whether the file has changed since it was opened.
+      /// @param path the path of the file.
+      /// @return true if it has changed or it can't be read, false otherwise.
+      bool is_changed(std::string const& path) const noexcept
+      {
+        struct stat status {};
+        return (::stat(path.c_str(), &status) != 0) ||
+               (status.st_ino   != status_.st_ino)  ||
+               (status.st_size  != status_.st_size) ||
+               (status.st_mtime != status_.st_mtime);
+      }
+
+      /// Accessor for the contents of the file.
+      std::string_view data() const noexcept
+      { return std::string_view(data_, size_); }
+
+      /// Accessor for the size of the file.
+      size_t size() const noexcept
+      { return size_; }
+
+      /// Accessor for the last modification time of the file.
+      std::time_t modified() const noexcept
+      { return modified_; }
+
+      /// Accessor for the entity tag, a strong validator.
+      std::string const& etag() const noexcept
+      { return etag_; }
+
+      /// Accessor for the last modification time as an http date.
+      std::string const& last_modified() const noexcept
+      { return last_modified_; }
+
+      /// Accessor for the media type, from the file extension.
+      std::string_view content_type() const noexcept
+      { return content_type_; }
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @class file_body
+    /// The body of a static file response: the parts of the memory mapped
+    /// file to send and, for a multipart response, the part headers between
+    /// them.
+    /// Note: it can't be copied or moved since the segments refer to the
+    /// part headers, so it should be held in a shared_ptr.
+    //////////////////////////////////////////////////////////////////////////
+    struct file_body
+    {
+      /// The file, it must be held until the body has been sent.
+      std::shared_ptr<const static_file> file {};
+      /// The part headers of a multipart/byteranges body.
+      std::string part_headers {};
+      /// The segments of the body, in order.
+      std::vector<std::string_view> segments {};
+
+      file_body() = default;
+      file_body(file_body const&) = delete;
+      file_body& operator=(file_body const&) = delete;
+
+      /// The total size of the body.
+      size_t size() const noexcept
+      {
+        size_t total(0u);
+        for (auto const& segment : segments)
+          total += segment.size();
+        return total;
+      }
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @class static_files
+    /// Serves the files in a directory.
+    /// The files are mapped into memory when they are first requested and
+    /// kept in a cache, together with their ETag and Last-Modified values.
+    /// On Linux the cached files are invalidated by inotify events when they
+    /// are changed, so a request for a cached file doesn't call stat().
+    /// Otherwise a cached file is checked with stat() for each request.
+    /// Note: files should be replaced by renaming new files over them, since
+    /// truncating a file that is mapped into memory may cause a SIGBUS
+    /// while it's being sent.
+    //////////////////////////////////////////////////////////////////////////
+    class static_files
+    {
+      /// The cache of files, keyed by path relative to the directory.
+      typedef std::unordered_map<std::string, std::shared_ptr<const static_file>>
+        file_cache;
+
+      std::string directory_;   ///< the directory, ending in '/'
+      std::string index_ { "index.html" }; ///< the file for a directory path
+      size_t max_files_ { 1024u };     ///< the maximum number of cached files
+      mutable std::shared_mutex mutex_ {}; ///< protects the cache
+      mutable file_cache files_ {};        ///< the cached files
+      mutable size_t generation_ { 0u };   ///< incremented by invalidations
+#ifdef VIA_STATIC_FILES_INOTIFY
+      int inotify_fd_ { -1 }; ///< the inotify file descriptor
+      /// The watched directories, relative to directory_, by watch descriptor.
+      mutable std::unordered_map<int, std::string> watches_ {};
+      /// The watch descriptors by watched directory.
+      mutable std::unordered_map<std::string, int> watched_ {};
+#endif
+
+      /// Whether a decoded relative path is safe to open, i.e. it doesn't
+      /// contain any ".." segments or characters that the OS may interpret.
+      static bool is_safe_path(std::string_view path) noexcept
+      {
+        if ((path.find('\0') != std::string_view::npos) ||
+            (path.find('\\') != std::string_view::npos) ||
+            (!path.empty() && (path[0] == '/')))
+          return false;
+
+        while (!path.empty())
+        {
+          auto end(path.find('/'));
+          auto segment(path.substr(0u, end));
+          if (segment == "..")
+            return false;
+          if (end == std::string_view::npos)
+            break;
+          path.remove_prefix(end + 1u);
+        }
+        return true;
+      }
+
+      /// Discard the cached files in a directory and its sub-directories.
+      /// @pre the mutex is locked.
+      /// @param directory the directory relative to directory_, ending in '/'.
+      void erase_directory(std::string const& directory) const
+      {
+        for (auto iter(files_.begin()); iter != files_.end(); )
+          if (iter->first.compare(0u, directory.size(), directory) == 0)
+            iter = files_.erase(iter);
+          else
+            ++iter;
+      }
+
+#ifdef VIA_STATIC_FILES_INOTIFY
+      /// Watch a directory for changes, if it's not already watched.
+      /// @pre the mutex is locked.
+      /// @param directory the directory relative to directory_, ending in '/'.
+      /// @return true if the directory is watched, false otherwise.
+      bool watch(std::string const& directory) const
+      {
+        if (watched_.find(directory) != watched_.end())
+          return true;
+
+        int wd(::inotify_add_watch(inotify_fd_,
+                 (directory_ + directory).c_str(),
+                 IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE |
+                 IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                 IN_DELETE_SELF | IN_MOVE_SELF));
+        if (wd < 0)
+          return false;
+
+        watches_[wd] = directory;
+        watched_[directory] = wd;
+        return true;
+      }
+#endif
+
+    public:
+
+      /// Constructor.
+      /// @param directory the directory containing the files to serve.
+      explicit static_files(std::string directory)
+        : directory_(std::move(directory))
+      {
+        if (directory_.empty() || (directory_.back() != '/'))
+          directory_ += '/';
+#ifdef VIA_STATIC_FILES_INOTIFY
+        inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+      }
+
+      /// The destructor closes the inotify file descriptor.
+      ~static_files()
+      {
+#ifdef VIA_STATIC_FILES_INOTIFY
+        if (inotify_fd_ >= 0)
+          ::close(inotify_fd_);
+#endif
+      }
+
+      static_files(static_files const&) = delete;
+      static_files& operator=(static_files const&) = delete;
+
+      /// Whether the directory exists.
+      bool is_valid() const
+      {
+        std::error_code error;
+        return std::filesystem::is_directory(directory_, error);
+      }
+
+      /// Whether cached files are invalidated by file system events.
+      bool is_watching() const noexcept
+      {
+#ifdef VIA_STATIC_FILES_INOTIFY
+        return inotify_fd_ >= 0;
+#else
+        return false;
+#endif
+      }
+
+      /// Set the name of the file to send for a directory path,
+      /// default "index.html".
+      /// @param index the file name.
+      void set_index(std::string index)
+      { index_ = std::move(index); }
+
+      /// Set the maximum number of files to cache, default 1024.
+      /// The cache is cleared when it's full.
+      /// @param max_files the maximum number of files.
+      void set_max_files(size_t max_files) noexcept
+      { max_files_ = max_files; }
+
+      /// Discard the cached files that have changed, from the pending
+      /// file system events.
+      /// Note: it's called by find, so it only needs to be called to release
+      /// the memory of changed files sooner.
+      void process_events() const
+      {
+#ifdef VIA_STATIC_FILES_INOTIFY
+        if (inotify_fd_ < 0)
+          return;
+
+        alignas(struct inotify_event) char buffer[4096];
+        while (true)
+        {
+          auto length(::read(inotify_fd_, buffer, sizeof(buffer)));
+          if (length <= 0)
+          {
+            if ((length < 0) && (errno == EINTR))
+              continue;
+            return;
+          }
+
+          std::unique_lock<std::shared_mutex> lock(mutex_);
+          ++generation_;
+          for (auto next(buffer); next < buffer + length; )
+          {
+            auto event(reinterpret_cast<const struct inotify_event*>(next));
+            next += sizeof(struct inotify_event) + event->len;
+
+            // events may have been lost, so discard everything
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+              files_.clear();
+              continue;
+            }
+
+            auto iter(watches_.find(event->wd));
+            if (iter == watches_.end())
+              continue;
+
+            if (event->len > 0u)
+            {
+              std::string path(iter->second + event->name);
+              files_.erase(path);
+              if (event->mask & IN_ISDIR)
+                erase_directory(path + '/');
+            }
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+              erase_directory(iter->second);
+
+            if (event->mask & IN_IGNORED)
+            {
+              watched_.erase(iter->second);
+              watches_.erase(iter);
+            }
+          }
+        }
+#endif
+      }
+
+      /// Find a file, from the cache if possible.
+      /// @param path the decoded path of the file, relative to the directory.
+      /// The index file is used if it's empty or ends in '/'.
+      /// @return the file, nullptr if the path is invalid or the file can't
+      /// be opened.
+      std::shared_ptr<const static_file> find(std::string_view path) const
+      {
+        if (!is_safe_path(path))
+          return nullptr;
+
+        std::string key(path);
+        if (key.empty() || (key.back() == '/'))
+          key += index_;
+
+        process_events();
+        size_t generation(0u);
+        {
+          std::shared_lock<std::shared_mutex> lock(mutex_);
+          auto iter(files_.find(key));
+          if ((iter != files_.end()) &&
+              (is_watching() || !iter->second->is_changed(directory_ + key)))
+            return iter->second;
+          generation = generation_;
+        }
+
+        bool cacheable(max_files_ > 0u);
+#ifdef VIA_STATIC_FILES_INOTIFY
+        // watch the directory before opening the file, so that no changes
+        // are missed
+        if (is_watching() && cacheable)
+        {
+          auto slash(key.rfind('/'));
+          std::string directory((slash == std::string::npos) ? std::string()
+                                  : key.substr(0u, slash + 1u));
+          std::unique_lock<std::shared_mutex> lock(mutex_);
+          cacheable = watch(directory);
+        }
+#endif
+
+        auto file(std::make_shared<static_file>());
+        if (!file->open(directory_ + key))
+          return nullptr;
+
+        if (cacheable)
+        {
+          std::unique_lock<std::shared_mutex> lock(mutex_);
+          // don't cache the file if it may have changed since it was opened
+          if (generation == generation_)
+          {
+            if (files_.size() >= max_files_)
+              files_.clear();
+            files_[key] = file;
+          }
+        }
+
+        return file;
+      }
+
+      /// Respond to a GET or HEAD request for a file.
+      /// Answers If-None-Match and If-Modified-Since requests with a
+      /// Not Modified response and Range requests with a Partial Content
+      /// response, see RFC7232 and RFC7233.
+      /// @param request the HTTP request.
+      /// @param path the decoded path of the file, relative to the directory.
+      /// @retval body the body of the response.
+      /// @return the response.
+      template <typename R>
+      tx_response respond(R const& request, std::string_view path,
+                          file_body& body) const
+      {
+        auto file(find(path));
+        if (!file)
+          return tx_response(response_status::code::NOT_FOUND);
+
+        auto const& headers(request.headers());
+
+        // Conditional requests
+        bool not_modified(false);
+        auto if_none_match(headers.find(header_field::id::IF_NONE_MATCH));
+        if (!if_none_match.empty())
+          not_modified = etag_matches(if_none_match, file->etag());
+        else
+        {
+          auto if_modified_since
+            (headers.find(header_field::id::IF_MODIFIED_SINCE));
+          if (!if_modified_since.empty())
+          {
+            auto since(header_field::parse_date(if_modified_since));
+            not_modified = (since >= 0) && (file->modified() <= since);
+          }
+        }
+
+        if (not_modified)
+        {
+          tx_response response(response_status::code::NOT_MODIFIED);
+          response.add_header(header_field::id::ETAG, file->etag());
+          response.add_header(header_field::id::LAST_MODIFIED,
+                              file->last_modified());
+          return response;
+        }
+
+        body.file = file;
+        auto data(file->data());
+        tx_response response(response_status::code::OK);
+        response.add_header(header_field::id::ETAG, file->etag());
+        response.add_header(header_field::id::LAST_MODIFIED,
+                            file->last_modified());
+        response.add_header(header_field::id::ACCEPT_RANGES, "bytes");
+
+        // Range requests
+        auto range(headers.find(header_field::id::RANGE));
+        if (!range.empty() &&
+            (request.method_id() == request_method::id::GET))
+        {
+          auto if_range(headers.find(header_field::id::IF_RANGE));
+          std::vector<byte_range> ranges;
+          auto status((if_range.empty() || (if_range == file->etag()) ||
+                       (if_range == file->last_modified())) ?
+                      parse_ranges(range, file->size(), ranges) :
+                      ranges_status::NONE);
+
+          if (status == ranges_status::UNSATISFIABLE)
+          {
+            std::string content_range("bytes */");
+            append_number(content_range, file->size());
+            tx_response unsatisfiable
+              (response_status::code::REQUEST_RANGE_NOT_SATISFIABLE);
+            unsatisfiable.add_header(header_field::id::CONTENT_RANGE,
+                                     content_range);
+            body.file.reset();
+            return unsatisfiable;
+          }
+
+          if (status == ranges_status::SATISFIABLE)
+          {
+            auto append_range([&file](std::string& output, byte_range const& r)
+            {
+              output += "bytes ";
+              append_number(output, r.offset);
+              output += '-';
+              append_number(output, r.offset + r.length - 1u);
+              output += '/';
+              append_number(output, file->size());
+            });
+
+            response.set_status(response_status::code::PARTIAL_CONTENT);
+            if (ranges.size() == 1u)
+            {
+              std::string content_range;
+              append_range(content_range, ranges[0]);
+              response.add_header(header_field::id::CONTENT_RANGE,
+                                  content_range);
+              response.add_header(header_field::id::CONTENT_TYPE,
+                                  file->content_type());
+              body.segments.push_back(data.substr(ranges[0].offset,
+                                                  ranges[0].length));
+              return response;
+            }
+
+            // A multipart/byteranges body, see RFC7233 Appendix A
+            std::string boundary("via_httplib_");
+            boundary.append(file->etag(), 1u, file->etag().size() - 2u);
+            response.add_header(header_field::id::CONTENT_TYPE,
+                                "multipart/byteranges; boundary=" + boundary);
+
+            // build the part headers before taking views of them
+            std::vector<size_t> offsets;
+            for (auto const& r : ranges)
+            {
+              offsets.push_back(body.part_headers.size());
+              body.part_headers.append("\r\n--").append(boundary)
+                               .append("\r\nContent-Type: ")
+                               .append(file->content_type())
+                               .append("\r\nContent-Range: ");
+              append_range(body.part_headers, r);
+              body.part_headers.append("\r\n\r\n");
+            }
+            offsets.push_back(body.part_headers.size());
+            body.part_headers.append("\r\n--").append(boundary).append("--\r\n");
+
+            std::string_view part_headers(body.part_headers);
+            for (size_t i(0u); i < ranges.size(); ++i)
+            {
+              body.segments.push_back(part_headers.substr(offsets[i],
+                                        offsets[i + 1u] - offsets[i]));
+              body.segments.push_back(data.substr(ranges[i].offset,
+                                                  ranges[i].length));
+            }
+            body.segments.push_back(part_headers.substr(offsets.back()));
+            return response;
+          }
+        }
+
+        response.add_header(header_field::id::CONTENT_TYPE,
+                            file->content_type());
+        if (!data.empty())
+          body.segments.push_back(data);
+        return response;
+      }
+    };
+  }
+}
+
+#endif
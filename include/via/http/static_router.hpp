@@ -0,0 +1,302 @@
+#ifndef STATIC_ROUTER_HPP_VIA_HTTPLIB_
+#define STATIC_ROUTER_HPP_VIA_HTTPLIB_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file static_router.hpp
+/// @brief A class to route HTTP requests with a table created at compile time.
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/request_router.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace via
+{
+  namespace http
+  {
+    /// The hash of a route's method and path: FNV-1a with the MurmurHash3
+    /// 64 bit finaliser, so that all of the bits of the hash are mixed.
+    /// @param method the request method, e.g. "GET".
+    /// @param path the uri path.
+    /// @return the hash value.
+    constexpr std::uint64_t route_hash(std::string_view method,
+                                       std::string_view path) noexcept
+    {
+      constexpr std::uint64_t FNV_PRIME { 0x100000001B3ULL };
+
+      std::uint64_t hash(0xCBF29CE484222325ULL);
+      for (auto c : method)
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+      hash = (hash ^ static_cast<unsigned char>(' ')) * FNV_PRIME;
+      for (auto c : path)
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+
+      hash ^= hash >> 33;
+      hash *= 0xFF51AFD7ED558CCDULL;
+      hash ^= hash >> 33;
+      hash *= 0xC4CEB9FE1A85EC53ULL;
+      hash ^= hash >> 33;
+      return hash;
+    }
+
+    /// The slot of a route hash in a table, displaced by a seed.
+    /// @param hash the route hash.
+    /// @param seed the seed of the route's bucket.
+    /// @param mask the size of the table - 1, the size is a power of two.
+    /// @return the slot in the table.
+    constexpr size_t route_slot(std::uint64_t hash, std::uint32_t seed,
+                                size_t mask) noexcept
+    {
+      hash += seed * 0x9E3779B97F4A7C15ULL;
+      hash ^= hash >> 32;
+      hash *= 0xD6E8FEB86659FD93ULL;
+      hash ^= hash >> 32;
+      return static_cast<size_t>(hash) & mask;
+    }
+
+    /// The smallest power of two that is not less than a number.
+    /// @param number the number.
+    /// @return the power of two.
+    constexpr size_t power_of_two(size_t number) noexcept
+    {
+      size_t power(1u);
+      while (power < number)
+        power <<= 1;
+      return power;
+    }
+
+    /// @struct static_route
+    /// A route in a static_router.
+    /// @tparam Container the container for the request and response bodies.
+    /// @tparam R the type of the request, e.g. http_server::http_request.
+    template <typename Container, typename R>
+    struct static_route
+    {
+      /// The request handler: a function, not a std::function, so that the
+      /// route table can be created at compile time.
+      /// Note: a lambda without captures may be converted to it with '+'.
+      typedef tx_response (*Handler)(R const&, //request,
+                                     Parameters const&, //parameters,
+                                     Container const&, //data,
+                                     Container&); //response_body
+
+      std::string_view method; ///< the request method, e.g. "GET".
+      std::string_view path;   ///< the uri path, without parameters.
+      Handler handler;         ///< the request handler.
+    };
+
+    /// @class static_router
+    /// A request router for a fixed set of routes, created at compile time.
+    /// The routes are found with a perfect hash of the method and path
+    /// (hash and displace): the routes are hashed into buckets and a seed is
+    /// found for each bucket that puts its routes in empty slots of the table.
+    /// So a request is routed with one hash of its method and path and one
+    /// comparison, without searching or allocating memory.
+    ///
+    /// Its routes can't have ':' parameters, so the handlers are called with
+    /// empty Parameters and there's no authentication, caching or static files.
+    /// @see make_static_router
+    /// @tparam Container the container for the request and response bodies.
+    /// @tparam R the type of the request, e.g. http_server::http_request.
+    /// @tparam N the number of routes.
+    template <typename Container, typename R, size_t N>
+    class static_router
+    {
+    public:
+
+      /// The type of a route.
+      typedef static_route<Container, R> route_type;
+
+      /// The number of slots in the table: at least twice the number of
+      /// routes, so the seeds are quick to find.
+      static constexpr size_t TABLE_SIZE { power_of_two(2u * N) };
+
+      /// The number of buckets, about two routes per bucket.
+      static constexpr size_t BUCKETS { power_of_two((N + 1u) / 2u) };
+
+      /// The maximum seed to try for a bucket.
+      static constexpr std::uint32_t MAX_SEED { 0xFFFFu };
+
+    private:
+
+      std::array<route_type, N> routes_{};             ///< the routes
+      std::array<std::uint32_t, BUCKETS> seeds_{};     ///< the bucket seeds
+      std::array<std::uint32_t, TABLE_SIZE> slots_{};  ///< route index + 1
+      bool is_valid_{ false };                         ///< the table is valid
+
+      /// Find the seed for a bucket and put its routes in the table.
+      /// @param hashes the hashes of the routes.
+      /// @param bucket the bucket.
+      /// @return true if a seed was found, false otherwise.
+      constexpr bool add_bucket(std::array<std::uint64_t, N> const& hashes,
+                                size_t bucket)
+      {
+        std::array<size_t, N> slots{};
+        for (std::uint32_t seed(0u); seed <= MAX_SEED; ++seed)
+        {
+          bool found(true);
+          size_t count(0u);
+          for (size_t i(0u); found && (i < N); ++i)
+          {
+            if ((hashes[i] & (BUCKETS - 1u)) != bucket)
+              continue;
+
+            auto slot(route_slot(hashes[i], seed, TABLE_SIZE - 1u));
+            found = (slots_[slot] == 0u);
+            for (size_t j(0u); found && (j < count); ++j)
+              found = (slots[j] != slot);
+            slots[count++] = slot;
+          }
+
+          if (found)
+          {
+            seeds_[bucket] = seed;
+            count = 0u;
+            for (size_t i(0u); i < N; ++i)
+              if ((hashes[i] & (BUCKETS - 1u)) == bucket)
+                slots_[slots[count++]] = static_cast<std::uint32_t>(i + 1u);
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+    public:
+
+      /// Constructor, creates the table of routes.
+      /// Note: is_valid should be checked, e.g. with a static_assert.
+      /// @param routes the routes.
+      constexpr explicit static_router(route_type const (&routes)[N])
+      {
+        std::array<std::uint64_t, N> hashes{};
+        for (size_t i(0u); i < N; ++i)
+        {
+          routes_[i] = routes[i];
+          hashes[i] = route_hash(routes[i].method, routes[i].path);
+
+          // A route must have a handler and must not be repeated.
+          if (!routes[i].handler)
+            return;
+          for (size_t j(0u); j < i; ++j)
+            if ((routes[j].method == routes[i].method) &&
+                (routes[j].path == routes[i].path))
+              return;
+        }
+
+        // Count the routes in each bucket
+        std::array<size_t, BUCKETS> sizes{};
+        for (auto hash : hashes)
+          ++sizes[hash & (BUCKETS - 1u)];
+
+        // Add the biggest buckets first, while the table is emptiest
+        for (size_t size(N); size > 0u; --size)
+          for (size_t bucket(0u); bucket < BUCKETS; ++bucket)
+            if ((sizes[bucket] == size) && !add_bucket(hashes, bucket))
+              return;
+
+        is_valid_ = true;
+      }
+
+      /// Whether the table was created: the routes have handlers, aren't
+      /// repeated and a seed was found for every bucket.
+      constexpr bool is_valid() const noexcept
+      { return is_valid_; }
+
+      /// The number of routes.
+      constexpr size_t size() const noexcept
+      { return N; }
+
+      /// Find the route for a method and path.
+      /// @param method the request method.
+      /// @param path the uri path.
+      /// @return a pointer to the route, nullptr if not found.
+      constexpr route_type const* find(std::string_view method,
+                                       std::string_view path) const noexcept
+      {
+        auto hash(route_hash(method, path));
+        auto index(slots_[route_slot(hash, seeds_[hash & (BUCKETS - 1u)],
+                                     TABLE_SIZE - 1u)]);
+        if (index == 0u)
+          return nullptr;
+
+        auto const& route(routes_[index - 1u]);
+        return ((route.method == method) && (route.path == path)) ?
+          &route : nullptr;
+      }
+
+      /// The methods allowed for a path.
+      /// @param path the uri path.
+      /// @return the methods separated by ", ", empty if none.
+      std::string allowed_methods(std::string_view path) const
+      {
+        std::string text;
+        for (auto const& route : routes_)
+          if (route.path == path)
+          {
+            if (!text.empty())
+              text += ", ";
+            text += route.method;
+          }
+        return text;
+      }
+
+      /// Route the request to the handler of its method and path.
+      /// @param request the HTTP request.
+      /// @param request_body the body of the request.
+      /// @retval response_body the body for the response.
+      /// @param resource the memory resource for the request parameters,
+      /// default: the default memory resource.
+      /// @return the response header from the handler, NOT_FOUND if the
+      /// path isn't in the table or METHOD_NOT_ALLOWED if the method isn't.
+      tx_response handle_request(R const& request,
+                                 Container const& request_body,
+                                 Container& response_body,
+                                 std::pmr::memory_resource* resource =
+                                   std::pmr::get_default_resource()) const
+      {
+        request_uri uri(request.uri(), resource);
+        auto route(find(request.method(), uri.path()));
+        if (route)
+          return route->handler(request, Parameters(resource), request_body,
+                                response_body);
+
+        auto allowed(allowed_methods(uri.path()));
+        if (allowed.empty())
+          return tx_response(response_status::code::NOT_FOUND);
+
+        tx_response response(response_status::code::METHOD_NOT_ALLOWED);
+        response.add_header(header_field::HEADER_ALLOW, allowed);
+        return response;
+      }
+    };
+
+    /// Create a static_router, e.g.:
+    /// @code
+    /// static constexpr auto router(make_static_router<std::string, http_request>
+    ///   ({ { "GET", "/status", &get_status },
+    ///      { "POST", "/rpc/add", &post_add } }));
+    /// static_assert(router.is_valid());
+    /// @endcode
+    /// @tparam Container the container for the request and response bodies.
+    /// @tparam R the type of the request, e.g. http_server::http_request.
+    /// @tparam N the number of routes.
+    /// @param routes the routes.
+    /// @return the static_router.
+    template <typename Container, typename R, size_t N>
+    constexpr static_router<Container, R, N>
+      make_static_router(static_route<Container, R> const (&routes)[N])
+    { return static_router<Container, R, N>(routes); }
+  }
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include "via/http/request.hpp"
 #include "via/http/response.hpp"
 #include "via/comms/connection.hpp"
+#include "via/comms/async_operation.hpp"
 #ifdef HTTP_SSL
   #ifdef ASIO_STANDALONE
     #include <asio/ssl/context.hpp>
@@ -160,6 +161,13 @@ namespace via
     ConnectionHandler disconnected_handler_{};  ///< the disconnected callback function
     ConnectionHandler message_sent_handler_{};  ///< the message sent callback function
 
+    /// The pending async_connect operation.
+    comms::async_operation<ASIO_ERROR_CODE> connect_op_{};
+    /// The pending async_request operation.
+    comms::async_operation<ASIO_ERROR_CODE, http_response, Container> request_op_{};
+    http_response op_response_{}; ///< the chunked response of request_op_
+    Container     op_body_{};     ///< the chunks of the response of request_op_
+
     ////////////////////////////////////////////////////////////////////////
     // Functions
 
@@ -235,13 +243,30 @@ namespace via
         switch (rx_state)
         {
         case http::Rx::VALID:
-          http_response_handler_(rx_.response(), rx_.body());
+          if (!request_op_.is_pending())
+            http_response_handler_(rx_.response(), rx_.body());
+          else if (!rx_.response().is_chunked())
+            request_op_.complete(ASIO_ERROR_CODE(), rx_.response(), rx_.body());
+          else // wait for the chunks
+          {
+            op_response_ = rx_.response();
+            op_body_.clear();
+          }
+
           if (!rx_.response().is_chunked())
             rx_.clear();
           break;
 
         case http::Rx::CHUNK:
-          if (http_chunk_handler_)
+          if (request_op_.is_pending())
+          {
+            auto const& data(rx_.chunk().data());
+            op_body_.insert(op_body_.end(), data.begin(), data.end());
+            if (rx_.chunk().is_last())
+              request_op_.complete(ASIO_ERROR_CODE(), std::move(op_response_),
+                                   std::move(op_body_));
+          }
+          else if (http_chunk_handler_)
             http_chunk_handler_(rx_.chunk(), rx_.chunk().data());
 
           if (rx_.chunk().is_last())
@@ -249,7 +274,10 @@ namespace via
           break;
 
         case http::Rx::INVALID:
-          if (http_invalid_handler_)
+          if (request_op_.is_pending())
+            request_op_.complete(ASIO::error::invalid_argument, rx_.response(),
+                                 rx_.body());
+          else if (http_invalid_handler_)
             http_invalid_handler_(rx_.response(), rx_.body());
 
           rx_.clear();
@@ -270,6 +298,10 @@ namespace via
         connection_->close();
       }
 
+      connect_op_.complete(ASIO::error::not_connected);
+      request_op_.complete(ASIO::error::connection_reset, http_response(),
+                           Container());
+
       if (disconnected_handler_)
         disconnected_handler_();
 
@@ -316,6 +348,7 @@ namespace via
         timer_.cancel();
         rx_buffer_.clear();
         rx_.clear();
+        connect_op_.complete(ASIO_ERROR_CODE());
         if (connected_handler_)
           connected_handler_();
         break;
@@ -331,6 +364,23 @@ namespace via
       }
     }
 
+    /// Callback function for a comms::connection error.
+    /// It completes the pending asynchronous operations with the error.
+    /// @param ptr a weak pointer to this http_client.
+    /// @param error the boost error_code.
+    /// @param weak_ptr a weak pointer to the underlying comms connection.
+    static void error_callback(weak_pointer ptr, const ASIO_ERROR_CODE &error,
+                               typename connection_type::weak_pointer weak_ptr)
+    {
+      shared_pointer pointer(ptr.lock());
+      if (pointer)
+      {
+        pointer->connect_op_.complete(error);
+        pointer->request_op_.complete(error, http_response(), Container());
+      }
+      error_handler(error, weak_ptr);
+    }
+
     /// Receive an error from the underlying comms connection.
     /// @param error the boost error_code.
     // @param weak_ptr a weak pointer to the underlying comms connection.
@@ -413,10 +463,10 @@ namespace via
       client_ptr->connection_->set_receive_callback([ptr]
         (const char* data, size_t size, typename connection_type::weak_pointer weak_ptr)
            { receive_callback(ptr, data, size, weak_ptr); });
-      client_ptr->connection_->set_error_callback([]
+      client_ptr->connection_->set_error_callback([ptr]
         (const ASIO_ERROR_CODE &error,
          typename connection_type::weak_pointer weak_ptr)
-           { error_handler(error, weak_ptr); });
+           { error_callback(ptr, error, weak_ptr); });
       client_ptr->connection_->set_event_callback([ptr]
         (unsigned char event, typename connection_type::weak_pointer weak_ptr)
            { event_callback(ptr, event, weak_ptr); });
@@ -515,7 +565,8 @@ namespace via
         return false;
 
       request.add_header(http::header_field::id::HOST, http_host_name());
-      tx_header_ = request.message();
+      tx_header_.clear();
+      request.serialize(tx_header_);
       return send(comms::ConstBuffers(1, ASIO::buffer(tx_header_)));
     }
 
@@ -528,7 +579,8 @@ namespace via
         return false;
 
       request.add_header(http::header_field::id::HOST, http_host_name());
-      tx_header_ = request.message(body.size());
+      tx_header_.clear();
+      request.serialize(tx_header_, body.size());
       comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
 
       tx_body_.swap(body);
@@ -547,7 +599,8 @@ namespace via
         return false;
 
       request.add_header(http::header_field::id::HOST, http_host_name());
-      tx_header_ = request.message(ASIO::buffer_size(buffers));
+      tx_header_.clear();
+      request.serialize(tx_header_, ASIO::buffer_size(buffers));
 
       buffers.push_front(ASIO::buffer(tx_header_));
       return send(std::move(buffers));
@@ -597,12 +650,13 @@ namespace via
 
       size_t size(chunk.size());
       chunk_header_type chunk_header(size, extension);
-      tx_header_ = chunk_header.to_string();
+      tx_header_.clear();
+      chunk_header.serialize(tx_header_);
       tx_body_.swap(chunk);
 
       comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
       buffers.push_back(ASIO::buffer(tx_body_));
-      buffers.push_back(ASIO::buffer(http::CRLF));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
       return send(std::move(buffers));
     }
 
@@ -621,9 +675,10 @@ namespace via
       size_t size(ASIO::buffer_size(buffers));
 
       chunk_header_type chunk_header(size, extension);
-      tx_header_ = chunk_header.to_string();
+      tx_header_.clear();
+      chunk_header.serialize(tx_header_);
       buffers.push_front(ASIO::buffer(tx_header_));
-      buffers.push_back(ASIO::buffer(http::CRLF));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
       return send(std::move(buffers));
     }
 
@@ -637,11 +692,93 @@ namespace via
         return false;
 
       http::last_chunk last_chunk(extension, trailer_string);
-      tx_header_ = last_chunk.to_string();
+      tx_header_.clear();
+      last_chunk.serialize(tx_header_);
 
       return send(comms::ConstBuffers(1, ASIO::buffer(tx_header_)));
     }
 
+    ////////////////////////////////////////////////////////////////////////
+    // asynchronous operations
+
+    /// Connect to the given host name and port and wait until connected.
+    /// The operation may be used with any asio completion token, e.g. in a
+    /// C++20 coroutine:
+    /// @code
+    /// co_await client->async_connect("localhost", "http", ASIO::use_awaitable);
+    /// @endcode
+    /// @param host_name the host to connect to.
+    /// @param port_name the port to connect to.
+    /// @param token the completion token, signature: void(error_code).
+    /// The error is host_not_found if the host wasn't resolved, not_connected
+    /// if the connection failed and in_progress if already connecting.
+    template <typename CompletionToken>
+    auto async_connect(std::string_view host_name, std::string_view port_name,
+                       CompletionToken&& token)
+    {
+      return ASIO::async_initiate<CompletionToken, void (ASIO_ERROR_CODE)>
+        ([this](auto handler, std::string host_name, std::string port_name)
+      {
+        if (connect_op_.is_pending())
+        {
+          comms::async_operation<ASIO_ERROR_CODE> operation;
+          operation.start(std::move(handler), io_context_.get_executor());
+          operation.complete(ASIO::error::in_progress);
+          return;
+        }
+
+        connect_op_.start(std::move(handler), io_context_.get_executor());
+        if (is_connected())
+          connect_op_.complete(ASIO_ERROR_CODE());
+        else if (!connect(host_name, port_name, period_))
+          connect_op_.complete(ASIO::error::host_not_found);
+      }, token, std::string(host_name), std::string(port_name));
+    }
+
+    /// Send an HTTP request and wait for its response.
+    /// The response is passed to the completion handler instead of the
+    /// ResponseHandler; if it's chunked, the chunks are concatenated into
+    /// the body instead of being passed to the ChunkHandler. E.g.:
+    /// @code
+    /// auto [response, body] = co_await client->async_request
+    ///   (via::http::tx_request(via::http::request_method::id::GET, "/"),
+    ///    std::string(), ASIO::use_awaitable);
+    /// @endcode
+    /// Note: with ASIO::use_awaitable, an error is thrown as a system_error.
+    /// @param request the request to send.
+    /// @param body the body to send.
+    /// @param token the completion token,
+    /// signature: void(error_code, http_response, Container).
+    /// The error is not_connected if not connected, in_progress if a request
+    /// is already being sent or awaited, invalid_argument if the response
+    /// was invalid or the error from the connection.
+    template <typename CompletionToken>
+    auto async_request(http_request request, Container body,
+                       CompletionToken&& token)
+    {
+      return ASIO::async_initiate<CompletionToken,
+                                  void (ASIO_ERROR_CODE, http_response, Container)>
+        ([this](auto handler, http_request request, Container body)
+      {
+        if (request_op_.is_pending() || !is_connected())
+        {
+          comms::async_operation<ASIO_ERROR_CODE, http_response, Container>
+            operation;
+          operation.start(std::move(handler), io_context_.get_executor());
+          operation.complete(request_op_.is_pending() ? ASIO::error::in_progress
+                                                      : ASIO::error::not_connected,
+                             http_response(), Container());
+          return;
+        }
+
+        request_op_.start(std::move(handler), io_context_.get_executor());
+        // fails if the connection is still sending the previous message
+        if (!send(std::move(request), std::move(body)))
+          request_op_.complete(ASIO::error::in_progress, http_response(),
+                               Container());
+      }, token, std::move(request), std::move(body));
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // other functions
 
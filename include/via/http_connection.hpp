@@ -18,8 +18,11 @@
 #include "via/http/request.hpp"
 #include "via/http/response.hpp"
 #include "via/comms/connection.hpp"
+#include "via/comms/async_operation.hpp"
 #include <deque>
 #include <iostream>
+#include <mutex>
+#include <optional>
 
 namespace via
 {
@@ -109,6 +112,10 @@ namespace via
                                         MAX_WHITESPACE_CHARS,
                                         STRICT_CRLF> chunk_header;
 
+    /// The type of the executor of the underlying connection.
+    typedef decltype(std::declval<typename connection_type::socket_type&>().
+                     get_executor()) executor_type;
+
   private:
 
     ////////////////////////////////////////////////////////////////////////
@@ -120,26 +127,98 @@ namespace via
     /// The remote address of the connection_.
     std::string remote_address_;
 
+    /// The executor of the connection_.
+    executor_type executor_;
+
     /// The request receiver for this connection.
     http_request_rx rx_;
 
     /// A buffer for the HTTP header of the response message.
+    /// Note: it is reused for each response, so it rarely reallocates.
     std::string tx_header_{};
 
     /// A buffer for the body of the response message.
     Container tx_body_{};
 
+    /// The compression level for response bodies, zero is disabled.
+    int compression_level_{ 0 };
+
+    /// The minimum size of a response body to compress.
+    size_t compression_threshold_{ http::content_coding::DEFAULT_THRESHOLD };
+
+    /// The compressor for the chunks of a chunked response body.
+    http::compressor tx_compressor_{};
+
+    /// Whether the request has been passed to a deferred handler.
+    bool deferred_{ false };
+
+    /// Protects the state of a deferred response below.
+    std::mutex deferred_mutex_{};
+
+    /// Whether the received data is suspended, waiting for a deferred response.
+    bool suspended_{ false };
+
+    /// Whether to resume receiving data when the deferred response has been sent.
+    bool resume_on_sent_{ false };
+
+    /// A deferred response that was sent before the received data was suspended.
+    std::optional<std::pair<http::tx_response, Container>> deferred_response_{};
+
+    /// The data received after the request of a deferred response.
+    std::string deferred_rx_{};
+
+    /// The pending async_send operation.
+    comms::async_operation<ASIO_ERROR_CODE> send_op_{};
+
+    /// Whether the response of send_op_ has been sent on the connection.
+    bool send_op_sent_{ false };
+
+    /// Whether the connection is shutdown after the response of send_op_.
+    bool send_op_closes_{ false };
+
+    /// The pending async_read_body operation.
+    comms::async_operation<ASIO_ERROR_CODE, Container> read_body_op_{};
+
+    /// Whether a streamed request body is being stored for async_read_body.
+    bool reading_body_{ false };
+
+    /// Whether read_body_ contains the whole of a streamed request body.
+    bool body_read_{ false };
+
+    /// The streamed request body stored for async_read_body.
+    Container read_body_{};
+
     ////////////////////////////////////////////////////////////////////////
     // Functions
 
+    /// Send the held deferred response, if the connection is suspended and
+    /// the previous response has been sent.
+    /// @pre deferred_mutex_ must be locked.
+    void send_held_response()
+    {
+      if (!suspended_ || !deferred_response_)
+        return;
+
+      std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+      if (tcp_pointer && !tcp_pointer->transmitting())
+      {
+        send_op_sent_ = send_op_.is_pending();
+        resume_on_sent_ = send(std::move(deferred_response_->first),
+                               std::move(deferred_response_->second));
+        deferred_response_.reset();
+      }
+    }
+
     /// Send buffers on the connection.
     /// @param buffers the data to write.
-    bool send(comms::ConstBuffers buffers)
+    /// @param owner the owner of the memory of the buffers, if any.
+    bool send(comms::ConstBuffers buffers,
+              std::shared_ptr<const void> owner = nullptr)
     {
       std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
       if (tcp_pointer)
       {
-        tcp_pointer->send_data(std::move(buffers));
+        tcp_pointer->send_data(std::move(buffers), std::move(owner));
         return true;
       }
       else
@@ -149,7 +228,9 @@ namespace via
     /// Send buffers on the connection.
     /// @param buffers the data to write.
     /// @param is_continue whether this is a 100 Continue response
-    bool send(comms::ConstBuffers buffers, bool is_continue)
+    /// @param owner the owner of the memory of the buffers, if any.
+    bool send(comms::ConstBuffers buffers, bool is_continue,
+              std::shared_ptr<const void> owner = nullptr)
     {
       bool keep_alive(rx_.request().keep_alive());
       if (is_continue)
@@ -160,7 +241,7 @@ namespace via
       std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
       if (tcp_pointer)
       {
-        tcp_pointer->send_data(std::move(buffers));
+        tcp_pointer->send_data(std::move(buffers), std::move(owner));
 
         if (keep_alive)
           return true;
@@ -173,6 +254,65 @@ namespace via
       return false;
     }
 
+    /// Choose the content coding of a response body from the request's
+    /// Accept-Encoding header.
+    /// If compression is enabled and the response may be compressed, a
+    /// "Vary: Accept-Encoding" header is added to the response.
+    /// @param response the response.
+    /// @return the content coding, IDENTITY if the body is not to be
+    /// compressed.
+    http::content_coding::id content_coding(http::tx_response& response)
+    {
+      if (!http::content_coding::is_supported() || (compression_level_ <= 0) ||
+          !response.is_compressible())
+        return http::content_coding::id::IDENTITY;
+
+      response.add_header(http::header_field::id::VARY,
+                          http::header_field::HEADER_ACCEPT_ENCODING);
+      return http::content_coding::negotiate
+          (rx_.request().headers().find(http::header_field::id::ACCEPT_ENCODING));
+    }
+
+    /// Compress a response body, if the client accepts a content coding and
+    /// the compressed body is smaller.
+    /// @param response the response, a Content-Encoding header is added and
+    /// a strong ETag is made weak if the body is compressed.
+    /// @retval body the response body, compressed if the function succeeds.
+    void compress_body(http::tx_response& response, Container& body)
+    {
+      if (body.size() < compression_threshold_)
+        return;
+
+      auto coding(content_coding(response));
+      if ((coding != http::content_coding::id::IDENTITY) &&
+          http::compress(coding, compression_level_, body, tx_body_) &&
+          (tx_body_.size() < body.size()))
+      {
+        response.add_header(http::header_field::id::CONTENT_ENCODING,
+                            http::content_coding::name(coding));
+        response.weaken_etag();
+        body.swap(tx_body_);
+      }
+    }
+
+    /// Send the compressed data in tx_body_ as a chunk.
+    /// @param extension the chunk extension.
+    bool send_compressed_chunk(std::string_view extension)
+    {
+      // the compressor may not have output anything yet
+      if (tx_body_.empty())
+        return true;
+
+      chunk_header header(tx_body_.size(), extension);
+      tx_header_.clear();
+      header.serialize(tx_header_);
+
+      comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
+      buffers.push_back(ASIO::buffer(tx_body_));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
+      return send(std::move(buffers));
+    }
+
     ////////////////////////////////////////////////////////////////////////
 
   public:
@@ -188,6 +328,7 @@ namespace via
       connection_(connection),
       remote_address_(connection_.lock()->socket().
                       remote_endpoint().address().to_string()),
+      executor_(connection_.lock()->socket().get_executor()),
       rx_(max_content_length, max_chunk_size)
     {}
 
@@ -215,6 +356,41 @@ namespace via
     void set_concatenate_chunks(bool enable) noexcept
     { rx_.set_concatenate_chunks(enable); }
 
+    /// Enable whether the http server passes request bodies in fragments.
+    /// If a BodyHandler is registered with the http_server then request
+    /// bodies are passed to it in fragments instead of being stored.
+    /// @post body streaming enabled/disabled.
+    /// @param enable enable the function.
+    void set_stream_body(bool enable) noexcept
+    { rx_.set_stream_body(enable); }
+
+    /// Set the minimum Content-Length of a request body to read directly
+    /// into the request body, instead of via the receive buffer.
+    /// @see read_body_directly
+    /// @param threshold the minimum Content-Length, zero is disabled.
+    void set_direct_read_threshold(size_t threshold) noexcept
+    { rx_.set_direct_read_threshold(threshold); }
+
+    /// Set the compression of response bodies.
+    /// @see http_server::set_compression
+    /// @param level the compression level, zero is disabled.
+    /// @param threshold the minimum size of a response body to compress.
+    void set_compression(int level, size_t threshold) noexcept
+    {
+      compression_level_ = level;
+      compression_threshold_ = threshold;
+    }
+
+    /// Set the size of request body above which it is written to an
+    /// anonymous temporary file instead of being held in memory.
+    /// @see spilled_body
+    /// @param threshold the size of the request body, zero is disabled.
+    /// @param max_length the maximum size of a request body written to a file.
+    /// @param directory the directory in which to create the files.
+    void set_spill_to_file(size_t threshold, size_t max_length,
+                           std::string const& directory)
+    { rx_.set_spill_to_file(threshold, max_length, directory); }
+
     ////////////////////////////////////////////////////////////////////////
     // Accessors
 
@@ -237,6 +413,14 @@ namespace via
     Container const& body() const noexcept
     { return rx_.body(); }
 
+    /// Accessor for a request body that has been written to a file.
+    /// The body is in the file if it is open, otherwise it's in body().
+    /// Note: the file is closed after the request handler returns, unless
+    /// the application moves it from here, e.g. to process it later.
+    /// @return a reference to the file.
+    http::body_file& spilled_body() noexcept
+    { return rx_.spilled_body(); }
+
     /// Accessor for the received HTTP chunk.
     /// @return a constant reference to an rx_chunk.
     chunk_type const& chunk() const noexcept
@@ -246,13 +430,25 @@ namespace via
     // send (response) functions
 
     /// Send the appropriate HTTP response to the request.
+    /// A standard response is sent from a canned response, without
+    /// formatting it.
     /// @return true if sent, false otherwise.
     bool send_response()
     {
+      auto canned(http::response_status::canned_response
+                    (static_cast<int>(rx_.response_code()),
+                     rx_.request().major_version(),
+                     rx_.request().minor_version()));
+      if (!canned.empty())
+        return send(comms::ConstBuffers(1, ASIO::buffer(canned.data(),
+                                                         canned.size())),
+                    rx_.response_code() == http::response_status::code::CONTINUE);
+
       http::tx_response response(rx_.response_code());
       response.set_major_version(rx_.request().major_version());
       response.set_minor_version(rx_.request().minor_version());
-      tx_header_ = response.message();
+      tx_header_.clear();
+      response.serialize(tx_header_);
 
       return send(comms::ConstBuffers(1, ASIO::buffer(tx_header_)),
                   response.is_continue());
@@ -267,15 +463,32 @@ namespace via
       if (!response.is_valid())
         return false;
 
+      // Compress the chunks of a chunked response
+      tx_compressor_.close();
+      if (response.has_transfer_encoding() && !rx_.is_head())
+      {
+        auto coding(content_coding(response));
+        if ((coding != http::content_coding::id::IDENTITY) &&
+            tx_compressor_.open(coding, compression_level_))
+        {
+          response.add_header(http::header_field::id::CONTENT_ENCODING,
+                              http::content_coding::name(coding));
+          response.weaken_etag();
+        }
+      }
+
       response.set_major_version(rx_.request().major_version());
       response.set_minor_version(rx_.request().minor_version());
-      tx_header_ = response.message();
+      tx_header_.clear();
+      response.serialize(tx_header_);
 
       return send(comms::ConstBuffers(1, ASIO::buffer(tx_header_)),
                   response.is_continue());
     }
 
     /// Send an HTTP response with a body.
+    /// The body is compressed if compression is enabled and the client
+    /// accepts it, see http_server::set_compression.
     /// @pre the response must not contain any split headers.
     /// @param response the response to send.
     /// @param body the body to send
@@ -285,9 +498,12 @@ namespace via
       if (!response.is_valid())
         return false;
 
+      compress_body(response, body);
+
       response.set_major_version(rx_.request().major_version());
       response.set_minor_version(rx_.request().minor_version());
-      tx_header_ = response.message(body.size());
+      tx_header_.clear();
+      response.serialize(tx_header_, body.size());
       comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
 
       // Don't send a body in response to a HEAD request
@@ -306,7 +522,10 @@ namespace via
     /// Their lifetime MUST exceed that of the write
     /// @param response the response to send.
     /// @param buffers a deque of asio::buffers containing the body to send.
-    bool send(http::tx_response response, comms::ConstBuffers buffers)
+    /// @param owner the owner of the memory of the buffers, if any: it is
+    /// held until the buffers have been sent.
+    bool send(http::tx_response response, comms::ConstBuffers buffers,
+              std::shared_ptr<const void> owner = nullptr)
     {
       if (!response.is_valid())
         return false;
@@ -320,10 +539,81 @@ namespace via
 
       response.set_major_version(rx_.request().major_version());
       response.set_minor_version(rx_.request().minor_version());
-      tx_header_ = response.message(size);
+      tx_header_.clear();
+      response.serialize(tx_header_, size);
       buffers.push_front(ASIO::buffer(tx_header_));
 
-      return send(std::move(buffers), response.is_continue());
+      return send(std::move(buffers), response.is_continue(), std::move(owner));
+    }
+
+    /// Send a cached response.
+    /// Only the Date header, if any, is formatted; the status line, the
+    /// other headers and the body are sent from the cached response.
+    /// The status line is copied with the request's version, if it's not
+    /// an HTTP/1.1 request.
+    /// If the cached response has compressed variants, the variant accepted
+    /// by the client is sent.
+    /// @param cached the cached response to send.
+    /// @return true if sent, false otherwise.
+    bool send(std::shared_ptr<const http::cached_response<Container>> cached)
+    {
+      auto coding(http::content_coding::id::IDENTITY);
+      if (cached->is_compressed())
+        coding = http::content_coding::negotiate
+            (rx_.request().headers().find(http::header_field::id::ACCEPT_ENCODING),
+             cached->available());
+
+      // The cached status line is HTTP/1.1, other versions are copied
+      tx_header_.clear();
+      char major_version(rx_.request().major_version());
+      char minor_version(rx_.request().minor_version());
+      bool http_1_1((major_version == '1') && (minor_version == '1'));
+      if (!http_1_1)
+      {
+        tx_header_ = cached->status_line();
+        tx_header_[5] = major_version;
+        tx_header_[7] = minor_version;
+      }
+      if (cached->has_date_header())
+        http::header_field::append_date_header(tx_header_);
+
+      comms::ConstBuffers buffers;
+      if (http_1_1)
+        buffers.push_back(ASIO::buffer(cached->status_line()));
+      if (!tx_header_.empty())
+        buffers.push_back(ASIO::buffer(tx_header_));
+      buffers.push_back(ASIO::buffer(cached->headers(coding)));
+
+      // Don't send a body in response to a HEAD request
+      if (!rx_.is_head())
+        buffers.push_back(ASIO::buffer(cached->body(coding)));
+
+      return send(std::move(buffers), false, std::move(cached));
+    }
+
+    /// Send an HTTP response with a shared body.
+    /// The body is not copied, it is held until it has been sent, so the
+    /// same body can be sent to many connections.
+    /// @pre the response must not contain any split headers.
+    /// @param response the response to send.
+    /// @param body the body to send.
+    /// @return true if sent, false otherwise.
+    bool send(http::tx_response response, std::shared_ptr<const Container> body)
+    {
+      if (!response.is_valid())
+        return false;
+
+      response.set_major_version(rx_.request().major_version());
+      response.set_minor_version(rx_.request().minor_version());
+      tx_header_.clear();
+      response.serialize(tx_header_, body ? body->size() : 0u);
+      comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
+
+      // Don't send a body in response to a HEAD request
+      if (body && !rx_.is_head())
+        buffers.push_back(ASIO::buffer(*body));
+
+      return send(std::move(buffers), response.is_continue(), std::move(body));
     }
 
     ////////////////////////////////////////////////////////////////////////
@@ -335,14 +625,23 @@ namespace via
     bool send_chunk(Container chunk,
                      std::string_view extension = std::string_view())
     {
+      if (tx_compressor_.is_open())
+      {
+        tx_body_.clear();
+        return tx_compressor_.compress(chunk.data(), chunk.size(),
+                                       tx_body_, false) &&
+               send_compressed_chunk(extension);
+      }
+
       size_t size(chunk.size());
       chunk_header header(size, extension);
-      tx_header_ = header.to_string();
+      tx_header_.clear();
+      header.serialize(tx_header_);
       tx_body_.swap(chunk);
 
       comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
       buffers.push_back(ASIO::buffer(tx_body_));
-      buffers.push_back(ASIO::buffer(http::CRLF));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
       return send(std::move(buffers));
     }
 
@@ -354,16 +653,53 @@ namespace via
     bool send_chunk(comms::ConstBuffers buffers,
                      std::string_view extension = std::string_view())
     {
+      if (tx_compressor_.is_open())
+      {
+        tx_body_.clear();
+        for (auto const& buffer : buffers)
+          if (!tx_compressor_.compress(static_cast<const char*>(buffer.data()),
+                                       buffer.size(), tx_body_, false))
+            return false;
+        return send_compressed_chunk(extension);
+      }
+
       // Calculate the overall size of the data in the buffers
       size_t size(ASIO::buffer_size(buffers));
 
       chunk_header header(size, extension);
-      tx_header_ = header.to_string();
+      tx_header_.clear();
+      header.serialize(tx_header_);
       buffers.push_front(ASIO::buffer(tx_header_));
-      buffers.push_back(ASIO::buffer(http::CRLF));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
       return send(std::move(buffers));
     }
 
+    /// Send a shared HTTP body chunk.
+    /// The chunk is not copied, it is held until it has been sent, so the
+    /// same chunk can be sent to many connections.
+    /// @param chunk the body chunk to send
+    /// @param extension the (optional) chunk extension.
+    bool send_chunk(std::shared_ptr<const Container> chunk,
+                     std::string_view extension = std::string_view())
+    {
+      if (tx_compressor_.is_open())
+      {
+        tx_body_.clear();
+        return tx_compressor_.compress(chunk->data(), chunk->size(),
+                                       tx_body_, false) &&
+               send_compressed_chunk(extension);
+      }
+
+      chunk_header header(chunk->size(), extension);
+      tx_header_.clear();
+      header.serialize(tx_header_);
+
+      comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_));
+      buffers.push_back(ASIO::buffer(*chunk));
+      buffers.push_back(ASIO::buffer(http::CRLF, 2u));
+      return send(std::move(buffers), std::move(chunk));
+    }
+
     /// Send the last HTTP chunk for a response.
     /// @param extension the (optional) chunk extension.
     /// @param trailer_string the (optional) chunk trailers.
@@ -371,11 +707,195 @@ namespace via
                      std::string_view trailer_string = std::string_view())
     {
       http::last_chunk last_chunk(extension, trailer_string);
-      tx_header_ = last_chunk.to_string();
+      tx_header_.clear();
+
+      // Send the end of a compressed stream in a chunk before the last chunk
+      if (tx_compressor_.is_open())
+      {
+        tx_body_.clear();
+        bool finished(tx_compressor_.compress(nullptr, 0u, tx_body_, true));
+        tx_compressor_.close();
+        if (!finished)
+          return false;
+
+        if (!tx_body_.empty())
+        {
+          chunk_header header(tx_body_.size());
+          header.serialize(tx_header_);
+          auto header_size(tx_header_.size());
+          tx_header_.append(http::CRLF);
+          last_chunk.serialize(tx_header_);
 
+          comms::ConstBuffers buffers(1, ASIO::buffer(tx_header_.data(),
+                                                      header_size));
+          buffers.push_back(ASIO::buffer(tx_body_));
+          buffers.push_back(ASIO::buffer(tx_header_.data() + header_size,
+                                         tx_header_.size() - header_size));
+          return send(std::move(buffers));
+        }
+      }
+
+      last_chunk.serialize(tx_header_);
       return send(comms::ConstBuffers(1, ASIO::buffer(tx_header_)));
     }
 
+    ////////////////////////////////////////////////////////////////////////
+    // asynchronous operations
+
+    /// Send an HTTP response with a body and wait until it has been sent.
+    /// The operation may be used with any asio completion token, e.g. in a
+    /// C++20 coroutine:
+    /// @code
+    /// co_await connection->async_send(response, body, ASIO::use_awaitable);
+    /// @endcode
+    /// If the request has been deferred, see defer, the response is sent
+    /// like a deferred response, so the rest of the received requests are
+    /// handled after it has been sent.
+    /// Note: the operations must be called on the executor of the connection.
+    /// @param response the response to send.
+    /// @param body the body to send.
+    /// @param token the completion token, signature: void(error_code).
+    /// The error is invalid_argument if the response is invalid, in_progress
+    /// if the previous response is still being sent, connection_reset if
+    /// disconnected before the response was sent or not_connected.
+    template <typename CompletionToken>
+    auto async_send(http::tx_response response, Container body,
+                    CompletionToken&& token)
+    {
+      return ASIO::async_initiate<CompletionToken, void (ASIO_ERROR_CODE)>
+        ([this](auto handler, http::tx_response response, Container body)
+      {
+        std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+        bool deferred(deferred_ || is_suspended());
+        if (!response.is_valid() || !tcp_pointer || send_op_.is_pending() ||
+            (!deferred && tcp_pointer->transmitting()))
+        {
+          comms::async_operation<ASIO_ERROR_CODE> operation;
+          operation.start(std::move(handler), executor_);
+          operation.complete(!response.is_valid() ? ASIO::error::invalid_argument :
+                             !tcp_pointer ? ASIO::error::not_connected :
+                                            ASIO::error::in_progress);
+          return;
+        }
+
+        send_op_.start(std::move(handler), executor_);
+        send_op_closes_ = !rx_.request().keep_alive();
+        if (deferred)
+          send_deferred(std::move(response), std::move(body));
+        else
+        {
+          send_op_sent_ = true;
+          send(std::move(response), std::move(body));
+        }
+      }, token, std::move(response), std::move(body));
+    }
+
+    /// Wait for the body of the request.
+    /// If the body is stored, i.e. it's not streamed to a BodyHandler, it's
+    /// complete when the request handler is called, so the operation
+    /// completes with a copy of it.
+    /// A streamed body is stored for this operation, instead of being passed
+    /// to the BodyHandler, if the request handler calls defer when the
+    /// header has been received; the operation completes when the whole
+    /// body has been received.
+    /// Note: the body and request are only valid until the response has been
+    /// sent if the request handler called defer, see async_send.
+    /// @param token the completion token, signature: void(error_code, Container).
+    /// The error is in_progress if a read is already pending or
+    /// connection_reset if disconnected before the body was received.
+    template <typename CompletionToken>
+    auto async_read_body(CompletionToken&& token)
+    {
+      return ASIO::async_initiate<CompletionToken, void (ASIO_ERROR_CODE, Container)>
+        ([this](auto handler)
+      {
+        if (read_body_op_.is_pending())
+        {
+          comms::async_operation<ASIO_ERROR_CODE, Container> operation;
+          operation.start(std::move(handler), executor_);
+          operation.complete(ASIO::error::in_progress, Container());
+          return;
+        }
+
+        read_body_op_.start(std::move(handler), executor_);
+        if (body_read_)
+        {
+          body_read_ = false;
+          read_body_op_.complete(ASIO_ERROR_CODE(), std::move(read_body_));
+          read_body_.clear();
+        }
+        else if (!reading_body_)
+          read_body_op_.complete(ASIO_ERROR_CODE(), rx_.body());
+      }, token);
+    }
+
+    /// Accessor for the executor of the underlying connection, e.g. to
+    /// co_spawn a coroutine that handles a request.
+    executor_type const& get_executor() const noexcept
+    { return executor_; }
+
+    /// Store a streamed request body for async_read_body, if the request
+    /// handler deferred the request when its header was received.
+    /// It's called by the http_server after the request handler.
+    void store_deferred_body() noexcept
+    {
+      reading_body_ = deferred_;
+      body_read_ = false;
+      read_body_.clear();
+    }
+
+    /// Store a fragment of a streamed request body for async_read_body.
+    /// It's called by the http_server when a fragment of a body is received.
+    /// @param fragment the fragment of the body.
+    /// @param is_last whether it's the last fragment of the body.
+    /// @return true if stored, false if it's for the BodyHandler.
+    bool store_fragment(std::string_view fragment, bool is_last)
+    {
+      if (!reading_body_)
+        return false;
+
+      read_body_.insert(read_body_.end(), fragment.begin(), fragment.end());
+      if (is_last)
+      {
+        reading_body_ = false;
+        if (read_body_op_.is_pending())
+        {
+          read_body_op_.complete(ASIO_ERROR_CODE(), std::move(read_body_));
+          read_body_.clear();
+        }
+        else
+          body_read_ = true;
+      }
+      return true;
+    }
+
+    /// Complete a pending async_send operation when its response has been
+    /// sent. It's called by the http_server on a SENT event.
+    void message_sent()
+    {
+      if (send_op_sent_)
+      {
+        send_op_sent_ = false;
+        send_op_.complete(ASIO_ERROR_CODE());
+      }
+    }
+
+    /// Complete the pending asynchronous operations when disconnected.
+    /// It's called by the http_server on a DISCONNECTED event.
+    void disconnected()
+    {
+      // A response to a request without keep alive is followed by a shutdown
+      if (send_op_sent_ && send_op_closes_)
+        send_op_.complete(ASIO_ERROR_CODE());
+      else
+        send_op_.complete(ASIO::error::connection_reset);
+      send_op_sent_ = false;
+
+      reading_body_ = false;
+      body_read_ = false;
+      read_body_op_.complete(ASIO::error::connection_reset, Container());
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // other functions
 
@@ -385,7 +905,127 @@ namespace via
 
     /// Close the underlying connection.
     void close()
-    { connection_.lock()->close(); }
+    {
+      std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+      if (tcp_pointer)
+        tcp_pointer->close();
+    }
+
+    /// If the rest of a request body is being received directly, read the
+    /// next data packet from the underlying connection straight into the
+    /// request body, instead of copying it from the receive buffer.
+    /// Note: the read owns the body until it has completed, so the request
+    /// may be cleared, e.g. on a disconnect, while the read is in progress.
+    void read_body_directly()
+    {
+      size_t size(rx_.body_remaining());
+      if (size > 0u)
+      {
+        std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+        if (tcp_pointer)
+          tcp_pointer->read_into(ASIO::mutable_buffer(rx_.body_space(), size),
+                                 rx_.direct_body_owner());
+      }
+    }
+
+    /// Post a function to the executor of the underlying connection.
+    /// @param handler the function to call.
+    template <typename Handler>
+    void post(Handler handler)
+    {
+      std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+      if (tcp_pointer)
+        ASIO::post(tcp_pointer->socket().get_executor(), std::move(handler));
+    }
+
+    /// Record that the request has been passed to a deferred handler,
+    /// see suspend.
+    void defer() noexcept
+    { deferred_ = true; }
+
+    /// If the request has been passed to a deferred handler, stop receiving
+    /// until its response has been sent, so that the responses are sent in
+    /// the order of the requests.
+    /// @param iter the start of the rest of the received data.
+    /// @param end the end of the received data.
+    /// @return true if suspended, false otherwise.
+    bool suspend(const char* iter, const char* end)
+    {
+      if (!deferred_)
+        return false;
+      deferred_ = false;
+
+      pause_reception();
+      std::lock_guard<std::mutex> lock(deferred_mutex_);
+      suspended_ = true;
+      deferred_rx_.assign(iter, end);
+      send_held_response();
+      return true;
+    }
+
+    /// Send the response of a deferred handler, or hold it until the
+    /// connection has been suspended.
+    /// @param response the response.
+    /// @param body the response body.
+    void send_deferred(http::tx_response response, Container body)
+    {
+      std::lock_guard<std::mutex> lock(deferred_mutex_);
+      deferred_response_.emplace(std::move(response), std::move(body));
+      send_held_response();
+    }
+
+    /// Resume after the deferred response has been sent.
+    /// It is called when a message has been sent: it sends a held deferred
+    /// response if the previous response was still being sent.
+    /// @retval data the data received after the request of the response.
+    /// @return true if resumed, false if not suspended or it hasn't been sent.
+    bool resume(std::string& data)
+    {
+      {
+        std::lock_guard<std::mutex> lock(deferred_mutex_);
+        if (!resume_on_sent_)
+        {
+          send_held_response();
+          return false;
+        }
+
+        resume_on_sent_ = false;
+        suspended_ = false;
+        data.swap(deferred_rx_);
+        deferred_rx_.clear();
+      }
+
+      rx_.clear();
+      body_read_ = false;
+      read_body_.clear();
+      return true;
+    }
+
+    /// Whether the received data is suspended, waiting for a deferred response.
+    bool is_suspended() noexcept
+    {
+      std::lock_guard<std::mutex> lock(deferred_mutex_);
+      return suspended_;
+    }
+
+    /// Stop receiving data from the underlying connection, e.g. while the
+    /// application is busy processing a streamed request body.
+    /// Note: the rest of the data that has already been received is still
+    /// passed to the application.
+    void pause_reception()
+    {
+      std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+      if (tcp_pointer)
+        tcp_pointer->pause_reception();
+    }
+
+    /// Resume receiving data from the underlying connection.
+    void resume_reception()
+    {
+      std::shared_ptr<connection_type> tcp_pointer(connection_.lock());
+      if (tcp_pointer)
+        tcp_pointer->resume_reception();
+    }
 
     /// Accessor function for the comms connection.
     /// @return a weak pointer to the connection
@@ -50,6 +50,7 @@
 #include "http_connection.hpp"
 #include "via/comms/server.hpp"
 #include "via/http/request_router.hpp"
+#include "via/http/static_router.hpp"
 #ifdef HTTP_SSL
   #ifdef ASIO_STANDALONE
     #include <asio/ssl/context.hpp>
@@ -57,6 +58,8 @@
     #include <boost/asio/ssl/context.hpp>
   #endif
 #endif
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <stdexcept>
 #include <iostream>
@@ -159,6 +162,12 @@ namespace via
                                  chunk_type const&, Container const&)>
       ChunkHandler;
 
+    /// The BodyHandler type: the request, a fragment of its body and
+    /// whether it's the last fragment of the body.
+    typedef std::function <void (std::weak_ptr<http_connection_type>,
+                                 http_request const&, std::string_view, bool)>
+      BodyHandler;
+
     /// The ConnectionHandler type.
     typedef std::function <void (std::weak_ptr<http_connection_type>)>
       ConnectionHandler;
@@ -179,11 +188,33 @@ namespace via
     request_router_type   request_router_{};       ///< the built-in request_router
     bool                  shutting_down_{ false }; ///< the server is shutting down
 
+    // Load shedding
+    /// the load shedder, if enabled
+    std::shared_ptr<http::load_shedder> load_shedder_{};
+    /// the timer that samples the io_context's queueing delay
+    ASIO::steady_timer load_timer_;
+    /// the time between samples of the queueing delay
+    std::chrono::steady_clock::duration load_sample_interval_{};
+
     // Request parser parameters
     /// the maximum request body content length
     size_t max_content_length_{http_request_rx::DEFAULT_MAX_CONTENT_LENGTH};
     /// the maximum size of a request chunk
     size_t max_chunk_size_{http::DEFAULT_MAX_CHUNK_SIZE};
+    /// the minimum request body content length to read directly
+    size_t direct_read_threshold_{ 0u };
+    /// the request body size above which it is written to a file
+    size_t spill_threshold_{ 0u };
+    /// the maximum size of a request body written to a file
+    size_t max_spill_length_{ 0u };
+    /// the directory for request body files
+    std::string spill_directory_{};
+
+    // Response parameters
+    /// the compression level for response bodies, zero is disabled
+    int compression_level_{ 0 };
+    /// the minimum size of a response body to compress
+    size_t compression_threshold_{ http::content_coding::DEFAULT_THRESHOLD };
 
     // HTTP server options
     bool translate_head_{ true };   ///< whether the http server translates HEAD requests
@@ -193,6 +224,7 @@ namespace via
     // callback function pointers
     RequestHandler    http_request_handler_{}; ///< the request callback function
     ChunkHandler      http_chunk_handler_{};   ///< the http chunk callback function
+    BodyHandler       http_body_handler_{};    ///< the body fragment callback function
     RequestHandler    http_continue_handler_{};///< the continue callback function
     RequestHandler    http_invalid_handler_{}; ///< the invalid callback function
     ConnectionHandler connected_handler_{};    ///< the connected callback function
@@ -232,6 +264,12 @@ namespace via
                           (connection, max_content_length_, max_chunk_size_);
         http_connection->set_translate_head(translate_head_);
         http_connection->set_concatenate_chunks(!http_chunk_handler_);
+        http_connection->set_stream_body(static_cast<bool>(http_body_handler_));
+        http_connection->set_direct_read_threshold(direct_read_threshold_);
+        http_connection->set_spill_to_file(spill_threshold_, max_spill_length_,
+                                           spill_directory_);
+        http_connection->set_compression(compression_level_,
+                                         compression_threshold_);
         http_connections_.emplace(pointer, http_connection);
 
         // signal that the socket is connected
@@ -255,11 +293,92 @@ namespace via
       if (connection)
       {
         Container response_body;
+        typename request_router_type::RouteContext context;
+        context.shedder = load_shedder_.get();
+        // capture by reference, so that the function isn't allocated
+        context.make_responder = [&weak_ptr]()
+          { return make_responder(weak_ptr); };
         http::tx_response response
-            (request_router_.handle_request(request, body, response_body));
+            (request_router_.handle_request(request, body, response_body,
+                                            connection->rx().resource(),
+                                            &context));
+        if (context.deferred)
+        {
+          connection->defer();
+          return;
+        }
+
+        if (context.response)
+        {
+          connection->send(std::move(context.response));
+          return;
+        }
+
+        response.add_date_header();
+        response.add_server_header();
+
+        // Send a static file from its memory map
+        if (context.file)
+        {
+          comms::ConstBuffers buffers;
+          for (auto const& segment : context.file->segments)
+            buffers.push_back(ASIO::buffer(segment.data(), segment.size()));
+          connection->send(std::move(response), std::move(buffers),
+                           std::move(context.file));
+          return;
+        }
+
+        if (context.route &&
+            request_router_type::CachedResponse::is_cacheable(response))
+          connection->send(request_router_.cache_response
+              (*context.route, std::move(response), std::move(response_body),
+               compression_level_, compression_threshold_));
+        else
+          connection->send(std::move(response), std::move(response_body));
+      }
+    }
+
+    /// Create the responder for a deferred request handler.
+    /// It posts the response to the executor of the connection, which sends
+    /// it after the connection has been suspended, see receive_data.
+    /// @param weak_ptr a weak pointer to the connection.
+    /// @return the responder.
+    static typename request_router_type::Responder
+      make_responder(std::weak_ptr<http_connection_type> weak_ptr)
+    {
+      // The responder holds the connection, so that the request and its
+      // body stay valid for the handler, even if the client disconnects.
+      return typename request_router_type::Responder
+        ([weak_ptr](http::tx_response response, Container body)
+      {
+        std::shared_ptr<http_connection_type> connection(weak_ptr.lock());
+        if (!connection)
+          return;
+
         response.add_date_header();
         response.add_server_header();
-        connection->send(std::move(response), std::move(response_body));
+        connection->post([weak_ptr, response(std::move(response)),
+                          body(std::move(body))]() mutable
+        {
+          std::shared_ptr<http_connection_type> connection(weak_ptr.lock());
+          if (connection)
+            connection->send_deferred(std::move(response), std::move(body));
+        });
+      }, weak_ptr.lock());
+    }
+
+    /// Resume receiving on a connection after its deferred response has
+    /// been sent, starting with the data received after the request.
+    /// @param http_connection the connection.
+    void resume_deferred(std::shared_ptr<http_connection_type> const&
+                           http_connection)
+    {
+      std::string data;
+      if (http_connection->resume(data))
+      {
+        receive_data(http_connection, data.data(), data.size());
+        if (!http_connection->is_suspended())
+          http_connection->resume_reception();
       }
     }
 
@@ -295,6 +414,19 @@ namespace via
         return;
       }
 
+      receive_data(http_connection, data, size);
+    }
+
+    /// Parse the received data on a connection and handle its requests.
+    /// If a request is passed to a deferred handler, the connection is
+    /// suspended until the response has been sent: the rest of the data is
+    /// held by the connection and it stops receiving.
+    /// @param http_connection the connection.
+    /// @param data pointer to the received data.
+    /// @param size the number of bytes received.
+    void receive_data(std::shared_ptr<http_connection_type> const&
+                        http_connection, const char* data, size_t size)
+    {
       // Get the receive buffer
       const char* iter{data};
       const char* end{data + size};
@@ -316,6 +448,8 @@ namespace via
             http_request_handler_(http_connection,
                                   http_connection->request(),
                                   http_connection->body());
+            if (http_connection->suspend(iter, end))
+              return;
             if (!http_connection->request().is_chunked())
               http_connection->rx().clear();
             break;
@@ -365,10 +499,35 @@ namespace via
             http_connection->rx().clear();
           break;
 
+        case http::Rx::HEADERS:
+          http_request_handler_(http_connection,
+                                http_connection->request(),
+                                http_connection->body());
+          http_connection->store_deferred_body();
+          break;
+
+        case http::Rx::BODY:
+          if (!http_connection->store_fragment(http_connection->rx().fragment(),
+                                               http_connection->rx().body_complete()))
+            http_body_handler_(http_connection,
+                               http_connection->request(),
+                               http_connection->rx().fragment(),
+                               http_connection->rx().body_complete());
+          if (http_connection->rx().body_complete())
+          {
+            if (http_connection->suspend(iter, end))
+              return;
+            http_connection->rx().clear();
+          }
+          break;
+
         default:
           break;
         } // end switch
       } // end while
+
+      // read the rest of a large request body straight into the body
+      http_connection->read_body_directly();
     }
 
     /// Handle a disconnected signal from an underlying comms connection.
@@ -377,6 +536,8 @@ namespace via
     void disconnected_handler(void* pointer,
                         std::shared_ptr<http_connection_type> http_connection)
     {
+      http_connection->disconnected();
+
       // Noitfy the disconnected handler if one exists
       if (disconnected_handler_)
         disconnected_handler_(http_connection);
@@ -390,7 +551,10 @@ namespace via
 
       // If the http_server is being shutdown and this was the last connection
       if (shutting_down_ && http_connections_.empty())
+      {
+        load_timer_.cancel();
         server_->close();
+      }
     }
 
     /// Receive an event from the underlying comms connection.
@@ -431,6 +595,8 @@ namespace via
         switch(event)
         {
         case via::comms::SENT:
+          http_connection->message_sent();
+          resume_deferred(http_connection);
           // Notify the sent handler if one exists
           if (message_sent_handler_)
             message_sent_handler_(http_connection);
@@ -444,6 +610,23 @@ namespace via
       }
     }
 
+    /// Sample the queueing delay of the io_context: the time between the
+    /// load_timer_ expiring and its handler being run.
+    void sample_load()
+    {
+      load_timer_.expires_after(load_sample_interval_);
+      load_timer_.async_wait([this](ASIO_ERROR_CODE const& error)
+      {
+        // Note: the server may have been destroyed if the wait was cancelled
+        if (error || !load_shedder_)
+          return;
+
+        auto now(std::chrono::steady_clock::now());
+        load_shedder_->record(now - load_timer_.expiry(), now);
+        sample_load();
+      });
+    }
+
     /// Receive an error from the underlying comms connection.
     /// @param error the boost error_code.
     // @param connection a weak pointer to the underlying comms connection.
@@ -475,6 +658,7 @@ namespace via
                         ) :
       server_(new server_type(io_context)),
 #endif
+      load_timer_(io_context),
       max_content_length_(http_request_rx::DEFAULT_MAX_CONTENT_LENGTH),
       max_chunk_size_(http::DEFAULT_MAX_CHUNK_SIZE)
     {
@@ -496,15 +680,21 @@ namespace via
 
     /// Start accepting connections on the given port and protocol.
     /// @pre http_server::request_received_event must have been called to register
-    /// the request received callback function before this function.
-    /// @throw logic_error if request_received_event has NOT been called
-    /// before this function.
+    /// the request received callback function before this function if
+    /// body_received_event has been called.
+    /// @throw logic_error if body_received_event has been called but
+    /// request_received_event has NOT been called before this function.
     /// @param port the port number to serve:
     /// default 80 for HTTP or 443 for HTTPS.
     /// @return the boost error code, false if no error occured
     ASIO_ERROR_CODE accept_connections
                       (unsigned short port = SocketAdaptor::DEFAULT_HTTP_PORT)
     {
+      // The request_router requires the whole request body
+      if (http_body_handler_ && !http_request_handler_)
+        throw std::logic_error
+          ("http_server: a body handler requires a request handler");
+
       // If a request handler's not been registered, use the request_router
       if (!http_request_handler_)
         http_request_handler_ =
@@ -519,6 +709,32 @@ namespace via
     request_router_type& request_router()
     { return request_router_; }
 
+    /// Route requests with a static_router instead of the request_router_.
+    /// @post disables the built-in request_router.
+    /// @param router the static_router, it must outlive the server,
+    /// e.g. a static constexpr variable.
+    template <size_t N>
+    void set_static_router
+      (http::static_router<Container, http_request, N> const& router) noexcept
+    {
+      http_request_handler_ =
+          [&router](std::weak_ptr<http_connection_type> weak_ptr,
+                    http_request const& request, Container const& body)
+      {
+        std::shared_ptr<http_connection_type> connection(weak_ptr.lock());
+        if (connection)
+        {
+          Container response_body;
+          http::tx_response response
+              (router.handle_request(request, body, response_body,
+                                     connection->rx().resource()));
+          response.add_date_header();
+          response.add_server_header();
+          connection->send(std::move(response), std::move(response_body));
+        }
+      };
+    }
+
     ////////////////////////////////////////////////////////////////////////
     // Event Handlers
 
@@ -544,6 +760,23 @@ namespace via
     void chunk_received_event(ChunkHandler handler) noexcept
     { http_chunk_handler_ = handler; }
 
+    /// Connect the body received callback function.
+    ///
+    /// If the application registers a handler for this event, then the
+    /// bodies of requests are not stored: the request handler is called when
+    /// the header of a request has been received and then this handler is
+    /// called with each fragment of the body (Content-Length or chunked) as
+    /// it's received. The application should send its response after the
+    /// last fragment. It may call http_connection::pause_reception while it's
+    /// busy processing fragments and resume_reception when it's ready for more.
+    /// Note: requests without a body are just passed to the request handler.
+    /// @pre request_received_event must be called: the built-in
+    /// request_router requires the whole request body.
+    /// @post disables storing request bodies and concatenating chunks.
+    /// @param handler the handler for a fragment of a request body.
+    void body_received_event(BodyHandler handler) noexcept
+    { http_body_handler_ = handler; }
+
     /// Connect the expect continue received callback function.
     ///
     /// If the application registers a handler for this event, then the
@@ -596,6 +829,88 @@ namespace via
         http_request::DEFAULT_MAX_CHUNK_SIZE) noexcept
     { max_chunk_size_ = max_size; }
 
+    /// Set the minimum HTTP request body content length to read directly
+    /// into the request body.
+    /// A request body of at least this size is allocated once, when the
+    /// request header is received, and the rest of the body is read from the
+    /// socket straight into it, avoiding copying it from the receive buffer.
+    /// @param threshold the minimum content length, default zero: disabled.
+    void set_direct_read_threshold(size_t threshold = 0u) noexcept
+    { direct_read_threshold_ = threshold; }
+
+    /// Set the size of request body above which it is written to an
+    /// anonymous temporary file instead of being held in memory.
+    /// The request handler is called with an empty body, the application
+    /// must read the body from the connection's spilled_body() file.
+    /// @param threshold the size of the request body, zero is disabled.
+    /// @param max_length the maximum size of a request body written to a
+    /// file, if larger than max_content_length.
+    /// @param directory the directory in which to create the files,
+    /// default (empty) the system's temporary directory.
+    void set_spill_to_file(size_t threshold, size_t max_length,
+                           std::string const& directory = std::string())
+    {
+      spill_threshold_ = threshold;
+      max_spill_length_ = max_length;
+      spill_directory_ = directory;
+    }
+
+    /// Set the compression of response bodies.
+    /// Response bodies of at least min_size, and the chunks of chunked
+    /// responses, are compressed with the content coding that the client
+    /// prefers in its Accept-Encoding header: zstd, gzip or deflate.
+    /// A "Vary: Accept-Encoding" header is added to the responses.
+    /// Responses with a Content-Length or a Content-Encoding header and
+    /// bodies sent in asio buffers or shared containers are not compressed.
+    /// Cached responses are compressed once, when they are cached.
+    /// Note: requires the HTTP_ZLIB and/or HTTP_ZSTD macros and libraries.
+    /// @param level the compression level: 1 (fastest) to 9 (smallest),
+    /// zero is disabled.
+    /// @param min_size the minimum size of a response body to compress,
+    /// default 1024 bytes.
+    void set_compression(int level = http::content_coding::DEFAULT_LEVEL,
+                         size_t min_size = http::content_coding::DEFAULT_THRESHOLD)
+      noexcept
+    {
+      compression_level_ = level;
+      compression_threshold_ = min_size;
+    }
+
+    /// Shed requests for the request_router's routes when the server is
+    /// overloaded, i.e. when the time that work waits in the io_context's
+    /// queue has been above the target for an interval, see load_shedder.
+    /// While it's overloaded, requests for LOW priority routes and a
+    /// rising proportion of requests for NORMAL priority routes are sent a
+    /// Service Unavailable response with a Retry-After header, instead of
+    /// being passed to their handlers. HIGH priority routes are never shed.
+    /// See request_router::set_priority.
+    /// The queueing delay is sampled with a timer, ten times per interval.
+    /// @param target the target queueing delay, zero disables load shedding.
+    /// @param interval the interval that the delay must be above the target
+    /// for the server to be overloaded, default 100ms.
+    void set_load_shedding(std::chrono::steady_clock::duration target,
+                           std::chrono::steady_clock::duration interval
+                             = http::load_shedder::DEFAULT_INTERVAL)
+    {
+      load_timer_.cancel();
+      if (target.count() <= 0)
+      {
+        load_shedder_.reset();
+        return;
+      }
+
+      load_shedder_ = std::make_shared<http::load_shedder>(target, interval);
+      load_sample_interval_ = std::max(interval / 10,
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>
+                                  (std::chrono::milliseconds(1)));
+      sample_load();
+    }
+
+    /// Accessor for the load shedder, e.g. to export its statistics.
+    /// @return the load shedder, nullptr if load shedding is disabled.
+    std::shared_ptr<const http::load_shedder> load_shedder() const noexcept
+    { return load_shedder_; }
+
     /// Enable whether the http server translates HEAD requests into GET
     /// requests for the application.
     /// Note: http_server never sends a body in a response to a HEAD request.
@@ -667,6 +982,7 @@ namespace via
     /// Close the http server and all of the connections associated with it.
     void close()
     {
+      load_timer_.cancel();
       http_connections_.clear();
       server_->close();
     }
@@ -0,0 +1,120 @@
+#ifndef VIA_BOUNDED_QUEUE_HPP_
+#define VIA_BOUNDED_QUEUE_HPP_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file bounded_queue.hpp
+/// @brief A multi-producer, multi-consumer queue with a fixed capacity.
+//////////////////////////////////////////////////////////////////////////////
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace via
+{
+  namespace thread
+  {
+    //////////////////////////////////////////////////////////////////////////
+    /// @class bounded_queue
+    ///
+    /// A multi-producer, multi-consumer queue with a fixed capacity.
+    /// The items are held in a ring buffer that is allocated by the
+    /// constructor, protected by a mutex.
+    /// Producers don't wait: try_push fails if the queue is full, so that
+    /// the caller can reject the work instead. Consumers wait in pop until
+    /// there is an item or the queue is closed.
+    ///
+    /// @tparam T the type of the items, it must be default constructible and
+    /// move assignable.
+    //////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    class bounded_queue
+    {
+      std::vector<T> items_;                ///< the ring buffer
+      size_t head_{ 0u };                   ///< the index of the first item
+      size_t size_{ 0u };                   ///< the number of items
+      bool closed_{ false };                ///< whether the queue is closed
+      mutable std::mutex mutex_{};          ///< protects the data above
+      std::condition_variable not_empty_{}; ///< signalled by try_push and close
+
+    public:
+
+      /// Constructor.
+      /// @param capacity the maximum number of items in the queue.
+      explicit bounded_queue(size_t capacity)
+        : items_(capacity)
+      {}
+
+      bounded_queue(bounded_queue const&) = delete;
+      bounded_queue& operator=(bounded_queue const&) = delete;
+
+      /// The maximum number of items in the queue.
+      size_t capacity() const noexcept
+      { return items_.size(); }
+
+      /// The number of items in the queue.
+      size_t size() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+      }
+
+      /// Add an item to the back of the queue, if it isn't full.
+      /// @param item the item, it's only moved from if it was added.
+      /// @return true if added, false if the queue is full or closed.
+      bool try_push(T&& item)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (closed_ || (size_ == items_.size()))
+            return false;
+
+          items_[(head_ + size_) % items_.size()] = std::move(item);
+          ++size_;
+        }
+        not_empty_.notify_one();
+        return true;
+      }
+
+      /// Remove the item at the front of the queue, waiting for one if the
+      /// queue is empty.
+      /// @retval item the item.
+      /// @return true if an item was removed, false if the queue is closed
+      /// and empty.
+      bool pop(T& item)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]{ return closed_ || (size_ > 0u); });
+        if (size_ == 0u)
+          return false;
+
+        item = std::move(items_[head_]);
+        items_[head_] = T();
+        head_ = (head_ + 1u) % items_.size();
+        --size_;
+        return true;
+      }
+
+      /// Close the queue: no more items are added and the consumers return
+      /// from pop when the queue is empty.
+      void close()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          closed_ = true;
+        }
+        not_empty_.notify_all();
+      }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef VIA_WORKER_POOL_HPP_
+#define VIA_WORKER_POOL_HPP_
+
+#pragma once
+
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Ken Barker
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+/// @file worker_pool.hpp
+/// @brief A pool of threads that run tasks from a bounded queue.
+//////////////////////////////////////////////////////////////////////////////
+#include "bounded_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace via
+{
+  namespace thread
+  {
+    //////////////////////////////////////////////////////////////////////////
+    /// @class worker_pool
+    ///
+    /// A pool of threads that run tasks, e.g. CPU intensive request handlers,
+    /// so that they don't stall the connections on the io_context threads.
+    /// The tasks are queued in a bounded_queue: if it's full, try_post fails
+    /// immediately, so that the caller can reject the work.
+    ///
+    /// It counts the tasks and measures the time that they wait in the queue,
+    /// see stats.
+    /// An exception thrown by a task is caught and counted as a failure, so
+    /// it doesn't terminate the program. The task is destroyed, e.g. so that
+    /// a responder that it holds sends an error response.
+    //////////////////////////////////////////////////////////////////////////
+    class worker_pool
+    {
+    public:
+
+      /// A task to run.
+      typedef std::function<void ()> Task;
+
+      /// @struct statistics
+      /// A snapshot of the queue and the counters of a worker_pool.
+      struct statistics
+      {
+        size_t queue_depth;      ///< the number of tasks waiting in the queue
+        size_t capacity;         ///< the capacity of the queue
+        std::uint64_t posted;    ///< the number of tasks queued
+        std::uint64_t rejected;  ///< the number of tasks rejected, queue full
+        std::uint64_t completed; ///< the number of tasks run
+        std::uint64_t failed;    ///< the number of tasks that threw
+        /// The total time that the completed tasks waited in the queue.
+        std::chrono::nanoseconds total_wait;
+        /// The longest time that a completed task waited in the queue.
+        std::chrono::nanoseconds max_wait;
+      };
+
+    private:
+
+      /// A task and the time that it was queued.
+      struct queued_task
+      {
+        Task task{};
+        std::chrono::steady_clock::time_point queued{};
+      };
+
+      bounded_queue<queued_task> queue_;           ///< the queued tasks
+      std::vector<std::thread> threads_{};         ///< the worker threads
+      std::atomic<std::uint64_t> posted_{ 0u };    ///< tasks queued
+      std::atomic<std::uint64_t> rejected_{ 0u };  ///< tasks rejected
+      std::atomic<std::uint64_t> completed_{ 0u }; ///< tasks run
+      std::atomic<std::uint64_t> failed_{ 0u };    ///< tasks that threw
+      std::atomic<std::int64_t> total_wait_{ 0 };  ///< nanoseconds waited
+      std::atomic<std::int64_t> max_wait_{ 0 };    ///< nanoseconds waited
+
+      /// The function run by the worker threads.
+      void run()
+      {
+        queued_task item;
+        while (queue_.pop(item))
+        {
+          std::int64_t wait(std::chrono::duration_cast<std::chrono::nanoseconds>
+                  (std::chrono::steady_clock::now() - item.queued).count());
+          total_wait_ += wait;
+          auto max_wait(max_wait_.load());
+          while ((wait > max_wait) &&
+                 !max_wait_.compare_exchange_weak(max_wait, wait))
+            ;
+
+          try
+          {
+            item.task();
+          }
+          catch (...)
+          {
+            ++failed_;
+          }
+          item.task = nullptr;
+          ++completed_;
+        }
+      }
+
+    public:
+
+      /// Constructor, starts the threads.
+      /// @param threads the number of threads, default the number of
+      /// hardware threads.
+      /// @param queue_capacity the maximum number of tasks waiting to run,
+      /// default 1024.
+      explicit worker_pool(size_t threads = std::thread::hardware_concurrency(),
+                           size_t queue_capacity = 1024u)
+        : queue_(queue_capacity)
+      {
+        if (threads == 0u)
+          threads = 1u;
+        for (size_t i(0u); i < threads; ++i)
+          threads_.emplace_back([this]{ run(); });
+      }
+
+      worker_pool(worker_pool const&) = delete;
+      worker_pool& operator=(worker_pool const&) = delete;
+
+      /// Destructor, stops the threads after the queued tasks have run.
+      ~worker_pool()
+      { stop(); }
+
+      /// Queue a task to run on one of the threads.
+      /// @param task the task.
+      /// @return true if queued, false if the queue is full or stopped.
+      bool try_post(Task task)
+      {
+        if (queue_.try_push({ std::move(task), std::chrono::steady_clock::now() }))
+        {
+          ++posted_;
+          return true;
+        }
+
+        ++rejected_;
+        return false;
+      }
+
+      /// Stop queueing tasks and wait for the threads to run the queued
+      /// tasks and finish.
+      /// Note: it must not be called by a task.
+      void stop()
+      {
+        queue_.close();
+        for (auto& thread : threads_)
+          if (thread.joinable())
+            thread.join();
+      }
+
+      /// The number of threads.
+      size_t size() const noexcept
+      { return threads_.size(); }
+
+      /// A snapshot of the queue and the counters, e.g. to export as metrics.
+      statistics stats() const
+      {
+        return { queue_.size(), queue_.capacity(), posted_.load(),
+                 rejected_.load(), completed_.load(), failed_.load(),
+                 std::chrono::nanoseconds(total_wait_.load()),
+                 std::chrono::nanoseconds(max_wait_.load()) };
+      }
+    };
+  }
+}
+
+#endif
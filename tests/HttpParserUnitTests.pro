@@ -66,9 +66,18 @@ include($$VIAHTTPLIB/via-httplib.pri)
 LIBS += -l$$VIA_HTTPLIB_NAME
 
 SOURCES += $$VIAHTTPLIB/tests/test_main.cpp \
+  $$VIAHTTPLIB/tests/comms/test_async_operation.cpp \
+  $$VIAHTTPLIB/tests/comms/test_connection.cpp \
+  $$VIAHTTPLIB/tests/http/test_body_file.cpp \
   $$VIAHTTPLIB/tests/http/test_character.cpp \
   $$VIAHTTPLIB/tests/http/test_chunk.cpp \
+  $$VIAHTTPLIB/tests/http/test_compression.cpp \
+  $$VIAHTTPLIB/tests/http/test_etag.cpp \
   $$VIAHTTPLIB/tests/http/test_header_field.cpp \
   $$VIAHTTPLIB/tests/http/test_headers.cpp \
+  $$VIAHTTPLIB/tests/http/test_load_shedder.cpp \
   $$VIAHTTPLIB/tests/http/test_request.cpp \
-  $$VIAHTTPLIB/tests/http/test_response.cpp
+  $$VIAHTTPLIB/tests/http/test_response.cpp \
+  $$VIAHTTPLIB/tests/http/test_static_files.cpp \
+  $$VIAHTTPLIB/tests/http/test_static_router.cpp \
+  $$VIAHTTPLIB/tests/thread/test_worker_pool.cpp
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/comms/async_operation.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace via::comms;
+
+namespace
+{
+  typedef async_operation<ASIO_ERROR_CODE, std::string> string_operation;
+
+  /// An asynchronous operation with a completion token.
+  template <typename CompletionToken>
+  auto async_get(string_operation& operation, ASIO::io_context& io_context,
+                 CompletionToken&& token)
+  {
+    return ASIO::async_initiate<CompletionToken,
+                                void (ASIO_ERROR_CODE, std::string)>
+      ([&operation, &io_context](auto handler)
+       { operation.start(std::move(handler), io_context.get_executor()); },
+       token);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestAsyncOperation)
+
+BOOST_AUTO_TEST_CASE(AsyncOperationCallback1)
+{
+  ASIO::io_context io_context;
+  string_operation operation;
+  BOOST_CHECK(!operation.is_pending());
+  BOOST_CHECK(!operation.complete(ASIO_ERROR_CODE(), "ignored"));
+
+  int calls(0);
+  std::string result;
+  async_get(operation, io_context,
+            [&calls, &result](ASIO_ERROR_CODE const& error, std::string text)
+  {
+    BOOST_CHECK(!error);
+    result = text;
+    ++calls;
+  });
+  BOOST_CHECK(operation.is_pending());
+
+  // The handler is posted, not called by complete
+  BOOST_CHECK(operation.complete(ASIO_ERROR_CODE(), "done"));
+  BOOST_CHECK(!operation.is_pending());
+  BOOST_CHECK_EQUAL(0, calls);
+  BOOST_CHECK(!operation.complete(ASIO_ERROR_CODE(), "again"));
+
+  io_context.run();
+  BOOST_CHECK_EQUAL(1, calls);
+  BOOST_CHECK_EQUAL("done", result);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncOperationFuture1)
+{
+  ASIO::io_context io_context;
+  string_operation operation;
+
+  // A future's handler is move only and the error is thrown
+  auto future(async_get(operation, io_context, ASIO::use_future));
+  operation.complete(ASIO::error::connection_reset, std::string());
+  io_context.run();
+  BOOST_CHECK_THROW(future.get(), std::exception);
+
+  io_context.restart();
+  auto future1(async_get(operation, io_context, ASIO::use_future));
+  operation.complete(ASIO_ERROR_CODE(), "text");
+  io_context.run();
+  BOOST_CHECK_EQUAL("text", future1.get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/comms/tcp_adaptor.hpp"
+#include "via/comms/connection.hpp"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <string>
+
+using namespace via::comms;
+
+namespace
+{
+  typedef connection<tcp_adaptor> connection_type;
+
+  /// Accept a connection on the acceptor and send it the message.
+  void accept_and_send(ASIO::ip::tcp::acceptor& acceptor,
+                       ASIO::ip::tcp::socket& socket, std::string const& message)
+  {
+    acceptor.async_accept(socket, [&socket, &message](ASIO_ERROR_CODE const& error)
+    {
+      if (!error)
+        ASIO::async_write(socket, ASIO::buffer(message),
+                          [](ASIO_ERROR_CODE const&, size_t) {});
+    });
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestConnection)
+
+// A connection that's closed while reading, then reconnected, reads again.
+BOOST_AUTO_TEST_CASE(CloseAndReconnect1)
+{
+  ASIO::io_context io_context;
+  ASIO::ip::tcp::acceptor acceptor(io_context,
+    ASIO::ip::tcp::endpoint(ASIO::ip::address_v4::loopback(), 0));
+  const std::string port(std::to_string(acceptor.local_endpoint().port()));
+
+  std::string received;
+  int connected(0);
+  auto client(std::make_shared<connection_type>
+      (connection_type::socket_type(io_context), 1024));
+  client->set_receive_callback
+    ([&received](const char* data, size_t size, connection_type::weak_pointer)
+     { received.append(data, size); });
+  client->set_event_callback
+    ([&connected](unsigned char event, connection_type::weak_pointer)
+     { if (event == CONNECTED) ++connected; });
+
+  const std::string first("first");
+  ASIO::ip::tcp::socket socket1(io_context);
+  accept_and_send(acceptor, socket1, first);
+  BOOST_REQUIRE(client->connect(io_context, "127.0.0.1", port.c_str()));
+  while ((received != first) &&
+         io_context.run_one_for(std::chrono::seconds(1))) {}
+  BOOST_REQUIRE_EQUAL(first, received);
+  BOOST_CHECK(client->connected());
+
+  // Close the client while its next read is pending
+  client->close();
+  BOOST_CHECK(!client->connected());
+  received.clear();
+
+  const std::string second("second");
+  ASIO::ip::tcp::socket socket2(io_context);
+  accept_and_send(acceptor, socket2, second);
+  BOOST_REQUIRE(client->connect(io_context, "127.0.0.1", port.c_str()));
+  while ((received != second) &&
+         io_context.run_one_for(std::chrono::seconds(1))) {}
+  BOOST_CHECK_EQUAL(2, connected);
+  BOOST_CHECK_EQUAL(second, received);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
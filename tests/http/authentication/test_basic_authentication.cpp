@@ -16,6 +16,27 @@ using namespace via::http;
 
 namespace
 {
+  // An authentication written for the StringMap of header fields.
+  class string_map_authentication : public authentication
+  {
+  protected:
+
+    virtual bool is_valid(StringMap const& header_fields) const override
+    {
+      auto iter(header_fields.find(header_field::LC_AUTHORIZATION));
+      return (iter != header_fields.end()) && (iter->second == "secret");
+    }
+
+    virtual std::string authenticate_value() const override
+    { return "Custom"; }
+
+  public:
+
+    string_map_authentication()
+      : authentication("custom")
+    {}
+  };
+
   // A boost test fixture for this test suite.
   struct BasicAuthFixture
   {
@@ -82,6 +103,25 @@ namespace
 //////////////////////////////////////////////////////////////////////////////
 BOOST_FIXTURE_TEST_SUITE(TestBasicAuthentication, BasicAuthFixture)
 
+BOOST_AUTO_TEST_CASE(StringMapAuthentication1)
+{
+  string_map_authentication custom;
+
+  std::string request_data(request_header);
+  request_data += std::string("Authorization: secret") + CRLF + CRLF;
+  std::string::iterator next(request_data.begin());
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+  BOOST_CHECK(custom.authenticate(request).empty());
+
+  std::string request_data1(request_header);
+  request_data1 += std::string("Authorization: guess") + CRLF + CRLF;
+  next = request_data1.begin();
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> request1;
+  BOOST_CHECK(request1.parse(next, request_data1.end()));
+  BOOST_CHECK_EQUAL("Custom", custom.authenticate(request1));
+}
+
 BOOST_AUTO_TEST_CASE(FailAuthentication1)
 {
   // A request without an Authentication header
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/body_file.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace via::http;
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestBodyFile)
+
+BOOST_AUTO_TEST_CASE(WriteBodyFile1)
+{
+  body_file the_file;
+  BOOST_CHECK(!the_file.is_open());
+  BOOST_CHECK(the_file.map().empty());
+
+  BOOST_REQUIRE(the_file.open());
+  BOOST_CHECK(the_file.is_open());
+  BOOST_CHECK(the_file.fd() >= 0);
+  BOOST_CHECK_EQUAL(0U, the_file.size());
+
+  std::string data("abcdefghijklmnopqrstuvwxyz");
+  BOOST_CHECK(the_file.write(data.data(), 10));
+  BOOST_CHECK_EQUAL(10U, the_file.size());
+  BOOST_CHECK_EQUAL("abcdefghij", the_file.map());
+
+  // the map is updated after more data is written
+  BOOST_CHECK(the_file.write(data.data() + 10, data.size() - 10));
+  BOOST_CHECK_EQUAL(data.size(), the_file.size());
+  BOOST_CHECK_EQUAL(data, the_file.map());
+
+  the_file.close();
+  BOOST_CHECK(!the_file.is_open());
+  BOOST_CHECK_EQUAL(0U, the_file.size());
+}
+
+BOOST_AUTO_TEST_CASE(MoveBodyFile1)
+{
+  body_file the_file;
+  BOOST_REQUIRE(the_file.open());
+  std::string data("abcdefghijklmnopqrstuvwxyz");
+  BOOST_CHECK(the_file.write(data.data(), data.size()));
+  int fd(the_file.fd());
+
+  body_file other_file(std::move(the_file));
+  BOOST_CHECK(!the_file.is_open());
+  BOOST_CHECK_EQUAL(fd, other_file.fd());
+  BOOST_CHECK_EQUAL(data, other_file.map());
+}
+
+BOOST_AUTO_TEST_CASE(InValidBodyFile1)
+{
+  body_file the_file;
+  BOOST_CHECK(!the_file.open("/no/such/directory"));
+  BOOST_CHECK(!the_file.is_open());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -345,6 +345,74 @@ BOOST_AUTO_TEST_CASE(ValidMultipleChunks1)
   BOOST_CHECK(the_chunk.is_last());
 }
 
+BOOST_AUTO_TEST_CASE(ValidChunkFragments1)
+{
+  // a chunk with its data and CRLF split across three buffers
+  std::string chunk_data("f;\r\n12345");
+  std::string::iterator next(chunk_data.begin());
+  std::string_view fragment;
+
+  rx_chunk<std::string, 100, 8190, 1024, 8, true> the_chunk;
+  BOOST_CHECK(!the_chunk.parse(next, chunk_data.end(), fragment));
+  BOOST_CHECK(chunk_data.end() == next);
+  BOOST_CHECK_EQUAL("12345", fragment);
+
+  std::string chunk_data1("6789abcdef\r");
+  next = chunk_data1.begin();
+  BOOST_CHECK(!the_chunk.parse(next, chunk_data1.end(), fragment));
+  BOOST_CHECK(chunk_data1.end() == next);
+  BOOST_CHECK_EQUAL("6789abcdef", fragment);
+
+  std::string chunk_data2("\n0\r\n\r\n");
+  next = chunk_data2.begin();
+  BOOST_CHECK(the_chunk.parse(next, chunk_data2.end(), fragment));
+  BOOST_CHECK(fragment.empty());
+  BOOST_CHECK(the_chunk.data().empty());
+  BOOST_CHECK_EQUAL(15U, the_chunk.size());
+
+  // the last chunk
+  the_chunk.clear();
+  BOOST_CHECK(the_chunk.parse(next, chunk_data2.end(), fragment));
+  BOOST_CHECK(chunk_data2.end() == next);
+  BOOST_CHECK(the_chunk.is_last());
+}
+
+BOOST_AUTO_TEST_CASE(ValidChunkView1)
+{
+  // the chunk data is all in one buffer, but its CRLF isn't
+  std::string chunk_data("5\r\n12345\r");
+  std::string::iterator next(chunk_data.begin());
+
+  rx_chunk<std::string, 100, 8190, 1024, 8, false> the_chunk;
+  BOOST_CHECK(!the_chunk.parse_view(next, chunk_data.end()));
+  BOOST_CHECK(chunk_data.end() == next);
+
+  std::string chunk_data1("\n5\r\nabcde\r\n");
+  next = chunk_data1.begin();
+  BOOST_CHECK(the_chunk.parse_view(next, chunk_data1.end()));
+  BOOST_CHECK_EQUAL("12345", the_chunk.data());
+  BOOST_CHECK_EQUAL("12345", the_chunk.data_view());
+
+  // the next chunk is all in one buffer
+  the_chunk.clear();
+  BOOST_CHECK(the_chunk.parse_view(next, chunk_data1.end()));
+  BOOST_CHECK(chunk_data1.end() == next);
+  BOOST_CHECK(the_chunk.data().empty());
+  BOOST_CHECK_EQUAL("abcde", the_chunk.data_view());
+}
+
+BOOST_AUTO_TEST_CASE(InValidChunkFragments1)
+{
+  // no CRLF after the chunk data
+  std::string chunk_data("5\r\n12345xx");
+  std::string::iterator next(chunk_data.begin());
+  std::string_view fragment;
+
+  rx_chunk<std::string, 100, 8190, 1024, 8, false> the_chunk;
+  BOOST_CHECK(!the_chunk.parse(next, chunk_data.end(), fragment));
+  BOOST_CHECK(chunk_data.end() != next);
+}
+
 BOOST_AUTO_TEST_CASE(ValidMultipleChunks2)
 {
   // As above but without CR's after chunk data
@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/compression.hpp"
+#include "via/http/response.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace via::http;
+
+namespace
+{
+  const bool ALL_CODINGS[content_coding::NUMBER_OF_IDS]
+    { true, true, true, true };
+  const bool GZIP_ONLY[content_coding::NUMBER_OF_IDS]
+    { true, false, true, false };
+
+#ifdef HTTP_ZLIB
+  /// Decompress gzip or deflate data with zlib.
+  std::string inflate_data(std::string const& data, bool gzip)
+  {
+    z_stream stream{};
+    inflateInit2(&stream, gzip ? 31 : 15);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+
+    std::string output;
+    char buffer[4096];
+    int result(Z_OK);
+    do
+    {
+      stream.next_out = reinterpret_cast<Bytef*>(buffer);
+      stream.avail_out = sizeof(buffer);
+      result = inflate(&stream, Z_NO_FLUSH);
+      output.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while ((result == Z_OK) && (stream.avail_in > 0u || stream.avail_out == 0u));
+    inflateEnd(&stream);
+    return output;
+  }
+
+  /// A compressible response body.
+  std::string test_body()
+  {
+    std::string body;
+    for (int i(0); i < 200; ++i)
+      body += "The quick brown fox jumps over the lazy dog " +
+              std::to_string(i) + "\n";
+    return body;
+  }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestContentCoding)
+
+BOOST_AUTO_TEST_CASE(Quality1)
+{
+  BOOST_CHECK_EQUAL(1000, content_coding::quality(""));
+  BOOST_CHECK_EQUAL(0, content_coding::quality("q=0"));
+  BOOST_CHECK_EQUAL(500, content_coding::quality("q=0.5"));
+  BOOST_CHECK_EQUAL(123, content_coding::quality(" Q = 0.123"));
+  BOOST_CHECK_EQUAL(1000, content_coding::quality("q=1.000"));
+  BOOST_CHECK_EQUAL(1000, content_coding::quality("level=1;q=1"));
+  BOOST_CHECK_EQUAL(0, content_coding::quality("q=x"));
+}
+
+BOOST_AUTO_TEST_CASE(Negotiate1)
+{
+  using content_coding::id;
+  using content_coding::negotiate;
+
+  BOOST_CHECK(id::IDENTITY == negotiate("", ALL_CODINGS));
+  BOOST_CHECK(id::IDENTITY == negotiate("identity", ALL_CODINGS));
+  BOOST_CHECK(id::IDENTITY == negotiate("br", ALL_CODINGS));
+  BOOST_CHECK(id::GZIP == negotiate("gzip", ALL_CODINGS));
+  BOOST_CHECK(id::GZIP == negotiate("X-GZIP", ALL_CODINGS));
+  BOOST_CHECK(id::DEFLATE == negotiate("deflate", ALL_CODINGS));
+
+  // the preferred coding is chosen if the qualities are equal
+  BOOST_CHECK(id::ZSTD == negotiate("gzip, deflate, br, zstd", ALL_CODINGS));
+  BOOST_CHECK(id::GZIP == negotiate("gzip, deflate, br, zstd", GZIP_ONLY));
+
+  // otherwise the highest quality is chosen
+  BOOST_CHECK(id::DEFLATE == negotiate("gzip;q=0.5, deflate", ALL_CODINGS));
+  BOOST_CHECK(id::GZIP == negotiate("zstd;q=0, gzip;q=0.1", ALL_CODINGS));
+  BOOST_CHECK(id::IDENTITY == negotiate("gzip;q=0.5, identity", ALL_CODINGS));
+  BOOST_CHECK(id::IDENTITY == negotiate("gzip;q=0", ALL_CODINGS));
+
+  // * matches the codings that are not listed
+  BOOST_CHECK(id::ZSTD == negotiate("*", ALL_CODINGS));
+  BOOST_CHECK(id::DEFLATE == negotiate("*;q=0.5, zstd;q=0, gzip;q=0",
+                                       ALL_CODINGS));
+  BOOST_CHECK(id::IDENTITY == negotiate("*;q=0", ALL_CODINGS));
+}
+
+#ifdef HTTP_ZLIB
+BOOST_AUTO_TEST_CASE(Compress1)
+{
+  std::string body(test_body());
+
+  std::string gzip_body;
+  BOOST_REQUIRE(compress(content_coding::id::GZIP, 6, body, gzip_body));
+  BOOST_CHECK(gzip_body.size() < body.size());
+  BOOST_CHECK_EQUAL(body, inflate_data(gzip_body, true));
+
+  std::string deflate_body;
+  BOOST_REQUIRE(compress(content_coding::id::DEFLATE, 1, body, deflate_body));
+  BOOST_CHECK_EQUAL(body, inflate_data(deflate_body, false));
+
+  // identity is not a compression
+  std::string output;
+  BOOST_CHECK(!compress(content_coding::id::IDENTITY, 6, body, output));
+}
+
+BOOST_AUTO_TEST_CASE(CompressStream1)
+{
+  std::string body(test_body());
+
+  compressor stream;
+  BOOST_CHECK(!stream.is_open());
+  BOOST_REQUIRE(stream.open(content_coding::id::GZIP));
+  BOOST_CHECK(stream.is_open());
+
+  // each chunk is flushed, so it can be sent immediately
+  std::string output;
+  BOOST_CHECK(stream.compress(body.data(), 100u, output, false));
+  BOOST_CHECK(!output.empty());
+  BOOST_CHECK_EQUAL(body.substr(0u, 100u), inflate_data(output, true));
+
+  BOOST_CHECK(stream.compress(body.data() + 100u, body.size() - 100u,
+                              output, false));
+  BOOST_CHECK(stream.compress(nullptr, 0u, output, true));
+  BOOST_CHECK_EQUAL(body, inflate_data(output, true));
+
+  stream.close();
+  BOOST_CHECK(!stream.is_open());
+}
+
+BOOST_AUTO_TEST_CASE(CachedResponseVariants1)
+{
+  std::string body(test_body());
+  tx_response response(response_status::code::OK);
+  response.add_header(header_field::id::CONTENT_TYPE, "text/plain");
+
+  cached_response<std::string> cached(response, body,
+                                      std::chrono::steady_clock::now(), 6);
+  BOOST_CHECK(cached.is_compressed());
+  BOOST_CHECK(cached.is_available(content_coding::id::IDENTITY));
+  BOOST_CHECK(cached.is_available(content_coding::id::GZIP));
+  BOOST_CHECK_EQUAL(body, cached.body());
+  BOOST_CHECK_EQUAL(body,
+    inflate_data(cached.body(content_coding::id::GZIP), true));
+
+  BOOST_CHECK(cached.headers().find("Vary: Accept-Encoding\r\n")
+              != std::string::npos);
+  BOOST_CHECK(cached.headers().find("Content-Encoding") == std::string::npos);
+  std::string const& gzip_headers(cached.headers(content_coding::id::GZIP));
+  BOOST_CHECK(gzip_headers.find("Content-Encoding: gzip\r\n")
+              != std::string::npos);
+  BOOST_CHECK(gzip_headers.find("Content-Length: " +
+    std::to_string(cached.body(content_coding::id::GZIP).size()) + "\r\n")
+              != std::string::npos);
+
+  // Only the identity variant has no ETag
+  BOOST_CHECK(cached.etag().empty());
+  BOOST_CHECK(cached.etag(content_coding::id::GZIP).empty());
+
+  // A body below the threshold is not compressed
+  cached_response<std::string> small(response, "small",
+                                     std::chrono::steady_clock::now(), 6);
+  BOOST_CHECK(!small.is_compressed());
+  BOOST_CHECK(small.headers().find("Vary") == std::string::npos);
+
+  // Nor is a response with a Content-Encoding
+  response.add_header(header_field::id::CONTENT_ENCODING, "br");
+  BOOST_CHECK(response.has_content_encoding());
+  BOOST_CHECK(!response.is_compressible());
+  cached_response<std::string> encoded(response, body,
+                                       std::chrono::steady_clock::now(), 6);
+  BOOST_CHECK(!encoded.is_compressed());
+}
+
+BOOST_AUTO_TEST_CASE(CachedResponseEtag1)
+{
+  std::string body(test_body());
+  tx_response response(response_status::code::OK);
+  response.add_header(header_field::id::ETAG, "\"ef46db3751d8e999\"");
+
+  // The ETags of the compressed variants are weak
+  cached_response<std::string> cached(response, body,
+                                      std::chrono::steady_clock::now(), 6);
+  BOOST_REQUIRE(cached.is_available(content_coding::id::GZIP));
+  BOOST_CHECK_EQUAL("\"ef46db3751d8e999\"", cached.etag());
+  BOOST_CHECK_EQUAL("W/\"ef46db3751d8e999\"",
+                    cached.etag(content_coding::id::GZIP));
+  BOOST_CHECK(cached.headers().find("ETag: \"ef46db3751d8e999\"\r\n")
+              != std::string::npos);
+  BOOST_CHECK(cached.headers(content_coding::id::GZIP).find
+                ("ETag: W/\"ef46db3751d8e999\"\r\n") != std::string::npos);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
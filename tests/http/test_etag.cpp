@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/etag.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace via::http;
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestEtag)
+
+BOOST_AUTO_TEST_CASE(Hash64_1)
+{
+  // Test vectors of the reference implementation, on a little endian host
+  std::string_view empty;
+  BOOST_CHECK_EQUAL(0xEF46DB3751D8E999ULL, hash64(empty.data(), 0u));
+  std::string_view abc("abc");
+  BOOST_CHECK_EQUAL(0x44BC2CF5AD770999ULL, hash64(abc.data(), abc.size()));
+  std::string_view text("Nobody inspects the spammish repetition");
+  BOOST_CHECK_EQUAL(0xFBCEA83C8A378BF1ULL, hash64(text.data(), text.size()));
+
+  // A different seed gives a different hash
+  BOOST_CHECK(hash64(abc.data(), abc.size(), 1u) !=
+              hash64(abc.data(), abc.size()));
+}
+
+BOOST_AUTO_TEST_CASE(MakeEtag1)
+{
+  BOOST_CHECK_EQUAL("\"ef46db3751d8e999\"", make_etag(""));
+
+  // the hash is padded to 16 hex digits
+  auto etag(make_etag("some response body"));
+  BOOST_CHECK_EQUAL(18U, etag.size());
+  BOOST_CHECK_EQUAL('"', etag.front());
+  BOOST_CHECK_EQUAL('"', etag.back());
+  BOOST_CHECK(etag != make_etag("some response body."));
+}
+
+BOOST_AUTO_TEST_CASE(EtagMatches1)
+{
+  BOOST_CHECK(etag_matches("\"abc\"", "\"abc\""));
+  BOOST_CHECK(etag_matches("\"xyz\", W/\"abc\"", "\"abc\""));
+  BOOST_CHECK(etag_matches("*", "\"abc\""));
+  BOOST_CHECK(!etag_matches("\"abcd\"", "\"abc\""));
+  BOOST_CHECK(!etag_matches("", "\"abc\""));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -62,6 +62,76 @@ BOOST_AUTO_TEST_CASE(ToHeaderDate)
   BOOST_CHECK(!memcmp(end.c_str(), result.c_str() + 31, end.size()));
 }
 
+BOOST_AUTO_TEST_CASE(FormatDate1)
+{
+  char date[header_field::DATE_LENGTH];
+
+  header_field::format_date(0, date);
+  BOOST_CHECK_EQUAL("Thu, 01 Jan 1970 00:00:00 GMT",
+                    std::string(date, header_field::DATE_LENGTH));
+
+  // The example from RFC7231 section 7.1.1.1
+  header_field::format_date(784111777, date);
+  BOOST_CHECK_EQUAL("Sun, 06 Nov 1994 08:49:37 GMT",
+                    std::string(date, header_field::DATE_LENGTH));
+
+  // A leap day
+  header_field::format_date(951782400, date);
+  BOOST_CHECK_EQUAL("Tue, 29 Feb 2000 00:00:00 GMT",
+                    std::string(date, header_field::DATE_LENGTH));
+
+  header_field::format_date(4102444799, date);
+  BOOST_CHECK_EQUAL("Thu, 31 Dec 2099 23:59:59 GMT",
+                    std::string(date, header_field::DATE_LENGTH));
+}
+
+BOOST_AUTO_TEST_CASE(ParseDate1)
+{
+  BOOST_CHECK_EQUAL(0, header_field::parse_date("Thu, 01 Jan 1970 00:00:00 GMT"));
+  BOOST_CHECK_EQUAL(784111777,
+                    header_field::parse_date("Sun, 06 Nov 1994 08:49:37 GMT"));
+  BOOST_CHECK_EQUAL(951782400,
+                    header_field::parse_date("Tue, 29 Feb 2000 00:00:00 GMT"));
+
+  // parse_date is the inverse of format_date
+  char date[header_field::DATE_LENGTH];
+  for (std::time_t time(0); time < 4102444800; time += 86399 * 7)
+  {
+    header_field::format_date(time, date);
+    BOOST_CHECK_EQUAL(time, header_field::parse_date
+                        (std::string_view(date, header_field::DATE_LENGTH)));
+  }
+
+  // Invalid dates
+  BOOST_CHECK_EQUAL(-1, header_field::parse_date(""));
+  BOOST_CHECK_EQUAL(-1, header_field::parse_date("Sunday, 06-Nov-94 08:49:37 GMT"));
+  BOOST_CHECK_EQUAL(-1, header_field::parse_date("Sun, 06 Nox 1994 08:49:37 GMT"));
+  BOOST_CHECK_EQUAL(-1, header_field::parse_date("Sun, 06 Nov 1994 28:49:37 GMT"));
+  BOOST_CHECK_EQUAL(-1, header_field::parse_date("Sun, 0x Nov 1994 08:49:37 GMT"));
+}
+
+BOOST_AUTO_TEST_CASE(DateCache1)
+{
+  char expected[header_field::DATE_LENGTH];
+  char date[header_field::DATE_LENGTH];
+
+  // Retry if the second changes between reading the time and the cache.
+  bool matched(false);
+  for (int i(0); !matched && (i < 3); ++i)
+  {
+    auto now(std::time(nullptr));
+    header_field::format_date(now, expected);
+    header_field::DATE_CACHE.read(date);
+    matched = !memcmp(expected, date, header_field::DATE_LENGTH);
+  }
+  BOOST_CHECK(matched);
+
+  std::string output("prefix");
+  header_field::append_date_header(output);
+  BOOST_CHECK_EQUAL(6u + 6u + header_field::DATE_LENGTH + 2u, output.size());
+  BOOST_CHECK_EQUAL(0u, output.find("prefixDate: "));
+}
+
 BOOST_AUTO_TEST_CASE(ServerHeader)
 {
   std::string line("Server: Via-httplib\r\n");
@@ -430,6 +430,41 @@ BOOST_AUTO_TEST_CASE(ValidExpectContinue1)
   BOOST_CHECK(the_headers.expect_continue());
 }
 
+BOOST_AUTO_TEST_CASE(ValidFramingMetadata1)
+{
+  // Mixed case values and a repeated Connection field
+  std::string HEADER_LINE("Transfer-Encoding: Chunked\r\n");
+  HEADER_LINE += "Connection: Keep-Alive\r\n";
+  HEADER_LINE += "Host: localhost\r\n";
+  HEADER_LINE += "Connection: CLOSE\r\n\r\n";
+  std::vector<char> header_data(HEADER_LINE.begin(), HEADER_LINE.end());
+  std::vector<char>::iterator header_next(header_data.begin());
+
+  message_headers<100, 8190, 1024, 8, false> the_headers;
+  BOOST_CHECK(the_headers.parse(header_next, header_data.end()));
+  BOOST_CHECK(header_data.end() == header_next);
+
+  BOOST_CHECK(the_headers.is_chunked());
+  BOOST_CHECK(the_headers.close_connection());
+  BOOST_CHECK(the_headers.has_host());
+  BOOST_CHECK(!the_headers.expect_continue());
+  BOOST_CHECK_EQUAL(0, the_headers.content_length());
+
+  // clear resets the metadata
+  the_headers.clear();
+  BOOST_CHECK(!the_headers.is_chunked());
+  BOOST_CHECK(!the_headers.close_connection());
+  BOOST_CHECK(!the_headers.has_host());
+
+  std::string HEADER_LINE2("Transfer-Encoding: Identity\r\n");
+  HEADER_LINE2 += "Content-Length: 12\r\n\r\n";
+  std::vector<char> header_data2(HEADER_LINE2.begin(), HEADER_LINE2.end());
+  header_next = header_data2.begin();
+  BOOST_CHECK(the_headers.parse(header_next, header_data2.end()));
+  BOOST_CHECK(!the_headers.is_chunked());
+  BOOST_CHECK_EQUAL(12, the_headers.content_length());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -501,14 +536,9 @@ BOOST_AUTO_TEST_CASE(ValidCookieHeader1)
     the_headers.find
     (header_field::id::TRANSFER_ENCODING).data());
 
-// Visual Studio outputs string in different order to GCC and Clang
-#ifdef _MSC_VER
+  // The headers are output in the order that they were received
   std::string HEADER_STRING("set-cookie: abcdefg hijkl\r\n");
   HEADER_STRING += "transfer-encoding: Chunked\r\n";
-#else
-  std::string HEADER_STRING("transfer-encoding: Chunked\r\n");
-  HEADER_STRING += "set-cookie: abcdefg hijkl\r\n";
-#endif
   auto header_str(the_headers.to_string());
   BOOST_CHECK_EQUAL(HEADER_STRING, header_str);
 }
@@ -559,3 +589,147 @@ BOOST_AUTO_TEST_CASE(ValidRepeatedHeader1)
 
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestHeaderFields)
+
+BOOST_AUTO_TEST_CASE(StandardHeaderIds1)
+{
+  for (size_t i(0u); i < header_field::NUMBER_OF_IDS; ++i)
+  {
+    auto field_id(static_cast<header_field::id>(i));
+    BOOST_CHECK(field_id ==
+                header_field::find_id(header_field::lowercase_name(field_id)));
+  }
+
+  BOOST_CHECK(header_field::id::EXTENSION_HEADER ==
+              header_field::find_id("set-cookie"));
+  BOOST_CHECK(header_field::id::EXTENSION_HEADER ==
+              header_field::find_id("Host"));
+  BOOST_CHECK(header_field::id::EXTENSION_HEADER ==
+              header_field::find_id(""));
+}
+
+BOOST_AUTO_TEST_CASE(ValidHeaderFields1)
+{
+  header_fields fields;
+  fields.add("host", "localhost", ',');
+  fields.add("x-request-id", "1234", ',');
+  fields.add("accept", "text/html", ',');
+  fields.add("accept", "application/json", ',');
+  fields.add("x-request-id", "5678", ',');
+
+  BOOST_CHECK_EQUAL(3u, fields.size());
+  BOOST_CHECK_EQUAL("localhost", fields.find(header_field::id::HOST));
+  BOOST_CHECK_EQUAL("localhost", fields.find("host"));
+  BOOST_CHECK_EQUAL("text/html,application/json",
+                    fields.find(header_field::id::ACCEPT));
+  BOOST_CHECK_EQUAL("1234,5678", fields.find("x-request-id"));
+  BOOST_CHECK(fields.find(header_field::id::CONTENT_LENGTH).empty());
+  BOOST_CHECK(fields.find("x-missing").empty());
+
+  auto iter(fields.begin());
+  BOOST_CHECK_EQUAL("host", (*iter).first);
+  BOOST_CHECK_EQUAL("x-request-id", (*++iter).first);
+  BOOST_CHECK_EQUAL("accept", (*++iter).first);
+  BOOST_CHECK(fields.end() == ++iter);
+
+  fields.clear();
+  BOOST_CHECK(fields.empty());
+  BOOST_CHECK(fields.find(header_field::id::HOST).empty());
+  BOOST_CHECK(fields.find("x-request-id").empty());
+
+  fields.add("accept", "*/*", ',');
+  BOOST_CHECK_EQUAL(1u, fields.size());
+  BOOST_CHECK_EQUAL("*/*", fields.find(header_field::id::ACCEPT));
+  BOOST_CHECK(fields.find(header_field::id::HOST).empty());
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedHeaderFields1)
+{
+  // Consecutive repeated fields are appended to the value in place
+  header_fields fields;
+  fields.add("host", "localhost", ',');
+  fields.add("x-list", "0", ',');
+  auto offset(fields.find("x-list").data() - fields.find("host").data());
+  std::string expected("0");
+  for (int i(1); i < 1000; ++i)
+  {
+    fields.add("x-list", std::to_string(i), ',');
+    expected += ',' + std::to_string(i);
+    BOOST_CHECK_EQUAL(offset,
+                      fields.find("x-list").data() - fields.find("host").data());
+  }
+  BOOST_CHECK_EQUAL(expected, fields.find("x-list"));
+  BOOST_CHECK_EQUAL('\0', *(fields.find("x-list").end()));
+
+  // Interleaved repeated fields are copied, and the buffer compacted
+  header_fields interleaved;
+  std::string expected_accept("a/0");
+  std::string expected_list("0");
+  interleaved.add("accept", "a/0", ',');
+  interleaved.add("x-list", "0", ',');
+  for (int i(1); i < 100; ++i)
+  {
+    interleaved.add("accept", "a/" + std::to_string(i), ',');
+    interleaved.add("x-list", std::to_string(i), ',');
+    expected_accept += ",a/" + std::to_string(i);
+    expected_list += ',' + std::to_string(i);
+  }
+  BOOST_CHECK_EQUAL(2u, interleaved.size());
+  BOOST_CHECK_EQUAL(expected_accept, interleaved.find(header_field::id::ACCEPT));
+  BOOST_CHECK_EQUAL(expected_list, interleaved.find("x-list"));
+  BOOST_CHECK_EQUAL('\0', *(interleaved.find("x-list").end()));
+
+  size_t count(0u);
+  for (auto const& [name, value] : interleaved)
+  {
+    BOOST_CHECK_EQUAL((count == 0u) ? "accept" : "x-list", name);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(2u, count);
+}
+
+BOOST_AUTO_TEST_CASE(InlineHeaderFields1)
+{
+  // More fields than are held inside the object
+  header_fields fields;
+  const size_t number(header_fields::INLINE_FIELDS + 4u);
+  for (size_t i(0u); i < number; ++i)
+    fields.add("x-field-" + std::to_string(i), std::to_string(i), ',');
+  fields.add("host", "localhost", ',');
+
+  BOOST_CHECK_EQUAL(number + 1u, fields.size());
+  BOOST_CHECK_EQUAL("localhost", fields.find(header_field::id::HOST));
+  BOOST_CHECK_EQUAL("0", fields.find("x-field-0"));
+  BOOST_CHECK_EQUAL("19", fields.find("x-field-19"));
+
+  size_t count(0u);
+  for (auto const& [name, value] : fields)
+  {
+    if (count < number)
+      BOOST_CHECK_EQUAL(std::to_string(count), value);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(number + 1u, count);
+
+  auto map(fields.to_map());
+  BOOST_CHECK_EQUAL(number + 1u, map.size());
+  BOOST_CHECK_EQUAL("localhost", map["host"]);
+
+  // Swapping and clearing move the fields back inside the object
+  header_fields other;
+  other.add("accept", "*/*", ',');
+  fields.swap(other);
+  BOOST_CHECK_EQUAL(1u, fields.size());
+  BOOST_CHECK_EQUAL("localhost", other.find(header_field::id::HOST));
+
+  other.clear();
+  BOOST_CHECK(other.empty());
+  other.add("host", "example.com", ',');
+  BOOST_CHECK_EQUAL("example.com", other.find(header_field::id::HOST));
+  BOOST_CHECK(other.find("x-field-0").empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/load_shedder.hpp"
+#include <boost/test/unit_test.hpp>
+
+using namespace via::http;
+
+namespace
+{
+  const std::chrono::milliseconds TARGET(5);
+  const std::chrono::milliseconds INTERVAL(100);
+  const std::chrono::milliseconds LOW_DELAY(1);
+  const std::chrono::milliseconds HIGH_DELAY(10);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestLoadShedder)
+
+BOOST_AUTO_TEST_CASE(LoadShedderOverload1)
+{
+  load_shedder shedder(TARGET, INTERVAL);
+  load_shedder::clock::time_point start;
+  start += std::chrono::seconds(1);
+
+  // A burst of delays within an interval isn't an overload
+  shedder.record(HIGH_DELAY, start);
+  shedder.record(LOW_DELAY, start + std::chrono::milliseconds(50));
+  shedder.record(HIGH_DELAY, start + INTERVAL);
+  BOOST_CHECK(!shedder.is_overloaded());
+  BOOST_CHECK(!shedder.shed(route_priority::LOW, start + INTERVAL));
+
+  // The delay stays above the target for an interval
+  shedder.record(HIGH_DELAY, start + std::chrono::milliseconds(150));
+  shedder.record(HIGH_DELAY, start + 2 * INTERVAL);
+  BOOST_CHECK(shedder.is_overloaded());
+  BOOST_CHECK(shedder.stats().delay == HIGH_DELAY);
+
+  // A delay below the target ends the overload
+  shedder.record(LOW_DELAY, start + std::chrono::milliseconds(210));
+  BOOST_CHECK(!shedder.is_overloaded());
+  BOOST_CHECK(!shedder.stats().overloaded);
+}
+
+BOOST_AUTO_TEST_CASE(LoadShedderPriority1)
+{
+  load_shedder shedder(TARGET, INTERVAL);
+  load_shedder::clock::time_point start;
+  start += std::chrono::seconds(1);
+  shedder.record(HIGH_DELAY, start);
+  shedder.record(HIGH_DELAY, start + INTERVAL);
+  BOOST_REQUIRE(shedder.is_overloaded());
+
+  auto now(start + INTERVAL);
+  BOOST_CHECK(!shedder.shed(route_priority::HIGH, now));
+  BOOST_CHECK(shedder.shed(route_priority::LOW, now));
+  BOOST_CHECK(shedder.shed(route_priority::LOW, now));
+
+  // NORMAL requests are shed at intervals of INTERVAL / sqrt(count)
+  BOOST_CHECK(shedder.shed(route_priority::NORMAL, now));
+  BOOST_CHECK(!shedder.shed(route_priority::NORMAL, now));
+  BOOST_CHECK(!shedder.shed(route_priority::NORMAL,
+                            now + std::chrono::milliseconds(99)));
+  now += INTERVAL;
+  BOOST_CHECK(shedder.shed(route_priority::NORMAL, now));
+  BOOST_CHECK(!shedder.shed(route_priority::NORMAL,
+                            now + std::chrono::milliseconds(70)));
+  now += std::chrono::milliseconds(71); // 100ms / sqrt(2)
+  BOOST_CHECK(shedder.shed(route_priority::NORMAL, now));
+
+  auto stats(shedder.stats());
+  BOOST_CHECK(stats.overloaded);
+  BOOST_CHECK_EQUAL(2U, stats.shed_low);
+  BOOST_CHECK_EQUAL(3U, stats.shed_normal);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -11,6 +11,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "via/http/request.hpp"
 #include <boost/test/unit_test.hpp>
+#include <cstring>
 #include <vector>
 #include <iostream>
 #include <limits>
@@ -36,6 +37,23 @@ BOOST_AUTO_TEST_CASE(RequestMethod1)
   BOOST_CHECK_EQUAL("OPTIONS", request_method::name(request_method::id::OPTIONS));
 }
 
+BOOST_AUTO_TEST_CASE(RequestMethodId1)
+{
+  for (size_t i(0u); i < request_method::NUMBER_OF_IDS; ++i)
+  {
+    auto method_id(static_cast<request_method::id>(i));
+    BOOST_CHECK(method_id ==
+                request_method::find_id(request_method::name(method_id)));
+  }
+
+  BOOST_CHECK(request_method::id::EXTENSION_METHOD ==
+              request_method::find_id("PATCH"));
+  BOOST_CHECK(request_method::id::EXTENSION_METHOD ==
+              request_method::find_id("get"));
+  BOOST_CHECK(request_method::id::EXTENSION_METHOD ==
+              request_method::find_id(""));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -75,6 +93,42 @@ BOOST_AUTO_TEST_CASE(ValidGetVectorUnsignedChar1)
 }
 
 // An http request line in a string.
+BOOST_AUTO_TEST_CASE(ValidMethodId1)
+{
+  std::string request_data("HEAD /abcde HTTP/1.1\r\n\r\n");
+  std::string::iterator next(request_data.begin());
+
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> the_request;
+  BOOST_CHECK(the_request.parse(next, request_data.end()));
+  BOOST_CHECK(request_method::id::HEAD == the_request.method_id());
+  BOOST_CHECK(the_request.is_head());
+  BOOST_CHECK(!the_request.is_trace());
+
+  the_request.clear();
+  request_data = "PATCH /abcde HTTP/1.1\r\n\r\n";
+  next = request_data.begin();
+  BOOST_CHECK(the_request.parse(next, request_data.end()));
+  BOOST_CHECK(request_method::id::EXTENSION_METHOD == the_request.method_id());
+  BOOST_CHECK_EQUAL("PATCH", the_request.method().c_str());
+}
+
+BOOST_AUTO_TEST_CASE(ValidGetHost1)
+{
+  std::string request_data("GET abcde HTTP/1.1\r\n");
+  request_data += "Host:\r\n";
+  request_data += "Connection: Close\r\n\r\n";
+  std::string::iterator next(request_data.begin());
+
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> the_request;
+  BOOST_CHECK(the_request.parse(next, request_data.end()));
+  BOOST_CHECK(request_data.end() == next);
+
+  // an empty Host field is treated as missing
+  BOOST_CHECK(the_request.missing_host_header());
+  BOOST_CHECK(!the_request.keep_alive());
+  BOOST_CHECK(!the_request.expect_continue());
+}
+
 BOOST_AUTO_TEST_CASE(ValidGet1)
 {
   std::string request_data("GET abcdefghijklmnopqrstuvwxyz HTTP/1.0\r\n");
@@ -569,6 +623,85 @@ BOOST_AUTO_TEST_CASE(InValidPostLength1)
   BOOST_CHECK(!the_request.parse(next, request_data.end()));
 }
 
+BOOST_AUTO_TEST_CASE(ValidHeadFastPath1)
+{
+  std::string request_data("GET /index.html?a=b HTTP/1.1\r\n");
+  request_data += "Host: www.example.com\r\n";
+  request_data += "User-Agent: Mozilla/5.0\r\n";
+  request_data += "Accept: text/html\r\n";
+  request_data += "Cookie: a=1\r\n";
+  request_data += "COOKIE:   b=2\r\n\r\n";
+  request_data += "body";
+
+  // parse the whole head in a contiguous buffer
+  std::string::iterator next(request_data.begin());
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> fast_request;
+  BOOST_CHECK(fast_request.parse(next, request_data.end()));
+  BOOST_CHECK_EQUAL("body", std::string(next, request_data.end()));
+
+  // parse the same head incrementally
+  std::string::iterator next1(request_data.begin());
+  std::string::iterator end1(request_data.begin() + 20);
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> the_request;
+  BOOST_CHECK(!the_request.parse(next1, end1));
+  BOOST_CHECK(the_request.parse(next1, request_data.end()));
+  BOOST_CHECK(next == next1);
+
+  BOOST_CHECK_EQUAL(the_request.method(), fast_request.method());
+  BOOST_CHECK(the_request.method_id() == fast_request.method_id());
+  BOOST_CHECK_EQUAL(the_request.uri(), fast_request.uri());
+  BOOST_CHECK_EQUAL(the_request.minor_version(), fast_request.minor_version());
+  BOOST_CHECK_EQUAL(the_request.headers().to_string(),
+                    fast_request.headers().to_string());
+  BOOST_CHECK_EQUAL(the_request.headers().length(),
+                    fast_request.headers().length());
+  BOOST_CHECK_EQUAL("a=1;b=2", fast_request.headers().find("cookie"));
+}
+
+BOOST_AUTO_TEST_CASE(ValidHeadFastPath2)
+{
+  // folded header lines and extra whitespace are parsed incrementally
+  std::string request_data("GET  /abcde HTTP/1.1\r\n");
+  request_data += "Host: www.example.com\r\n";
+  request_data += "Accept: text/html,\r\n";
+  request_data += "  text/plain\r\n\r\n";
+  std::vector<char> buffer(request_data.begin(), request_data.end());
+  std::vector<char>::const_iterator next(buffer.cbegin());
+
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> the_request;
+  BOOST_CHECK(the_request.parse(next, buffer.cend()));
+  BOOST_CHECK(buffer.cend() == next);
+  BOOST_CHECK_EQUAL("/abcde", the_request.uri().c_str());
+  BOOST_CHECK_EQUAL("text/html, text/plain",
+                    the_request.headers().find(header_field::id::ACCEPT));
+}
+
+BOOST_AUTO_TEST_CASE(InValidHeadFastPath1)
+{
+  std::string request_data("GET /abcde HTTP/1.1\r\n");
+  request_data += "Host: www.example.com\r\n";
+  request_data += "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n\r\n";
+  std::string::iterator next(request_data.begin());
+
+  // set max message header length to 32
+  rx_request<1024, 8, 100, 32, 1024, 8, true> the_request;
+  BOOST_CHECK(!the_request.parse(next, request_data.end()));
+  BOOST_CHECK(request_data.begin() == next);
+}
+
+BOOST_AUTO_TEST_CASE(InValidHeadFastPath2)
+{
+  // bare line feeds are rejected by the incremental parser if STRICT_CRLF
+  std::string request_data("GET /abcde HTTP/1.1\r\n");
+  request_data += "Host: www.example.com\n";
+  request_data += "Accept: text/html\r\n\r\n";
+  std::string::iterator next(request_data.begin());
+
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> the_request;
+  BOOST_CHECK(!the_request.parse(next, request_data.end()));
+  BOOST_CHECK(request_data.end() != next);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -624,6 +757,25 @@ BOOST_AUTO_TEST_CASE(RequestEncode4)
   BOOST_CHECK_EQUAL(correct_request.c_str(), req_text.c_str());
 }
 
+BOOST_AUTO_TEST_CASE(RequestEncodeSerialize1)
+{
+  tx_request the_request(request_method::id::PUT, "/uri",
+                         "transfer-encoding: chunked\r\n", '1', '0');
+  BOOST_CHECK(the_request.has_transfer_encoding());
+  BOOST_CHECK(!the_request.has_content_length());
+
+  std::string output("prefix ");
+  the_request.serialize(output);
+  BOOST_CHECK_EQUAL("prefix PUT /uri HTTP/1.0\r\n"
+                    "transfer-encoding: chunked\r\n\r\n", output);
+
+  the_request.set_header_string("");
+  the_request.add_header(header_field::id::CONTENT_LENGTH, "4");
+  BOOST_CHECK(the_request.has_content_length());
+  BOOST_CHECK_EQUAL("PUT /uri HTTP/1.0\r\nContent-Length: 4\r\n\r\n",
+                    the_request.message(4));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -1279,6 +1431,333 @@ BOOST_AUTO_TEST_CASE(LoopbackPut2)
   BOOST_CHECK(rx_state == Rx::VALID);
 }
 
+BOOST_AUTO_TEST_CASE(StreamBody1)
+{
+  // A PUT request with its body in fragments, followed by a GET request.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_body("abcdefghijklmnopqrstuvwxyz");
+  std::string request_data(client_request.message(request_body.size()));
+  request_data += request_body.substr(0, 10);
+
+  std::string::iterator iter(request_data.begin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_stream_body(true);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.end()));
+  BOOST_CHECK(rx_state == Rx::HEADERS);
+  BOOST_CHECK(the_request_receiver.body().empty());
+
+  rx_state = the_request_receiver.receive(iter, request_data.end());
+  BOOST_CHECK(iter == request_data.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK_EQUAL("abcdefghij", the_request_receiver.fragment());
+  BOOST_CHECK(!the_request_receiver.body_complete());
+
+  std::string request_data2(request_body.substr(10));
+  request_data2 += "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  iter = request_data2.begin();
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(iter != request_data2.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK_EQUAL("klmnopqrstuvwxyz", the_request_receiver.fragment());
+  BOOST_CHECK(the_request_receiver.body_complete());
+  BOOST_CHECK(the_request_receiver.body().empty());
+
+  // a request without a body is not streamed
+  the_request_receiver.clear();
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(iter == request_data2.end());
+  BOOST_CHECK(rx_state == Rx::VALID);
+}
+
+BOOST_AUTO_TEST_CASE(StreamBody2)
+{
+  // A chunked POST request with its chunk data in fragments.
+  tx_request client_request(request_method::POST, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  client_request.add_header(header_field::HEADER_TRANSFER_ENCODING, "Chunked");
+  std::string request_data(client_request.message());
+  request_data += "a\r\n0123456789\r\n";
+  request_data += "5\r\nabc";
+
+  std::string::iterator iter(request_data.begin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_stream_body(true);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.end()));
+  BOOST_CHECK(rx_state == Rx::HEADERS);
+
+  rx_state = the_request_receiver.receive(iter, request_data.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK_EQUAL("0123456789", the_request_receiver.fragment());
+
+  rx_state = the_request_receiver.receive(iter, request_data.end());
+  BOOST_CHECK(iter == request_data.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK_EQUAL("abc", the_request_receiver.fragment());
+  BOOST_CHECK(!the_request_receiver.body_complete());
+
+  std::string request_data2("de\r\n0\r\n\r\n");
+  iter = request_data2.begin();
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK_EQUAL("de", the_request_receiver.fragment());
+  BOOST_CHECK(!the_request_receiver.body_complete());
+
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(iter == request_data2.end());
+  BOOST_CHECK(rx_state == Rx::BODY);
+  BOOST_CHECK(the_request_receiver.fragment().empty());
+  BOOST_CHECK(the_request_receiver.body_complete());
+}
+
+BOOST_AUTO_TEST_CASE(StreamBody3)
+{
+  // A streamed body must still be within the maximum content length.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_data(client_request.message(26));
+
+  std::string::iterator iter(request_data.begin());
+  http_request_receiver the_request_receiver(25, 25);
+  the_request_receiver.set_stream_body(true);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.end()));
+  BOOST_CHECK(rx_state == Rx::INVALID);
+  BOOST_CHECK(the_request_receiver.response_code() ==
+              response_status::code::PAYLOAD_TOO_LARGE);
+}
+
+BOOST_AUTO_TEST_CASE(DirectReadBody1)
+{
+  // A PUT request with a large body, the rest of it is read directly.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_body("abcdefghijklmnopqrstuvwxyz");
+  std::string request_data(client_request.message(request_body.size()));
+  request_data += request_body.substr(0, 10);
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_direct_read_threshold(20);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(iter == request_data.cend());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK_EQUAL(26U, the_request_receiver.body().size());
+  BOOST_CHECK_EQUAL(16U, the_request_receiver.body_remaining());
+
+  // read part of the rest of the body directly into the body
+  char* space(the_request_receiver.body_space());
+  BOOST_REQUIRE(space != nullptr);
+  std::memcpy(space, request_body.data() + 10, 6);
+  const char* next(space);
+  rx_state = the_request_receiver.receive(next, next + 6);
+  BOOST_CHECK(next == space + 6);
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK_EQUAL(10U, the_request_receiver.body_remaining());
+
+  // the rest of the body from a receive buffer, followed by another request
+  std::string request_data2(request_body.substr(16));
+  request_data2 += "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  iter = request_data2.cbegin();
+  rx_state = the_request_receiver.receive(iter, request_data2.cend());
+  BOOST_CHECK(iter != request_data2.cend());
+  BOOST_CHECK(rx_state == Rx::VALID);
+  std::string body(the_request_receiver.body().begin(),
+                   the_request_receiver.body().end());
+  BOOST_CHECK_EQUAL(request_body, body);
+  BOOST_CHECK_EQUAL(0U, the_request_receiver.body_remaining());
+
+  // a request without a body is not read directly
+  the_request_receiver.clear();
+  BOOST_CHECK(the_request_receiver.body_space() == nullptr);
+  rx_state = the_request_receiver.receive(iter, request_data2.cend());
+  BOOST_CHECK(iter == request_data2.cend());
+  BOOST_CHECK(rx_state == Rx::VALID);
+  BOOST_CHECK(the_request_receiver.body().empty());
+}
+
+BOOST_AUTO_TEST_CASE(DirectReadBody2)
+{
+  // A PUT request with a body below the threshold is not read directly.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_data(client_request.message(26));
+  request_data += "abcdefghij";
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_direct_read_threshold(27);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK_EQUAL(10U, the_request_receiver.body().size());
+  BOOST_CHECK_EQUAL(0U, the_request_receiver.body_remaining());
+  BOOST_CHECK(the_request_receiver.body_space() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(DirectReadBody3)
+{
+  // A request cleared while the rest of its body is being read directly.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_data(client_request.message(26));
+  request_data += "abcdefghij";
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_direct_read_threshold(20);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+
+  // the read holds the body, so it's still valid after clear
+  char* space(the_request_receiver.body_space());
+  std::shared_ptr<void> owner(the_request_receiver.direct_body_owner());
+  BOOST_REQUIRE(owner);
+  the_request_receiver.clear();
+  BOOST_CHECK(!the_request_receiver.direct_body_owner());
+  BOOST_CHECK(the_request_receiver.body().empty());
+  BOOST_CHECK_EQUAL(1, owner.use_count());
+  std::memcpy(space, "klmnopqrstuvwxyz", 16);
+  auto body(std::static_pointer_cast<std::string>(owner));
+  BOOST_CHECK_EQUAL("abcdefghijklmnopqrstuvwxyz", *body);
+}
+
+BOOST_AUTO_TEST_CASE(SpillBodyToFile1)
+{
+  // A PUT request with a body larger than the maximum content length,
+  // written to a file.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_body("abcdefghijklmnopqrstuvwxyz");
+  std::string request_data(client_request.message(request_body.size()));
+  request_data += request_body.substr(0, 10);
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver(20, 20);
+  the_request_receiver.set_spill_to_file(16, 100);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(iter == request_data.cend());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK(the_request_receiver.spilled_body().is_open());
+  BOOST_CHECK_EQUAL(10U, the_request_receiver.spilled_body().size());
+
+  std::string request_data2(request_body.substr(10));
+  iter = request_data2.cbegin();
+  rx_state = the_request_receiver.receive(iter, request_data2.cend());
+  BOOST_CHECK(iter == request_data2.cend());
+  BOOST_CHECK(rx_state == Rx::VALID);
+  BOOST_CHECK(the_request_receiver.body().empty());
+  BOOST_CHECK_EQUAL(request_body, the_request_receiver.spilled_body().map());
+
+  // clear closes the file
+  the_request_receiver.clear();
+  BOOST_CHECK(!the_request_receiver.spilled_body().is_open());
+}
+
+BOOST_AUTO_TEST_CASE(SpillBodyToFile2)
+{
+  // A chunked POST request, written to a file once it's above the threshold.
+  tx_request client_request(request_method::POST, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  client_request.add_header(header_field::HEADER_TRANSFER_ENCODING, "Chunked");
+  std::string request_data(client_request.message());
+  request_data += "a\r\n0123456789\r\n";
+
+  std::string::iterator iter(request_data.begin());
+  http_request_receiver the_request_receiver;
+  the_request_receiver.set_spill_to_file(16, 0);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.end()));
+  BOOST_CHECK(iter == request_data.end());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK(!the_request_receiver.spilled_body().is_open());
+  BOOST_CHECK_EQUAL(10U, the_request_receiver.body().size());
+
+  std::string request_data2("a\r\nabcdefghij\r\n0\r\n\r\n");
+  iter = request_data2.begin();
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK(the_request_receiver.spilled_body().is_open());
+  BOOST_CHECK(the_request_receiver.body().empty());
+
+  rx_state = the_request_receiver.receive(iter, request_data2.end());
+  BOOST_CHECK(iter == request_data2.end());
+  BOOST_CHECK(rx_state == Rx::VALID);
+  BOOST_CHECK_EQUAL("0123456789abcdefghij",
+                    the_request_receiver.spilled_body().map());
+}
+
+BOOST_AUTO_TEST_CASE(SpillBodyToFile3)
+{
+  // A body written to a file must be within the maximum length.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_data(client_request.message(101));
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver(20, 20);
+  the_request_receiver.set_spill_to_file(16, 100);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(rx_state == Rx::INVALID);
+  BOOST_CHECK(the_request_receiver.response_code() ==
+              response_status::code::PAYLOAD_TOO_LARGE);
+}
+
+BOOST_AUTO_TEST_CASE(SpillBodyToFile4)
+{
+  // A body below the spill threshold is held in memory, so it must be within
+  // the maximum content length, even if the spill limit is larger.
+  tx_request client_request(request_method::PUT, "/hello");
+  client_request.add_header(header_field::HEADER_HOST, "localhost");
+  std::string request_data(client_request.message(30));
+
+  std::string::const_iterator iter(request_data.cbegin());
+  http_request_receiver the_request_receiver(20, 20);
+  the_request_receiver.set_spill_to_file(40, 100);
+  Rx rx_state(the_request_receiver.receive(iter, request_data.cend()));
+  BOOST_CHECK(rx_state == Rx::INVALID);
+  BOOST_CHECK(the_request_receiver.response_code() ==
+              response_status::code::PAYLOAD_TOO_LARGE);
+
+  // A body above the spill threshold is written to the file
+  std::string request_data2(client_request.message(50));
+  iter = request_data2.cbegin();
+  http_request_receiver the_request_receiver2(20, 20);
+  the_request_receiver2.set_spill_to_file(40, 100);
+  rx_state = the_request_receiver2.receive(iter, request_data2.cend());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+  BOOST_CHECK(the_request_receiver2.spilled_body().is_open());
+
+  // A chunked body held in memory is also limited to the content length
+  tx_request chunked_request(request_method::POST, "/hello");
+  chunked_request.add_header(header_field::HEADER_HOST, "localhost");
+  chunked_request.add_header(header_field::HEADER_TRANSFER_ENCODING, "Chunked");
+  std::string request_data3(chunked_request.message());
+  request_data3 += "10\r\n0123456789abcdef\r\n10\r\n0123456789abcdef\r\n";
+  std::string::iterator iter3(request_data3.begin());
+  http_request_receiver the_request_receiver3(20, 20);
+  the_request_receiver3.set_spill_to_file(40, 100);
+  rx_state = the_request_receiver3.receive(iter3, request_data3.end());
+  while ((rx_state == Rx::INCOMPLETE) && (iter3 != request_data3.end()))
+    rx_state = the_request_receiver3.receive(iter3, request_data3.end());
+  BOOST_CHECK(rx_state == Rx::INVALID);
+  BOOST_CHECK(the_request_receiver3.response_code() ==
+              response_status::code::PAYLOAD_TOO_LARGE);
+}
+
+BOOST_AUTO_TEST_CASE(RequestArena1)
+{
+  http_request_receiver the_request_receiver;
+  std::pmr::memory_resource* resource(the_request_receiver.resource());
+
+  // the arena reuses its buffer after clear
+  void* first(resource->allocate(64));
+  BOOST_CHECK(first != resource->allocate(64));
+  the_request_receiver.clear();
+  BOOST_CHECK_EQUAL(first, resource->allocate(64));
+
+  // and it's still valid beyond its buffer
+  std::pmr::string text(http_request_receiver::ARENA_SIZE * 2, 'a', resource);
+  BOOST_CHECK_EQUAL(http_request_receiver::ARENA_SIZE * 2, text.size());
+}
+
 BOOST_AUTO_TEST_CASE(LoopbackPost1)
 {
   // A POST requests with two bodies in chunked buffers.
@@ -8,7 +8,11 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "via/http/request_router.hpp"
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
 using namespace via::http;
 
@@ -28,6 +32,7 @@ namespace
   const std::string get_name_request("GET /name HTTP/1.1\r\nContent: text\r\n\r\n");
   const std::string put_name_request("PUT /name HTTP/1.1\r\nContent: text\r\n\r\n");
   const std::string post_name_request("POST /name HTTP/1.1\r\nContent: text\r\n\r\n");
+  const std::string patch_name_request("PATCH /name HTTP/1.1\r\nContent: text\r\n\r\n");
 
   const std::string get_customer_request("GET /customer HTTP/1.1\r\nContent: text\r\n\r\n");
   const std::string get_customer_name_request("GET /customer/JohnSmith HTTP/1.1\r\nContent: text\r\n\r\n");
@@ -112,6 +117,7 @@ namespace
     {
       request_router_.add_method(request_method::id::GET, NAME, &test_route1);
       request_router_.add_method(request_method::id::PUT, NAME, &test_route2);
+      request_router_.add_method("PATCH", NAME, &test_route4);
 
       request_router_.add_method(request_method::id::GET, CUSTOMER, &test_route1);
       request_router_.add_method(request_method::id::GET, CUSTOMER + ID, &test_route3);
@@ -140,6 +146,35 @@ BOOST_AUTO_TEST_CASE(Test_get_route_parameters2)
   BOOST_CHECK_EQUAL(2U, params.size());
 }
 
+BOOST_AUTO_TEST_CASE(Test_get_route_parameters3)
+{
+  // parameters allocated from an arena
+  std::byte buffer[1024];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+  std::string path(CUSTOMER + ID + NAME + ADDRESS + "/:phone");
+  std::string uri_path("/customer/JohnSmith/name/London/0123456789");
+  Parameters params(get_route_parameters(uri_path, path, &arena));
+  BOOST_CHECK_EQUAL(3U, params.size());
+  BOOST_CHECK_EQUAL("JohnSmith", get_parameter(params, "id"));
+  BOOST_CHECK_EQUAL("London", get_parameter(params, "address"));
+  BOOST_CHECK_EQUAL("0123456789", get_parameter(params, "phone"));
+  BOOST_CHECK(params.get_allocator().resource() == &arena);
+}
+
+BOOST_AUTO_TEST_CASE(Test_get_route_parameters4)
+{
+  std::string path(CUSTOMER + ID + NAME + ADDRESS);
+  // a different path
+  BOOST_CHECK(get_route_parameters("/customer/JohnSmith/memory/London",
+                                   path).empty());
+  // too few strings
+  BOOST_CHECK(get_route_parameters("/customer/JohnSmith/name", path).empty());
+  // too many strings
+  BOOST_CHECK(get_route_parameters("/customer/JohnSmith/name/London/UK",
+                                   path).empty());
+}
+
 BOOST_AUTO_TEST_CASE(FailedRouteTest1)
 {
   // A simple GET request to an unknow resource
@@ -171,6 +206,8 @@ BOOST_AUTO_TEST_CASE(FailedRouteTest2)
   tx_response response(request_router_.handle_request(request, data, response_body));
   BOOST_CHECK_EQUAL(static_cast<int>(response_status::code::METHOD_NOT_ALLOWED),
                     response.status());
+  BOOST_CHECK(response.message().find("Allow: GET, PATCH, PUT\r\n")
+              != std::string::npos);
 //  std::cout << "FailedRouteTest2: "<< response.message() << std::endl;
 }
 
@@ -208,6 +245,22 @@ BOOST_AUTO_TEST_CASE(SimpleRouteTest2)
 //  std::cout << "SimpleRouteTest2: "<< response_body << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(ExtensionMethodRouteTest1)
+{
+  // A PATCH request, routed by name
+  std::string request_data(patch_name_request);
+  request_data += CRLF;
+  std::string::iterator next(request_data.begin());
+  rx_request<1024, 8, 100, 8190, 1024, 8, true> request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  std::string data;
+  std::string response_body;
+  tx_response response(request_router_.handle_request(request, data, response_body));
+  BOOST_CHECK_EQUAL(static_cast<int>(response_status::code::NO_CONTENT),
+                    response.status());
+}
+
 BOOST_AUTO_TEST_CASE(SimpleRouteTest3)
 {
   // A simple GET request
@@ -256,8 +309,665 @@ BOOST_AUTO_TEST_CASE(ComplexRouteTest2)
   tx_response response(request_router_.handle_request(request, data, response_body));
   BOOST_CHECK_EQUAL(static_cast<int>(response_status::code::NO_CONTENT),
                     response.status());
+  BOOST_CHECK_EQUAL("test_route3: param: address value: London ;  "
+                    "param: id value: JohnSmith ; \n", response_body);
 //  std::cout << "ComplexRouteTest2: "<< response_body << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(RadixRouteTest1)
+{
+  string_router router;
+  BOOST_CHECK(router.add_method(request_method::id::GET, "/files/*path", &test_route3));
+  BOOST_CHECK(router.add_method(request_method::id::GET, "/files/:name", &test_route2));
+  BOOST_CHECK(router.add_method(request_method::id::GET, "/files/index", &test_route1));
+  BOOST_CHECK(router.add_method(request_method::id::GET, "/users/:id/posts/:post",
+                                &test_route4));
+
+  // Too many parameters
+  std::string many_parameters;
+  for (size_t i(0); i <= MAX_ROUTE_PARAMETERS; ++i)
+    many_parameters += "/:p" + std::to_string(i);
+  BOOST_CHECK(!router.add_method(request_method::id::GET, many_parameters,
+                                 &test_route1));
+
+  auto route([&router](std::string const& path, std::string& response_body)
+  {
+    std::string request_data("GET " + path + " HTTP/1.1\r\n\r\n");
+    std::string::iterator next(request_data.begin());
+    http_request request;
+    BOOST_REQUIRE(request.parse(next, request_data.end()));
+    std::string data;
+    return router.handle_request(request, data, response_body).status();
+  });
+
+  // A literal segment is preferred to a parameter
+  std::string response_body;
+  BOOST_CHECK_EQUAL(200, route("/files/index", response_body));
+  BOOST_CHECK_EQUAL("test_route1:\n", response_body);
+
+  // A parameter is preferred to a wildcard
+  response_body.clear();
+  BOOST_CHECK_EQUAL(200, route("/files/readme", response_body));
+  BOOST_CHECK_EQUAL("test_route2: param: name value: readme ; \n", response_body);
+
+  // A wildcard captures the rest of the path
+  response_body.clear();
+  BOOST_CHECK_EQUAL(501, route("/files/docs/a/b.txt", response_body));
+  BOOST_CHECK_EQUAL("test_route3: param: path value: docs/a/b.txt ; \n",
+                    response_body);
+
+  response_body.clear();
+  BOOST_CHECK_EQUAL(501, route("/files/", response_body));
+  BOOST_CHECK_EQUAL("test_route3: param: path value:  ; \n", response_body);
+
+  response_body.clear();
+  BOOST_CHECK_EQUAL(204, route("/users/42/posts/7", response_body));
+  BOOST_CHECK_EQUAL("test_route3: param: id value: 42 ;  param: post value: 7 ; \n",
+                    response_body);
+
+  // Paths are matched by whole segments, not by substrings
+  response_body.clear();
+  BOOST_CHECK_EQUAL(404, route("/users/42/posts", response_body));
+  BOOST_CHECK_EQUAL(404, route("/x/users/42/posts/7", response_body));
+  BOOST_CHECK_EQUAL(404, route("/users//posts/7", response_body));
+  BOOST_CHECK_EQUAL(404, route("/files", response_body));
+}
+
+BOOST_AUTO_TEST_CASE(CachedRouteTest1)
+{
+  int calls(0);
+  request_router_.add_method(request_method::id::GET, "/robots.txt",
+    [&calls](http_request const&, Parameters const&, std::string const&,
+             std::string& response_body)
+  {
+    ++calls;
+    response_body = "User-agent: *\r\n";
+    tx_response response(response_status::code::OK);
+    response.add_header(header_field::id::CONTENT_TYPE, "text/plain");
+    return response;
+  });
+  BOOST_CHECK(request_router_.set_cacheable("/robots.txt", std::chrono::hours(1)));
+  BOOST_CHECK(!request_router_.set_cacheable("/missing", std::chrono::hours(1)));
+  BOOST_CHECK(!request_router_.set_cacheable(CUSTOMER + ID, std::chrono::hours(1)));
+
+  std::string request_data("GET /robots.txt HTTP/1.0\r\n\r\n");
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  // The first request calls the handler
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext cache;
+  tx_response response(request_router_.handle_request(request, data,
+                         response_body, std::pmr::get_default_resource(), &cache));
+  BOOST_CHECK_EQUAL(1, calls);
+  BOOST_CHECK(!cache.response);
+  BOOST_REQUIRE(cache.route);
+  BOOST_REQUIRE(string_router::CachedResponse::is_cacheable(response));
+  response.add_server_header();
+  auto cached(request_router_.cache_response(*cache.route, std::move(response),
+                                             std::move(response_body)));
+  BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\n", cached->status_line());
+  BOOST_CHECK_EQUAL("Content-Type: text/plain\r\nServer: Via-httplib\r\n"
+                    "Content-Length: 15\r\n\r\n", cached->headers());
+  BOOST_CHECK_EQUAL("User-agent: *\r\n", cached->body());
+
+  // The next request gets the cached response
+  string_router::RouteContext cache1;
+  response_body.clear();
+  request_router_.handle_request(request, data, response_body,
+                                 std::pmr::get_default_resource(), &cache1);
+  BOOST_CHECK_EQUAL(1, calls);
+  BOOST_CHECK(cache1.response == cached);
+
+  // Unless it has a query string
+  std::string request_data2("GET /robots.txt?q=1 HTTP/1.1\r\n\r\n");
+  next = request_data2.begin();
+  http_request request2;
+  BOOST_CHECK(request2.parse(next, request_data2.end()));
+  string_router::RouteContext cache2;
+  request_router_.handle_request(request2, data, response_body,
+                                 std::pmr::get_default_resource(), &cache2);
+  BOOST_CHECK_EQUAL(2, calls);
+  BOOST_CHECK(!cache2.response);
+  BOOST_CHECK(!cache2.route);
+
+  // Or the cache has been cleared
+  request_router_.clear_cache("/robots.txt");
+  string_router::RouteContext cache3;
+  request_router_.handle_request(request, data, response_body,
+                                 std::pmr::get_default_resource(), &cache3);
+  BOOST_CHECK_EQUAL(3, calls);
+  BOOST_CHECK(!cache3.response);
+  BOOST_CHECK(cache3.route);
+}
+
+BOOST_AUTO_TEST_CASE(CachedRouteTest2)
+{
+  BOOST_CHECK(request_router_.set_cacheable(NAME, std::chrono::nanoseconds(1)));
+
+  std::string request_data(get_name_request);
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext cache;
+  tx_response response(request_router_.handle_request(request, data,
+                         response_body, std::pmr::get_default_resource(), &cache));
+  BOOST_REQUIRE(cache.route);
+  request_router_.cache_response(*cache.route, std::move(response),
+                                 std::move(response_body));
+
+  // The cached response has expired
+  string_router::RouteContext cache1;
+  request_router_.handle_request(request, data, response_body,
+                                 std::pmr::get_default_resource(), &cache1);
+  BOOST_CHECK(!cache1.response);
+  BOOST_CHECK(cache1.route);
+
+  // Without a cache lookup the handler is always called
+  response_body.clear();
+  request_router_.handle_request(request, data, response_body);
+  BOOST_CHECK_EQUAL("test_route1:\n", response_body);
+}
+
+BOOST_AUTO_TEST_CASE(EtagRouteTest1)
+{
+  BOOST_CHECK(!request_router_.set_etag("/unknown"));
+  BOOST_CHECK(request_router_.set_etag(NAME));
+
+  std::string request_data(get_name_request);
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  std::string data;
+  std::string response_body;
+  tx_response response(request_router_.handle_request(request, data,
+                                                      response_body));
+  BOOST_CHECK_EQUAL(200, response.status());
+  BOOST_CHECK_EQUAL("test_route1:\n", response_body);
+  std::string etag(response.find_header(header_field::LC_ETAG));
+  BOOST_CHECK_EQUAL(make_etag(response_body), etag);
+
+  // A request with a matching If-None-Match header is Not Modified
+  std::string request_data1("GET /name HTTP/1.1\r\nIf-None-Match: " + etag +
+                            "\r\n\r\n");
+  next = request_data1.begin();
+  http_request request1;
+  BOOST_CHECK(request1.parse(next, request_data1.end()));
+  std::string response_body1;
+  tx_response response1(request_router_.handle_request(request1, data,
+                                                       response_body1));
+  BOOST_CHECK_EQUAL(304, response1.status());
+  BOOST_CHECK(response_body1.empty());
+  BOOST_CHECK_EQUAL(etag, response1.find_header(header_field::LC_ETAG));
+
+  // Including a cached response
+  BOOST_CHECK(request_router_.set_cacheable(NAME, std::chrono::minutes(1)));
+  string_router::RouteContext cache;
+  response_body.clear();
+  tx_response response2(request_router_.handle_request(request, data,
+                          response_body, std::pmr::get_default_resource(), &cache));
+  BOOST_REQUIRE(cache.route);
+  auto cached(request_router_.cache_response(*cache.route, std::move(response2),
+                                             response_body));
+  BOOST_CHECK_EQUAL(etag, cached->etag());
+
+  string_router::RouteContext cache1;
+  tx_response response3(request_router_.handle_request(request1, data,
+                          response_body1, std::pmr::get_default_resource(), &cache1));
+  BOOST_CHECK_EQUAL(304, response3.status());
+  BOOST_CHECK(!cache1.response);
+}
+
+#ifdef HTTP_ZLIB
+BOOST_AUTO_TEST_CASE(EtagRouteTest2)
+{
+  const std::string body(2000, 'x');
+  BOOST_CHECK(request_router_.add_method(request_method::id::GET, "/large",
+    [&body](http_request const&, Parameters const&, std::string const&,
+            std::string& response_body)
+    {
+      response_body = body;
+      return tx_response(response_status::code::OK);
+    }));
+  BOOST_CHECK(request_router_.set_etag("/large"));
+  BOOST_CHECK(request_router_.set_cacheable("/large", std::chrono::minutes(1)));
+
+  std::string request_data("GET /large HTTP/1.1\r\n\r\n");
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext cache;
+  tx_response response(request_router_.handle_request(request, data,
+                         response_body, std::pmr::get_default_resource(), &cache));
+  BOOST_REQUIRE(cache.route);
+  auto cached(request_router_.cache_response(*cache.route, std::move(response),
+                                             std::move(response_body), 6));
+  BOOST_REQUIRE(cached->is_available(content_coding::id::GZIP));
+  std::string weak_etag("W/" + make_etag(body));
+  BOOST_CHECK_EQUAL(weak_etag, cached->etag(content_coding::id::GZIP));
+
+  // A client with the gzip variant is sent its weak ETag
+  std::string request_data1("GET /large HTTP/1.1\r\nAccept-Encoding: gzip\r\n"
+                            "If-None-Match: " + weak_etag + "\r\n\r\n");
+  next = request_data1.begin();
+  http_request request1;
+  BOOST_CHECK(request1.parse(next, request_data1.end()));
+  string_router::RouteContext cache1;
+  tx_response response1(request_router_.handle_request(request1, data,
+                          response_body, std::pmr::get_default_resource(), &cache1));
+  BOOST_CHECK_EQUAL(304, response1.status());
+  BOOST_CHECK_EQUAL(weak_etag, response1.find_header(header_field::LC_ETAG));
+  BOOST_CHECK_EQUAL(header_field::HEADER_ACCEPT_ENCODING,
+                    response1.find_header(header_field::LC_VARY));
+
+  // A client without it is sent the strong ETag
+  std::string request_data2("GET /large HTTP/1.1\r\n"
+                            "If-None-Match: " + weak_etag + "\r\n\r\n");
+  next = request_data2.begin();
+  http_request request2;
+  BOOST_CHECK(request2.parse(next, request_data2.end()));
+  string_router::RouteContext cache2;
+  tx_response response2(request_router_.handle_request(request2, data,
+                          response_body, std::pmr::get_default_resource(), &cache2));
+  BOOST_CHECK_EQUAL(304, response2.status());
+  BOOST_CHECK_EQUAL(make_etag(body),
+                    response2.find_header(header_field::LC_ETAG));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(DeferredRouteTest1)
+{
+  string_router::Responder held;
+  BOOST_CHECK(request_router_.add_deferred_method(request_method::id::GET,
+    "/deferred/:id", [&held](http_request const&, Parameters const& parameters,
+                             std::string const&, string_router::Responder responder)
+    {
+      if (get_parameter(parameters, "id") == "now")
+        responder(tx_response(response_status::code::OK), "now");
+      else
+        held = responder;
+    }));
+
+  std::string request_data("GET /deferred/now HTTP/1.1\r\n\r\n");
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  // Without a responder
+  std::string data;
+  std::string response_body;
+  BOOST_CHECK_EQUAL(500, request_router_.handle_request(request, data,
+                                                 response_body).status());
+
+  std::vector<std::pair<int, std::string>> sent;
+  string_router::RouteContext cache;
+  cache.make_responder = [&sent]()
+  {
+    return string_router::Responder([&sent](tx_response response,
+                                            std::string body)
+      { sent.emplace_back(response.status(), body); });
+  };
+  request_router_.handle_request(request, data, response_body,
+                                 std::pmr::get_default_resource(), &cache);
+  BOOST_CHECK(cache.deferred);
+  BOOST_REQUIRE_EQUAL(1U, sent.size());
+  BOOST_CHECK_EQUAL(200, sent[0].first);
+  BOOST_CHECK_EQUAL("now", sent[0].second);
+
+  // A response sent later, only once
+  std::string request_data1("GET /deferred/later HTTP/1.1\r\n\r\n");
+  next = request_data1.begin();
+  http_request request1;
+  BOOST_CHECK(request1.parse(next, request_data1.end()));
+  string_router::RouteContext cache1;
+  cache1.make_responder = cache.make_responder;
+  request_router_.handle_request(request1, data, response_body,
+                                 std::pmr::get_default_resource(), &cache1);
+  BOOST_CHECK(cache1.deferred);
+  BOOST_CHECK_EQUAL(1U, sent.size());
+  BOOST_REQUIRE(held);
+  BOOST_CHECK(held(tx_response(response_status::code::NO_CONTENT)));
+  BOOST_CHECK(!held(tx_response(response_status::code::OK)));
+  BOOST_REQUIRE_EQUAL(2U, sent.size());
+  BOOST_CHECK_EQUAL(204, sent[1].first);
+
+  // A responder that's discarded sends an error
+  string_router::RouteContext cache2;
+  cache2.make_responder = cache.make_responder;
+  request_router_.handle_request(request1, data, response_body,
+                                 std::pmr::get_default_resource(), &cache2);
+  held = string_router::Responder();
+  BOOST_REQUIRE_EQUAL(3U, sent.size());
+  BOOST_CHECK_EQUAL(500, sent[2].first);
+}
+
+BOOST_AUTO_TEST_CASE(DeferredRouteTest2)
+{
+  // A deferred handler that reads the request after the client disconnects
+  std::function<void ()> respond_later;
+  BOOST_CHECK(request_router_.add_deferred_method(request_method::id::GET,
+    "/deferred", [&respond_later](http_request const& request, Parameters const&,
+                                  std::string const&,
+                                  string_router::Responder responder)
+    {
+      respond_later = [&request, responder]()
+        { responder(tx_response(response_status::code::OK), request.uri()); };
+    }));
+
+  // The request is owned by a connection, which is held by the responder
+  struct connection
+  {
+    http_request request;
+    std::string data;
+  };
+  auto owner(std::make_shared<connection>());
+  std::string request_data("GET /deferred HTTP/1.1\r\n\r\n");
+  std::string::iterator next(request_data.begin());
+  BOOST_REQUIRE(owner->request.parse(next, request_data.end()));
+
+  std::vector<std::string> sent;
+  string_router::RouteContext cache;
+  cache.make_responder = [&sent, &owner]()
+  {
+    return string_router::Responder([&sent](tx_response, std::string body)
+      { sent.push_back(body); }, owner);
+  };
+  std::string response_body;
+  request_router_.handle_request(owner->request, owner->data, response_body,
+                                 std::pmr::get_default_resource(), &cache);
+  BOOST_CHECK(cache.deferred);
+  cache.make_responder = nullptr;
+
+  // The client disconnects: the connection is released by the server
+  std::weak_ptr<connection> weak_owner(owner);
+  owner.reset();
+  BOOST_CHECK(!weak_owner.expired());
+
+  respond_later();
+  BOOST_REQUIRE_EQUAL(1U, sent.size());
+  BOOST_CHECK_EQUAL("/deferred", sent[0]);
+  // The connection is released when the response has been sent
+  BOOST_CHECK(weak_owner.expired());
+}
+
+BOOST_AUTO_TEST_CASE(WorkerPoolRouteTest1)
+{
+  std::promise<void> start;
+  std::shared_future<void> started(start.get_future());
+  auto io_thread(std::this_thread::get_id());
+  BOOST_CHECK(request_router_.add_method(request_method::id::GET, "/work/:name",
+    [started, io_thread](http_request const&, Parameters const& parameters,
+                         std::string const&, std::string& response_body)
+    {
+      started.wait();
+      response_body = "work " + get_parameter(parameters, "name");
+      return tx_response(std::this_thread::get_id() != io_thread ?
+                         response_status::code::OK :
+                         response_status::code::INTERNAL_SERVER_ERROR);
+    }));
+
+  // One thread and room for one task in the queue
+  auto pool(std::make_shared<via::thread::worker_pool>(1u, 1u));
+  BOOST_CHECK(!request_router_.set_worker_pool("/missing", pool));
+  BOOST_CHECK(request_router_.set_worker_pool("/work/:name", pool));
+
+  std::mutex sent_mutex;
+  std::vector<std::pair<std::string, std::string>> sent;
+  string_router::RouteContext cache;
+  cache.make_responder = [&sent_mutex, &sent]()
+  {
+    return string_router::Responder([&sent_mutex, &sent](tx_response response,
+                                                        std::string body)
+      {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent.emplace_back(response.message(body.size()), body);
+      });
+  };
+
+  std::array<std::string, 3> request_data{ "GET /work/a HTTP/1.1\r\n\r\n",
+                                           "GET /work/b HTTP/1.1\r\n\r\n",
+                                           "GET /work/c HTTP/1.1\r\n\r\n" };
+  std::array<http_request, 3> requests;
+  for (size_t i(0u); i < requests.size(); ++i)
+  {
+    std::string::iterator next(request_data[i].begin());
+    BOOST_REQUIRE(requests[i].parse(next, request_data[i].end()));
+  }
+
+  // The first request is run by the thread, the second waits in the queue
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext lookup(cache);
+  request_router_.handle_request(requests[0], data, response_body,
+                                 std::pmr::get_default_resource(), &lookup);
+  BOOST_CHECK(lookup.deferred);
+  while (pool->stats().queue_depth > 0u)
+    std::this_thread::yield();
+
+  string_router::RouteContext lookup1(cache);
+  request_router_.handle_request(requests[1], data, response_body,
+                                 std::pmr::get_default_resource(), &lookup1);
+  BOOST_CHECK(lookup1.deferred);
+  BOOST_CHECK_EQUAL(1U, pool->stats().queue_depth);
+
+  // The queue is full, so the third request is sent Service Unavailable
+  string_router::RouteContext lookup2(cache);
+  request_router_.handle_request(requests[2], data, response_body,
+                                 std::pmr::get_default_resource(), &lookup2);
+  BOOST_CHECK(lookup2.deferred);
+  {
+    std::lock_guard<std::mutex> lock(sent_mutex);
+    BOOST_REQUIRE_EQUAL(1U, sent.size());
+    BOOST_CHECK(sent[0].first.find("HTTP/1.1 503 ") == 0u);
+    BOOST_CHECK(sent[0].first.find("Retry-After: 1\r\n") != std::string::npos);
+  }
+
+  start.set_value();
+  pool->stop();
+  BOOST_REQUIRE_EQUAL(3U, sent.size());
+  BOOST_CHECK(sent[1].first.find("HTTP/1.1 200 ") == 0u);
+  BOOST_CHECK_EQUAL("work a", sent[1].second);
+  BOOST_CHECK(sent[2].first.find("HTTP/1.1 200 ") == 0u);
+  BOOST_CHECK_EQUAL("work b", sent[2].second);
+
+  auto stats(pool->stats());
+  BOOST_CHECK_EQUAL(2U, stats.posted);
+  BOOST_CHECK_EQUAL(1U, stats.rejected);
+  BOOST_CHECK_EQUAL(2U, stats.completed);
+  BOOST_CHECK(stats.max_wait.count() > 0);
+  BOOST_CHECK(stats.total_wait >= stats.max_wait);
+}
+
+BOOST_AUTO_TEST_CASE(WorkerPoolRouteTest2)
+{
+  std::promise<void> start;
+  std::shared_future<void> started(start.get_future());
+  BOOST_CHECK(request_router_.add_method(request_method::id::GET, "/work",
+    [started](http_request const& request, Parameters const&,
+              std::string const&, std::string& response_body)
+    {
+      started.wait();
+      if (request.headers().find("x-fail") == "yes")
+        throw std::runtime_error("handler failed");
+      response_body = request.uri();
+      return tx_response(response_status::code::OK);
+    }));
+  auto pool(std::make_shared<via::thread::worker_pool>(1u, 4u));
+  BOOST_CHECK(request_router_.set_worker_pool("/work", pool));
+
+  // The requests are owned by connections, which are held by the responders
+  struct connection
+  {
+    http_request request;
+    std::string data;
+  };
+  std::array<std::string, 2> request_data{ "GET /work HTTP/1.1\r\n\r\n",
+                               "GET /work HTTP/1.1\r\nX-Fail: yes\r\n\r\n" };
+  std::mutex sent_mutex;
+  std::vector<std::pair<int, std::string>> sent;
+  std::array<std::weak_ptr<connection>, 2> weak_owners;
+  for (size_t i(0u); i < request_data.size(); ++i)
+  {
+    auto owner(std::make_shared<connection>());
+    std::string::iterator next(request_data[i].begin());
+    BOOST_REQUIRE(owner->request.parse(next, request_data[i].end()));
+    weak_owners[i] = owner;
+
+    string_router::RouteContext cache;
+    cache.make_responder = [&sent_mutex, &sent, owner]()
+    {
+      return string_router::Responder([&sent_mutex, &sent]
+        (tx_response response, std::string body)
+        {
+          std::lock_guard<std::mutex> lock(sent_mutex);
+          sent.emplace_back(response.status(), body);
+        }, owner);
+    };
+    std::string response_body;
+    request_router_.handle_request(owner->request, owner->data, response_body,
+                                   std::pmr::get_default_resource(), &cache);
+    BOOST_CHECK(cache.deferred);
+  }
+
+  // The clients disconnected while the tasks were queued
+  BOOST_CHECK(!weak_owners[0].expired());
+  BOOST_CHECK(!weak_owners[1].expired());
+
+  start.set_value();
+  pool->stop();
+  BOOST_REQUIRE_EQUAL(2U, sent.size());
+  BOOST_CHECK_EQUAL(200, sent[0].first);
+  BOOST_CHECK_EQUAL("/work", sent[0].second);
+  // The handler threw, so the responder sent an error
+  BOOST_CHECK_EQUAL(500, sent[1].first);
+  BOOST_CHECK(weak_owners[0].expired());
+  BOOST_CHECK(weak_owners[1].expired());
+  BOOST_CHECK_EQUAL(1U, pool->stats().failed);
+}
+
+BOOST_AUTO_TEST_CASE(LoadSheddingRouteTest1)
+{
+  std::string name_data(get_name_request);
+  std::string::iterator next(name_data.begin());
+  http_request name_request;
+  BOOST_REQUIRE(name_request.parse(next, name_data.end()));
+
+  std::string customer_data(get_customer_request);
+  next = customer_data.begin();
+  http_request customer_request;
+  BOOST_REQUIRE(customer_request.parse(next, customer_data.end()));
+
+  BOOST_CHECK(!request_router_.set_priority("/missing", route_priority::LOW));
+  BOOST_CHECK(request_router_.set_priority(NAME, route_priority::LOW));
+  BOOST_CHECK(request_router_.set_priority(CUSTOMER, route_priority::HIGH));
+
+  // The delay has been above the target for an interval
+  load_shedder shedder(std::chrono::milliseconds(5),
+                       std::chrono::milliseconds(100));
+  auto start(load_shedder::clock::now() - std::chrono::seconds(1));
+  shedder.record(std::chrono::milliseconds(10), start);
+  shedder.record(std::chrono::milliseconds(10),
+                 start + std::chrono::milliseconds(100));
+  BOOST_REQUIRE(shedder.is_overloaded());
+
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext cache;
+  cache.shedder = &shedder;
+  tx_response response(request_router_.handle_request(name_request, data,
+                         response_body, std::pmr::get_default_resource(),
+                         &cache));
+  BOOST_CHECK_EQUAL(503, response.status());
+  BOOST_CHECK(response.message(0u).find("Retry-After: 1\r\n")
+              != std::string::npos);
+  BOOST_CHECK(response_body.empty());
+
+  string_router::RouteContext cache1;
+  cache1.shedder = &shedder;
+  tx_response response1(request_router_.handle_request(customer_request, data,
+                          response_body, std::pmr::get_default_resource(),
+                          &cache1));
+  BOOST_CHECK_EQUAL(200, response1.status());
+
+  auto stats(shedder.stats());
+  BOOST_CHECK_EQUAL(1U, stats.shed_low);
+  BOOST_CHECK_EQUAL(0U, stats.shed_normal);
+}
+
+BOOST_AUTO_TEST_CASE(RouteUpdateTest1)
+{
+  std::string request_data(get_name_request);
+  std::string::iterator next(request_data.begin());
+  http_request request;
+  BOOST_CHECK(request.parse(next, request_data.end()));
+
+  // A lookup keeps its route after the route is removed
+  BOOST_CHECK(request_router_.set_cacheable(NAME, std::chrono::minutes(1)));
+  std::string data;
+  std::string response_body;
+  string_router::RouteContext cache;
+  request_router_.handle_request(request, data, response_body,
+                                 std::pmr::get_default_resource(), &cache);
+  BOOST_REQUIRE(cache.route);
+  auto routes(request_router_.routes());
+  BOOST_CHECK_EQUAL(4U, routes->size());
+
+  BOOST_CHECK(request_router_.remove_route(NAME));
+  BOOST_CHECK(!request_router_.remove_route(NAME));
+  BOOST_CHECK_EQUAL(NAME, cache.route->path);
+  BOOST_CHECK_EQUAL(4U, routes->size());
+  BOOST_CHECK_EQUAL(3U, request_router_.routes()->size());
+  BOOST_CHECK_EQUAL(404, request_router_.handle_request(request, data,
+                                                 response_body).status());
+
+  // The other routes are still found
+  std::string request_data1(get_customer_name_request);
+  next = request_data1.begin();
+  http_request request1;
+  BOOST_CHECK(request1.parse(next, request_data1.end()));
+  BOOST_CHECK_EQUAL(501, request_router_.handle_request(request1, data,
+                                                 response_body).status());
+
+  // Routes are added and removed while requests are handled
+  std::atomic<bool> running(true);
+  std::atomic<int> errors(0);
+  auto handle_requests([&]()
+  {
+    while (running)
+    {
+      std::string body;
+      auto status(request_router_.handle_request(request1, data, body).status());
+      if (status != 501)
+        ++errors;
+      auto name_status(request_router_.handle_request(request, data, body).status());
+      if ((name_status != 200) && (name_status != 404))
+        ++errors;
+    }
+  });
+  std::thread thread1(handle_requests);
+  std::thread thread2(handle_requests);
+  for (int i(0); i < 200; ++i)
+  {
+    request_router_.add_method(request_method::id::GET, NAME, &test_route1);
+    request_router_.add_method(request_method::id::GET,
+                               "/extra/" + std::to_string(i), &test_route2);
+    request_router_.remove_route(NAME);
+  }
+  running = false;
+  thread1.join();
+  thread2.join();
+  BOOST_CHECK_EQUAL(0, errors);
+  BOOST_CHECK_EQUAL(203U, request_router_.routes()->size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
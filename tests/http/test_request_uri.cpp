@@ -110,5 +110,87 @@ BOOST_AUTO_TEST_CASE(PathQueryFragmentUri3)
   BOOST_CHECK_EQUAL(result_fragment, test_uri.fragment());
 }
 
+BOOST_AUTO_TEST_CASE(UriViews1)
+{
+  // the parts of the uri are not copied
+  std::string input("/docs/pdf?rfc3986#Section1");
+
+  request_uri test_uri(input);
+
+  BOOST_CHECK(test_uri.path().data() == input.data());
+  BOOST_CHECK(test_uri.query().data() == input.data() + 10);
+  BOOST_CHECK(test_uri.fragment().data() == input.data() + 18);
+}
+
+BOOST_AUTO_TEST_CASE(QueryParameters1)
+{
+  std::string input("/search?q=via+http%2Flib&&page=2&debug&sort=#top");
+
+  request_uri test_uri(input);
+  auto const& parameters(test_uri.query_parameters());
+  BOOST_REQUIRE_EQUAL(4U, parameters.size());
+  BOOST_CHECK_EQUAL("q", parameters[0].key);
+  BOOST_CHECK_EQUAL("via+http%2Flib", parameters[0].value);
+  BOOST_CHECK_EQUAL("page", parameters[1].key);
+  BOOST_CHECK_EQUAL("2", parameters[1].value);
+  BOOST_CHECK_EQUAL("debug", parameters[2].key);
+  BOOST_CHECK(parameters[2].value.empty());
+  BOOST_CHECK_EQUAL("sort", parameters[3].key);
+  BOOST_CHECK(parameters[3].value.empty());
+
+  BOOST_CHECK_EQUAL("2", *test_uri.find_query("page"));
+  BOOST_CHECK(test_uri.find_query("debug"));
+  BOOST_CHECK(!test_uri.find_query("top"));
+
+  std::string value;
+  BOOST_CHECK(test_uri.query_value("q", value));
+  BOOST_CHECK_EQUAL("via http/lib", value);
+  BOOST_CHECK(!test_uri.query_value("missing", value));
+}
+
+BOOST_AUTO_TEST_CASE(QueryParameters2)
+{
+  // an encoded key
+  std::string input("/search?first%20name=John%20Smith&bad=%2");
+
+  request_uri test_uri(input);
+  std::pmr::string value;
+  BOOST_CHECK(test_uri.query_value("first name", value));
+  BOOST_CHECK_EQUAL("John Smith", value);
+
+  // an invalid escape
+  value.clear();
+  BOOST_CHECK(!test_uri.query_value("bad", value));
+  BOOST_CHECK(value.empty());
+}
+
+BOOST_AUTO_TEST_CASE(PercentDecode1)
+{
+  std::string text("/a%20b/c%2Fd+e%41");
+  BOOST_CHECK_EQUAL(11U, percent_decode(text.data(), text.size()));
+  BOOST_CHECK_EQUAL("/a b/c/d+eA", text.substr(0, 11));
+
+  std::string path;
+  request_uri test_uri("/docs/my%20file.pdf?x=1");
+  BOOST_CHECK(test_uri.decoded_path(path));
+  BOOST_CHECK_EQUAL("/docs/my file.pdf", path);
+
+  std::string invalid("abc%4g");
+  BOOST_CHECK_EQUAL(std::string_view::npos,
+                    percent_decode(invalid.data(), invalid.size()));
+  BOOST_CHECK_EQUAL(std::string_view::npos,
+                    percent_decode(invalid.data(), 5));
+}
+
+BOOST_AUTO_TEST_CASE(PercentEqual1)
+{
+  BOOST_CHECK(percent_equal("a%20b", "a b"));
+  BOOST_CHECK(percent_equal("a+b", "a b", true));
+  BOOST_CHECK(!percent_equal("a+b", "a b"));
+  BOOST_CHECK(!percent_equal("a%20b", "a bc"));
+  BOOST_CHECK(!percent_equal("a%20bc", "a b"));
+  BOOST_CHECK(!percent_equal("a%2", "a "));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
@@ -157,6 +157,42 @@ BOOST_AUTO_TEST_CASE(ResponseStatus2)
   BOOST_CHECK(content_permitted(static_cast<int>(code::BAD_REQUEST)));
 }
 
+BOOST_AUTO_TEST_CASE(CannedResponses1)
+{
+  using namespace via::http::response_status;
+
+  BOOST_CHECK_EQUAL("HTTP/1.1 100 Continue\r\n\r\n",
+                    canned_response(static_cast<int>(code::CONTINUE)));
+  BOOST_CHECK_EQUAL("HTTP/1.0 400 Bad Request\r\nContent-Length: 0\r\n\r\n",
+                    canned_response(static_cast<int>(code::BAD_REQUEST),
+                                    '1', '0'));
+  // An unknown version gets an HTTP/1.1 response
+  BOOST_CHECK_EQUAL("HTTP/1.1 414 Request-URI Too Long\r\n"
+                    "Content-Length: 0\r\n\r\n",
+                    canned_response(static_cast<int>(code::REQUEST_URI_TOO_LONG),
+                                    '\0', '\0'));
+  // Other versions are formatted with their version
+  BOOST_CHECK(canned_response(static_cast<int>(code::OK), '1', '2').empty());
+  BOOST_CHECK(canned_response(static_cast<int>(code::OK), '2', '0').empty());
+  BOOST_CHECK(canned_response(199).empty());
+  BOOST_CHECK(canned_response(600).empty());
+
+  // The canned responses are the same as the encoded responses
+  for (int status(100); status < 600; ++status)
+  {
+    if (reason_phrase(status).empty())
+      continue;
+
+    for (char minor_version : {'0', '1'})
+    {
+      via::http::tx_response response(static_cast<code>(status));
+      response.set_minor_version(minor_version);
+      BOOST_CHECK_EQUAL(response.message(),
+                        canned_response(status, '1', minor_version));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -471,6 +507,33 @@ BOOST_AUTO_TEST_CASE(ValidNonstandardString3)
   BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\n", response_string.data());
 }
 
+BOOST_AUTO_TEST_CASE(ValidStatusLines1)
+{
+  BOOST_CHECK_EQUAL("HTTP/1.1 404 Not Found\r\n",
+                    response_status::status_line(404));
+  BOOST_CHECK_EQUAL("HTTP/1.1 511 Network Authentication Required\r\n",
+                    response_status::status_line(511));
+  BOOST_CHECK(response_status::status_line(199).empty());
+  BOOST_CHECK(response_status::status_line(99).empty());
+  BOOST_CHECK(response_status::status_line(600).empty());
+}
+
+BOOST_AUTO_TEST_CASE(ValidSerialize1)
+{
+  // A standard status with a different reason phrase
+  response_line<65534, 65534, 254, false> the_response(200, "Fine");
+  std::string output("prefix ");
+  the_response.serialize(output);
+  BOOST_CHECK_EQUAL("prefix HTTP/1.1 200 Fine\r\n", output);
+
+  // A standard status line with a different http version
+  response_line<65534, 65534, 254, false>
+      the_response1(response_status::code::NOT_FOUND, '1', '0');
+  output.clear();
+  the_response1.serialize(output);
+  BOOST_CHECK_EQUAL("HTTP/1.0 404 Not Found\r\n", output);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -670,6 +733,87 @@ BOOST_AUTO_TEST_CASE(ResponseEncode5)
   BOOST_CHECK_EQUAL(correct_response.data(), resp_text.data());
 }
 
+BOOST_AUTO_TEST_CASE(ResponseEncodeFraming1)
+{
+  // The framing headers are found whatever their case.
+  tx_response the_response(response_status::code::OK);
+  the_response.add_header("content-length", "5");
+  BOOST_CHECK(the_response.has_content_length());
+  BOOST_CHECK(!the_response.has_transfer_encoding());
+  BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\n",
+                    the_response.message(5));
+
+  tx_response the_response1(response_status::code::OK,
+                            "X-Content-Length: 5\r\n"
+                            "transfer-encoding: chunked\r\n");
+  BOOST_CHECK(!the_response1.has_content_length());
+  BOOST_CHECK(the_response1.has_transfer_encoding());
+
+  // Only a header name matches, not a header value.
+  BOOST_CHECK(the_response1.set_header_string("X-Note: Content-Length\r\n"));
+  BOOST_CHECK(!the_response1.has_content_length());
+  BOOST_CHECK(!the_response1.has_transfer_encoding());
+  BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\nX-Note: Content-Length\r\n"
+                    "Content-Length: 3\r\n\r\n", the_response1.message(3));
+}
+
+BOOST_AUTO_TEST_CASE(ResponseEncodeDate1)
+{
+  tx_response the_response(response_status::code::OK);
+  the_response.add_server_header();
+  the_response.add_date_header();
+  std::string resp_text(the_response.message());
+
+  // The Date header follows the status line.
+  std::string status_date("HTTP/1.1 200 OK\r\nDate: ");
+  BOOST_CHECK_EQUAL(0u, resp_text.find(status_date));
+  auto server_pos(status_date.size() + header_field::DATE_LENGTH + 2u);
+  BOOST_CHECK_EQUAL(server_pos, resp_text.find("Server: Via-httplib\r\n"));
+
+  // Setting the header string removes it.
+  the_response.set_header_string("");
+  BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+                    the_response.message());
+}
+
+BOOST_AUTO_TEST_CASE(ResponseEncodeEtag1)
+{
+  tx_response the_response(response_status::code::OK);
+  the_response.weaken_etag();
+  BOOST_CHECK(the_response.find_header(header_field::LC_ETAG).empty());
+
+  // A strong ETag is made weak, once
+  the_response.add_header(header_field::id::ETAG, "\"ef46db3751d8e999\"");
+  the_response.add_header(header_field::id::CONTENT_TYPE, "text/plain");
+  the_response.weaken_etag();
+  the_response.weaken_etag();
+  BOOST_CHECK_EQUAL("HTTP/1.1 200 OK\r\n"
+                    "ETag: W/\"ef46db3751d8e999\"\r\n"
+                    "Content-Type: text/plain\r\n"
+                    "Content-Length: 0\r\n\r\n", the_response.message());
+}
+
+BOOST_AUTO_TEST_CASE(ResponseEncodeSerialize1)
+{
+  tx_response the_response(response_status::code::NOT_FOUND);
+  the_response.add_header(header_field::id::CONTENT_TYPE, "text/plain");
+
+  // serialize into a reused buffer
+  std::string output;
+  output.reserve(256);
+  auto data(output.data());
+  for (int i(0); i < 2; ++i)
+  {
+    output.clear();
+    the_response.serialize(output, 9);
+    BOOST_CHECK_EQUAL(the_response.message(9), output);
+  }
+  BOOST_CHECK_EQUAL(data, output.data());
+  BOOST_CHECK_EQUAL("HTTP/1.1 404 Not Found\r\n"
+                    "Content-Type: text/plain\r\n"
+                    "Content-Length: 9\r\n\r\n", output);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 //////////////////////////////////////////////////////////////////////////////
 
@@ -825,6 +969,46 @@ BOOST_AUTO_TEST_CASE(ValidOKChunked2)
   BOOST_CHECK(the_response_receiver.chunk().is_last());
 }
 
+BOOST_AUTO_TEST_CASE(ValidOKChunkViews1)
+{
+  std::string response_data("HTTP/1.1 200 OK\r\n");
+  response_data += "Transfer-Encoding: Chunked\r\n\r\n";
+  std::string::iterator next(response_data.begin());
+
+  http_response_receiver the_response_receiver;
+  the_response_receiver.set_chunk_views(true);
+  Rx rx_state(the_response_receiver.receive(next, response_data.end()));
+  BOOST_CHECK(rx_state == Rx::VALID);
+
+  // a chunk in one buffer is not copied
+  std::string body_data("15\r\nHTTP chunk number: 1\n\r\n16\r\nHTTP chunk ");
+  next = body_data.begin();
+  rx_state = the_response_receiver.receive(next, body_data.end());
+  BOOST_CHECK(rx_state == Rx::CHUNK);
+  BOOST_CHECK(the_response_receiver.chunk().data().empty());
+  BOOST_CHECK_EQUAL("HTTP chunk number: 1\n",
+                    the_response_receiver.chunk().data_view());
+  BOOST_CHECK(the_response_receiver.chunk().data_view().data() == &body_data[4]);
+
+  // a chunk split across buffers is copied
+  rx_state = the_response_receiver.receive(next, body_data.end());
+  BOOST_CHECK(rx_state == Rx::INCOMPLETE);
+
+  std::string body_data2("number: 21\n\r\n0\r\n\r\n");
+  next = body_data2.begin();
+  rx_state = the_response_receiver.receive(next, body_data2.end());
+  BOOST_CHECK(rx_state == Rx::CHUNK);
+  BOOST_CHECK_EQUAL(22U, the_response_receiver.chunk().data().size());
+  BOOST_CHECK_EQUAL("HTTP chunk number: 21\n",
+                    the_response_receiver.chunk().data_view());
+
+  rx_state = the_response_receiver.receive(next, body_data2.end());
+  BOOST_CHECK(next == body_data2.end());
+  BOOST_CHECK(rx_state == Rx::CHUNK);
+  BOOST_CHECK(the_response_receiver.chunk().is_last());
+  BOOST_CHECK(the_response_receiver.chunk().data_view().empty());
+}
+
 BOOST_AUTO_TEST_CASE(InvalidOK2)
 {
   std::string response_data("HTTP/1.0 200 OK\r\n");
@@ -0,0 +1,278 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/request_router.hpp"
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace via::http;
+
+typedef rx_request<1024, 8, 100, 8190, 1024, 8, true> http_request;
+typedef request_router<std::string, http_request> string_router;
+
+namespace
+{
+  const std::string CONTENTS("0123456789abcdefghijklmnopqrstuvwxyz");
+
+  /// A temporary directory containing a file, deleted by the destructor.
+  struct test_directory
+  {
+    std::filesystem::path path;
+
+    test_directory()
+      : path(std::filesystem::temp_directory_path() /
+             ("via-httplib-static-" + std::to_string
+               (std::chrono::steady_clock::now().time_since_epoch().count())))
+    {
+      std::filesystem::create_directories(path / "sub");
+      write("file.txt", CONTENTS);
+      write("sub/index.html", "<html></html>");
+    }
+
+    ~test_directory()
+    {
+      std::error_code error;
+      std::filesystem::remove_all(path, error);
+    }
+
+    void write(std::string const& name, std::string const& text) const
+    {
+      std::ofstream file(path / name, std::ios::binary | std::ios::trunc);
+      file << text;
+    }
+
+    /// Replace a file by renaming a new file over it.
+    void replace(std::string const& name, std::string const& text) const
+    {
+      write(name + ".new", text);
+      std::filesystem::rename(path / (name + ".new"), path / name);
+    }
+  };
+
+  http_request parse_request(std::string const& text)
+  {
+    http_request request;
+    auto next(text.cbegin());
+    BOOST_REQUIRE(request.parse(next, text.cend()));
+    return request;
+  }
+
+  std::string body_text(file_body const& body)
+  {
+    std::string text;
+    for (auto const& segment : body.segments)
+      text.append(segment);
+    return text;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestStaticFiles)
+
+BOOST_AUTO_TEST_CASE(ContentType1)
+{
+  BOOST_CHECK_EQUAL("text/html; charset=utf-8", content_type("/a/index.html"));
+  BOOST_CHECK_EQUAL("image/png", content_type("logo.PNG"));
+  BOOST_CHECK_EQUAL("application/octet-stream", content_type("a.b/file"));
+  BOOST_CHECK_EQUAL("application/octet-stream", content_type("file.unknown"));
+}
+
+BOOST_AUTO_TEST_CASE(ParseRanges1)
+{
+  std::vector<byte_range> ranges;
+  BOOST_CHECK(ranges_status::NONE == parse_ranges("", 100, ranges));
+  BOOST_CHECK(ranges_status::NONE == parse_ranges("items=0-1", 100, ranges));
+  BOOST_CHECK(ranges_status::NONE == parse_ranges("bytes=5-1", 100, ranges));
+  BOOST_CHECK(ranges_status::NONE == parse_ranges("bytes=a-1", 100, ranges));
+
+  BOOST_CHECK(ranges_status::SATISFIABLE ==
+              parse_ranges("bytes=0-9, 90-, -5, 95-200", 100, ranges));
+  BOOST_REQUIRE_EQUAL(4U, ranges.size());
+  BOOST_CHECK_EQUAL(0U, ranges[0].offset);
+  BOOST_CHECK_EQUAL(10U, ranges[0].length);
+  BOOST_CHECK_EQUAL(90U, ranges[1].offset);
+  BOOST_CHECK_EQUAL(10U, ranges[1].length);
+  BOOST_CHECK_EQUAL(95U, ranges[2].offset);
+  BOOST_CHECK_EQUAL(5U, ranges[2].length);
+  BOOST_CHECK_EQUAL(95U, ranges[3].offset);
+  BOOST_CHECK_EQUAL(5U, ranges[3].length);
+
+  // a suffix range larger than the file is the whole file
+  BOOST_CHECK(ranges_status::SATISFIABLE ==
+              parse_ranges("bytes=-500", 100, ranges));
+  BOOST_CHECK_EQUAL(0U, ranges[0].offset);
+  BOOST_CHECK_EQUAL(100U, ranges[0].length);
+
+  BOOST_CHECK(ranges_status::UNSATISFIABLE ==
+              parse_ranges("bytes=100-", 100, ranges));
+  BOOST_CHECK(ranges_status::UNSATISFIABLE ==
+              parse_ranges("bytes=-0", 100, ranges));
+
+  // too many ranges are ignored
+  std::string many("bytes=0-0");
+  for (size_t i(0); i < MAX_RANGES; ++i)
+    many += ",0-0";
+  BOOST_CHECK(ranges_status::NONE == parse_ranges(many, 100, ranges));
+}
+
+BOOST_AUTO_TEST_CASE(FindFile1)
+{
+  test_directory directory;
+  static_files files(directory.path.string());
+  BOOST_CHECK(files.is_valid());
+
+  auto file(files.find("file.txt"));
+  BOOST_REQUIRE(file);
+  BOOST_CHECK_EQUAL(CONTENTS, file->data());
+  BOOST_CHECK_EQUAL("text/plain; charset=utf-8", file->content_type());
+  BOOST_CHECK_EQUAL(header_field::DATE_LENGTH, file->last_modified().size());
+  BOOST_CHECK_EQUAL('"', file->etag().front());
+
+  // it's cached
+  BOOST_CHECK_EQUAL(file.get(), files.find("file.txt").get());
+
+  // the index file of a directory
+  auto index(files.find("sub/"));
+  BOOST_REQUIRE(index);
+  BOOST_CHECK_EQUAL("<html></html>", index->data());
+
+  // invalid paths
+  BOOST_CHECK(!files.find("missing.txt"));
+  BOOST_CHECK(!files.find("sub"));
+  BOOST_CHECK(!files.find("../file.txt"));
+  BOOST_CHECK(!files.find("sub/../../file.txt"));
+  BOOST_CHECK(!files.find("/etc/passwd"));
+
+  // a replaced file is read again, the old one is still valid
+  directory.replace("file.txt", "changed");
+  auto changed(files.find("file.txt"));
+  BOOST_REQUIRE(changed);
+  BOOST_CHECK_EQUAL("changed", changed->data());
+  BOOST_CHECK_EQUAL(CONTENTS, file->data());
+}
+
+BOOST_AUTO_TEST_CASE(RespondFile1)
+{
+  test_directory directory;
+  static_files files(directory.path.string());
+
+  file_body body;
+  auto request(parse_request("GET /file.txt HTTP/1.1\r\nHost: h\r\n\r\n"));
+  tx_response response(files.respond(request, "file.txt", body));
+  BOOST_CHECK_EQUAL(200, response.status());
+  BOOST_CHECK_EQUAL(CONTENTS, body_text(body));
+  auto header(response.message(body.size()));
+  BOOST_CHECK(header.find("Accept-Ranges: bytes\r\n") != std::string::npos);
+  BOOST_CHECK(header.find("Content-Type: text/plain") != std::string::npos);
+
+  // Conditional requests
+  auto file(files.find("file.txt"));
+  file_body body1;
+  auto request1(parse_request("GET /file.txt HTTP/1.1\r\nIf-None-Match: " +
+                              file->etag() + "\r\n\r\n"));
+  tx_response response1(files.respond(request1, "file.txt", body1));
+  BOOST_CHECK_EQUAL(304, response1.status());
+  BOOST_CHECK(body1.segments.empty());
+
+  file_body body2;
+  auto request2(parse_request("GET /file.txt HTTP/1.1\r\nIf-Modified-Since: " +
+                              file->last_modified() + "\r\n\r\n"));
+  BOOST_CHECK_EQUAL(304, files.respond(request2, "file.txt", body2).status());
+
+  file_body body3;
+  auto request3(parse_request("GET /file.txt HTTP/1.1\r\n"
+                "If-Modified-Since: Thu, 01 Jan 1970 00:00:00 GMT\r\n\r\n"));
+  BOOST_CHECK_EQUAL(200, files.respond(request3, "file.txt", body3).status());
+
+  file_body body4;
+  auto request4(parse_request("GET /missing HTTP/1.1\r\n\r\n"));
+  BOOST_CHECK_EQUAL(404, files.respond(request4, "missing", body4).status());
+}
+
+BOOST_AUTO_TEST_CASE(RespondRanges1)
+{
+  test_directory directory;
+  static_files files(directory.path.string());
+
+  // A single range
+  file_body body;
+  auto request(parse_request("GET /file.txt HTTP/1.1\r\nRange: bytes=10-15\r\n\r\n"));
+  tx_response response(files.respond(request, "file.txt", body));
+  BOOST_CHECK_EQUAL(206, response.status());
+  BOOST_CHECK_EQUAL("abcdef", body_text(body));
+  BOOST_CHECK(response.message(body.size()).find
+              ("Content-Range: bytes 10-15/36\r\n") != std::string::npos);
+
+  // Multiple ranges
+  file_body body1;
+  auto request1(parse_request("GET /file.txt HTTP/1.1\r\nRange: bytes=0-1,-2\r\n\r\n"));
+  tx_response response1(files.respond(request1, "file.txt", body1));
+  BOOST_CHECK_EQUAL(206, response1.status());
+  auto text(body_text(body1));
+  BOOST_CHECK(response1.message(body1.size()).find
+              ("Content-Type: multipart/byteranges; boundary=") != std::string::npos);
+  BOOST_CHECK(text.find("Content-Range: bytes 0-1/36\r\n\r\n01\r\n--") != std::string::npos);
+  BOOST_CHECK(text.find("Content-Range: bytes 34-35/36\r\n\r\nyz\r\n--") != std::string::npos);
+  BOOST_CHECK_EQUAL("--\r\n", text.substr(text.size() - 4));
+
+  // An unsatisfiable range
+  file_body body2;
+  auto request2(parse_request("GET /file.txt HTTP/1.1\r\nRange: bytes=100-\r\n\r\n"));
+  tx_response response2(files.respond(request2, "file.txt", body2));
+  BOOST_CHECK_EQUAL(416, response2.status());
+  BOOST_CHECK(body2.segments.empty());
+  BOOST_CHECK(response2.message().find("Content-Range: bytes */36\r\n")
+              != std::string::npos);
+
+  // If-Range doesn't match, so the whole file is sent
+  file_body body3;
+  auto request3(parse_request("GET /file.txt HTTP/1.1\r\nRange: bytes=10-15\r\n"
+                              "If-Range: \"old\"\r\n\r\n"));
+  BOOST_CHECK_EQUAL(200, files.respond(request3, "file.txt", body3).status());
+  BOOST_CHECK_EQUAL(CONTENTS, body_text(body3));
+}
+
+BOOST_AUTO_TEST_CASE(RouteStaticFiles1)
+{
+  test_directory directory;
+  string_router router;
+  BOOST_CHECK(!router.add_static_files("/static", "/no/such/directory"));
+  BOOST_REQUIRE(router.add_static_files("/static", directory.path.string()));
+
+  // Without a lookup the file is copied into the response body
+  std::string data;
+  std::string response_body;
+  auto request(parse_request("GET /static/file%2Etxt HTTP/1.1\r\n\r\n"));
+  tx_response response(router.handle_request(request, data, response_body));
+  BOOST_CHECK_EQUAL(200, response.status());
+  BOOST_CHECK_EQUAL(CONTENTS, response_body);
+
+  // With a lookup the file body is returned
+  std::string response_body1;
+  string_router::RouteContext lookup;
+  tx_response response1(router.handle_request(request, data, response_body1,
+                          std::pmr::get_default_resource(), &lookup));
+  BOOST_CHECK_EQUAL(200, response1.status());
+  BOOST_CHECK(response_body1.empty());
+  BOOST_REQUIRE(lookup.file);
+  BOOST_CHECK_EQUAL(CONTENTS, body_text(*lookup.file));
+
+  auto request2(parse_request("PUT /static/file.txt HTTP/1.1\r\n\r\n"));
+  BOOST_CHECK_EQUAL(405, router.handle_request(request2, data,
+                                               response_body).status());
+
+  auto request3(parse_request("GET /other/file.txt HTTP/1.1\r\n\r\n"));
+  BOOST_CHECK_EQUAL(404, router.handle_request(request3, data,
+                                               response_body).status());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
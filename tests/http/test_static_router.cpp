@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/http/static_router.hpp"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace via::http;
+
+typedef rx_request<1024, 8, 100, 8190, 1024, 8, true> http_request;
+
+namespace
+{
+  tx_response get_status(http_request const&, Parameters const& parameters,
+                         std::string const&, std::string& response_body)
+  {
+    response_body = "status" + std::to_string(parameters.size());
+    return tx_response(response_status::code::OK);
+  }
+
+  tx_response post_echo(http_request const&, Parameters const&,
+                        std::string const& data, std::string& response_body)
+  {
+    response_body = data;
+    return tx_response(response_status::code::OK);
+  }
+
+  constexpr auto router(make_static_router<std::string, http_request>
+    ({ { "GET",  "/status",   &get_status },
+       { "PUT",  "/status",   &get_status },
+       { "POST", "/rpc/echo", &post_echo },
+       { "POST", "/rpc/add",  &post_echo },
+       { "POST", "/rpc/sub",  &post_echo },
+       { "POST", "/rpc/mul",  &post_echo },
+       { "POST", "/rpc/div",  &post_echo } }));
+  static_assert(router.is_valid());
+  static_assert(router.find("POST", "/rpc/mul"));
+  static_assert(!router.find("GET", "/rpc/mul"));
+
+  tx_response handle(std::string const& text, std::string& response_body)
+  {
+    http_request request;
+    auto next(text.cbegin());
+    BOOST_REQUIRE(request.parse(next, text.cend()));
+    return router.handle_request(request, "body", response_body);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestStaticRouter)
+
+BOOST_AUTO_TEST_CASE(StaticRouterFind1)
+{
+  BOOST_CHECK_EQUAL(7U, router.size());
+  BOOST_CHECK(router.find("GET", "/status")->handler == &get_status);
+  BOOST_CHECK(router.find("POST", "/rpc/div")->handler == &post_echo);
+  BOOST_CHECK(!router.find("GET", "/status/"));
+  BOOST_CHECK(!router.find("GET", ""));
+  BOOST_CHECK_EQUAL("GET, PUT", router.allowed_methods("/status"));
+
+  // Invalid tables
+  constexpr auto repeated(make_static_router<std::string, http_request>
+    ({ { "GET", "/a", &get_status }, { "GET", "/a", &post_echo } }));
+  static_assert(!repeated.is_valid());
+  constexpr auto no_handler(make_static_router<std::string, http_request>
+    ({ { "GET", "/a", nullptr } }));
+  static_assert(!no_handler.is_valid());
+
+  // A bigger table
+  static constexpr const char* PATHS[]
+    { "/a", "/b", "/c", "/d", "/e", "/f", "/g", "/h", "/i", "/j", "/k", "/l",
+      "/m", "/n", "/o", "/p", "/q", "/r", "/s", "/t", "/u", "/v", "/w", "/x" };
+  constexpr auto bigger(make_static_router<std::string, http_request>
+    ({ { "GET", PATHS[0], &get_status },  { "GET", PATHS[1], &get_status },
+       { "GET", PATHS[2], &get_status },  { "GET", PATHS[3], &get_status },
+       { "GET", PATHS[4], &get_status },  { "GET", PATHS[5], &get_status },
+       { "GET", PATHS[6], &get_status },  { "GET", PATHS[7], &get_status },
+       { "GET", PATHS[8], &get_status },  { "GET", PATHS[9], &get_status },
+       { "GET", PATHS[10], &get_status }, { "GET", PATHS[11], &get_status },
+       { "GET", PATHS[12], &get_status }, { "GET", PATHS[13], &get_status },
+       { "GET", PATHS[14], &get_status }, { "GET", PATHS[15], &get_status },
+       { "GET", PATHS[16], &get_status }, { "GET", PATHS[17], &get_status },
+       { "GET", PATHS[18], &get_status }, { "GET", PATHS[19], &get_status },
+       { "GET", PATHS[20], &get_status }, { "GET", PATHS[21], &get_status },
+       { "GET", PATHS[22], &get_status }, { "GET", PATHS[23], &get_status } }));
+  static_assert(bigger.is_valid());
+  for (auto path : PATHS)
+  {
+    auto route(bigger.find("GET", path));
+    BOOST_REQUIRE(route);
+    BOOST_CHECK_EQUAL(path, route->path);
+  }
+  BOOST_CHECK(!bigger.find("GET", "/y"));
+}
+
+BOOST_AUTO_TEST_CASE(StaticRouterHandle1)
+{
+  std::string response_body;
+  BOOST_CHECK_EQUAL(200, handle("GET /status?x=1 HTTP/1.1\r\n\r\n",
+                                response_body).status());
+  BOOST_CHECK_EQUAL("status0", response_body);
+
+  BOOST_CHECK_EQUAL(200, handle("POST /rpc/echo HTTP/1.1\r\n\r\n",
+                                response_body).status());
+  BOOST_CHECK_EQUAL("body", response_body);
+
+  tx_response response(handle("GET /rpc/echo HTTP/1.1\r\n\r\n", response_body));
+  BOOST_CHECK_EQUAL(405, response.status());
+  BOOST_CHECK(response.message().find("Allow: POST\r\n") != std::string::npos);
+
+  BOOST_CHECK_EQUAL(404, handle("GET /rpc HTTP/1.1\r\n\r\n",
+                                response_body).status());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Via Technology Ltd. All Rights Reserved.
+// (ken dot barker at via-technology dot co dot uk)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//////////////////////////////////////////////////////////////////////////////
+#include "via/thread/worker_pool.hpp"
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using namespace via::thread;
+
+//////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(TestWorkerPool)
+
+BOOST_AUTO_TEST_CASE(BoundedQueue1)
+{
+  bounded_queue<std::string> queue(2u);
+  BOOST_CHECK_EQUAL(2U, queue.capacity());
+  BOOST_CHECK_EQUAL(0U, queue.size());
+
+  std::string a("a");
+  std::string b("b");
+  std::string c("c");
+  BOOST_CHECK(queue.try_push(std::move(a)));
+  BOOST_CHECK(queue.try_push(std::move(b)));
+  BOOST_CHECK_EQUAL(2U, queue.size());
+
+  // The queue is full, the item isn't moved from
+  BOOST_CHECK(!queue.try_push(std::move(c)));
+  BOOST_CHECK_EQUAL("c", c);
+
+  std::string item;
+  BOOST_CHECK(queue.pop(item));
+  BOOST_CHECK_EQUAL("a", item);
+  BOOST_CHECK(queue.try_push(std::move(c)));
+  BOOST_CHECK(queue.pop(item));
+  BOOST_CHECK_EQUAL("b", item);
+
+  // A closed queue is emptied and then pop fails
+  queue.close();
+  BOOST_CHECK(!queue.try_push("d"));
+  BOOST_CHECK(queue.pop(item));
+  BOOST_CHECK_EQUAL("c", item);
+  BOOST_CHECK(!queue.pop(item));
+}
+
+BOOST_AUTO_TEST_CASE(WorkerPool1)
+{
+  std::atomic<int> count(0);
+  worker_pool pool(4u, 1000u);
+  BOOST_CHECK_EQUAL(4U, pool.size());
+
+  for (int i(0); i < 1000; ++i)
+    BOOST_CHECK(pool.try_post([&count]{ ++count; }));
+
+  // stop runs the queued tasks
+  pool.stop();
+  BOOST_CHECK_EQUAL(1000, count.load());
+  BOOST_CHECK(!pool.try_post([&count]{ ++count; }));
+
+  auto stats(pool.stats());
+  BOOST_CHECK_EQUAL(0U, stats.queue_depth);
+  BOOST_CHECK_EQUAL(1000U, stats.capacity);
+  BOOST_CHECK_EQUAL(1000U, stats.posted);
+  BOOST_CHECK_EQUAL(1U, stats.rejected);
+  BOOST_CHECK_EQUAL(1000U, stats.completed);
+}
+
+BOOST_AUTO_TEST_CASE(WorkerPool2)
+{
+  // A task that throws doesn't stop the thread
+  std::atomic<int> count(0);
+  worker_pool pool(1u, 10u);
+  BOOST_CHECK(pool.try_post([]{ throw std::runtime_error("task failed"); }));
+  BOOST_CHECK(pool.try_post([&count]{ ++count; }));
+  pool.stop();
+  BOOST_CHECK_EQUAL(1, count.load());
+
+  auto stats(pool.stats());
+  BOOST_CHECK_EQUAL(2U, stats.completed);
+  BOOST_CHECK_EQUAL(1U, stats.failed);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+//////////////////////////////////////////////////////////////////////////////